@@ -1,4 +1,4 @@
-#include "ApplicationManager.h"
+#include "applicationmanager.h"
 #include <QApplication>
 #include <QDebug>
 
@@ -2,9 +2,9 @@
 #define APPLICATIONMANAGER_H
 
 #include <QObject>
-#include "MainWindow.h"
-#include "TrayIcon.h"
-#include "StickerManager.h"
+#include "mainwindow.h"
+#include "trayicon.h"
+#include "stickermanager.h"
 
 class ApplicationManager : public QObject
 {
@@ -0,0 +1,18 @@
+# 独立渲染基准：只编译贴纸引擎，不链接 Live2D 与消息模块
+TARGET = StickerRenderBenchmark
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += STICKER_NO_LIVE2D STICKER_NO_MESSAGE_SDK
+
+include($$PWD/../stickercore.pri)
+
+# 显示方式阶段读取进程常驻内存
+win32: LIBS += psapi.lib
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$PWD/../stickerrenderbenchmark.cpp
+
+HEADERS += \
+    $$PWD/../stickerrenderbenchmark.h
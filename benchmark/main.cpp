@@ -0,0 +1,14 @@
+#include <QApplication>
+#include "stickerrenderbenchmark.h"
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    // 单独的应用名，海报与内存统计不落到贴纸管理器的数据目录
+    app.setApplicationName("Sticker Render Benchmark");
+    app.setOrganizationName("StickerStudio");
+
+    // 配合 QT_QPA_PLATFORM=offscreen 在无桌面环境运行，输出后直接退出
+    return StickerRenderBenchmark::run(StickerRenderBenchmark::parseArguments(app.arguments()));
+}
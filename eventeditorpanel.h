@@ -2,7 +2,7 @@
 #define EVENTEDITORPANEL_H
 
 #include <QWidget>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class QComboBox;
 class QPushButton;
@@ -1,6 +1,8 @@
-#include "EventHandler.h"
+#include "eventhandler.h"
+#ifndef STICKER_NO_MESSAGE_SDK
 #include "messagebubblewidget.h"
 #include "messagefollowcontroller.h"
+#endif
 #include <QDesktopServices>
 #include <QUrl>
 #include <QFileInfo>
@@ -147,6 +149,12 @@ void EventHandler::playSound(const QString &soundPath)
 
 void EventHandler::showMessage(const QString &message, const QString &title)
 {
+#ifdef STICKER_NO_MESSAGE_SDK
+    // 独立渲染基准不链接消息模块
+    Q_UNUSED(message)
+    Q_UNUSED(title)
+    throw std::runtime_error("未包含消息模块");
+#else
     QString text = message;
     const QString extra = title.trimmed();
     if (!extra.isEmpty()) {
@@ -187,6 +195,7 @@ void EventHandler::showMessage(const QString &message, const QString &title)
     finalConfig.insert("y", pos.y());
     bubble->showMessage(MessageKind::Toast, text, finalConfig);
     MessageFollowController::instance()->trackMessage(bubble, m_anchorWidget.data(), pos, m_pollIntervalMs);
+#endif
 }
 
 void EventHandler::runCustomScript(const QString &script, const QString &parameters)
@@ -7,7 +7,7 @@
 #include <QRect>
 #include <QPoint>
 #include <QPointer>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class QWidget;
 
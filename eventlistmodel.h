@@ -3,7 +3,7 @@
 
 #include <QAbstractTableModel>
 #include <QList>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class EventListModel : public QAbstractTableModel
 {
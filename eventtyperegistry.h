@@ -3,7 +3,7 @@
 
 #include <QList>
 #include <QString>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 enum class EventFieldValueType {
     Text = 0,
@@ -4,7 +4,7 @@
 #include <QPointF>
 #include <QRectF>
 #include <QSize>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 struct FollowLayoutSpec {
     FollowAnchor anchor = FollowAnchor::LeftTop;
@@ -0,0 +1,222 @@
+#include "followwindowclassifier.h"
+#include <QDebug>
+
+namespace {
+// 反向引用、递归、内联选项、\Q 等依赖分组编号或会越出自身括号的写法不并入合并正则
+bool isCombinable(const QString &pattern)
+{
+    static const QRegularExpression unsafe(
+        QStringLiteral("\\\\[1-9gkQ]|\\(\\?[\\^a-zA-Z+\\-&|(\\d]|#"));
+    return !unsafe.match(pattern).hasMatch();
+}
+}
+
+FollowWindowClassifier::FollowWindowClassifier()
+{
+}
+
+void FollowWindowClassifier::setFilter(const QString &templateId, FollowFilterType type, const QString &value)
+{
+    auto it = m_filters.constFind(templateId);
+    if (it != m_filters.constEnd() && it.value().type == type && it.value().source == value) {
+        return;
+    }
+    m_filters.insert(templateId, compile(type, value));
+    rebuild();
+}
+
+void FollowWindowClassifier::removeFilter(const QString &templateId)
+{
+    if (m_filters.remove(templateId) > 0) {
+        rebuild();
+    }
+}
+
+void FollowWindowClassifier::clear()
+{
+    m_filters.clear();
+    rebuild();
+}
+
+bool FollowWindowClassifier::isEmpty() const
+{
+    return m_filters.isEmpty();
+}
+
+QHash<QString, QList<WindowInfo>> FollowWindowClassifier::classify(const QList<WindowInfo> &windows)
+{
+    QHash<QString, QList<WindowInfo>> result;
+    if (m_filters.isEmpty()) {
+        return result;
+    }
+
+    // 记忆只保留本次快照里出现过的取值与窗口
+    QHash<QString, QStringList> classMemo;
+    QHash<QString, QStringList> processMemo;
+    QHash<WindowHandle, QPair<QString, QStringList>> titleMemo;
+    for (const WindowInfo &info : windows) {
+        QStringList matched;
+        if (!m_classTemplates.isEmpty()) {
+            matched += matchKeyed(FollowFilterType::WindowClass, info.className, m_classMemo, classMemo);
+        }
+        if (!m_processTemplates.isEmpty()) {
+            matched += matchKeyed(FollowFilterType::ProcessName, info.processName, m_processMemo, processMemo);
+        }
+        if (!m_titleTemplates.isEmpty()) {
+            matched += matchTitle(info, titleMemo);
+        }
+        for (const QString &templateId : matched) {
+            result[templateId].append(info);
+        }
+    }
+    m_classMemo = classMemo;
+    m_processMemo = processMemo;
+    m_titleMemo = titleMemo;
+    return result;
+}
+
+WindowRecognitionService::WindowFields FollowWindowClassifier::requiredFields() const
+{
+    WindowRecognitionService::WindowFields fields;
+    if (!m_classTemplates.isEmpty()) {
+        fields |= WindowRecognitionService::ClassField;
+    }
+    if (!m_processTemplates.isEmpty()) {
+        fields |= WindowRecognitionService::ProcessField;
+    }
+    if (!m_titleTemplates.isEmpty()) {
+        fields |= WindowRecognitionService::TitleField;
+    }
+    return fields;
+}
+
+FollowWindowClassifier::Filter FollowWindowClassifier::compile(FollowFilterType type, const QString &value)
+{
+    Filter filter;
+    filter.type = type;
+    filter.source = value;
+    if (value.trimmed().isEmpty()) {
+        return filter;
+    }
+
+    switch (type) {
+    case FollowFilterType::WindowClass:
+    case FollowFilterType::ProcessName:
+        filter.matcher = QStringMatcher(value, Qt::CaseInsensitive);
+        filter.valid = true;
+        break;
+    case FollowFilterType::WindowTitleRegex:
+        filter.regex = QRegularExpression(value, QRegularExpression::CaseInsensitiveOption);
+        filter.valid = filter.regex.isValid();
+        if (filter.valid) {
+            filter.regex.optimize();
+            filter.combinable = isCombinable(value);
+        } else {
+            qDebug() << "跟随过滤正则无效:" << value << filter.regex.errorString();
+        }
+        break;
+    default:
+        break;
+    }
+    return filter;
+}
+
+// 过滤条件变化后按类型分组，并重建合并正则；所有记忆作废
+void FollowWindowClassifier::rebuild()
+{
+    m_classTemplates.clear();
+    m_processTemplates.clear();
+    m_titleTemplates.clear();
+    m_uncombinedTitles.clear();
+    m_classMemo.clear();
+    m_processMemo.clear();
+    m_titleMemo.clear();
+    m_titleSet = QRegularExpression();
+
+    QStringList alternatives;
+    for (auto it = m_filters.constBegin(); it != m_filters.constEnd(); ++it) {
+        const Filter &filter = it.value();
+        if (!filter.valid) {
+            continue;
+        }
+        switch (filter.type) {
+        case FollowFilterType::WindowClass:
+            m_classTemplates.append(it.key());
+            break;
+        case FollowFilterType::ProcessName:
+            m_processTemplates.append(it.key());
+            break;
+        case FollowFilterType::WindowTitleRegex:
+            m_titleTemplates.append(it.key());
+            if (filter.combinable) {
+                alternatives.append(QStringLiteral("(?:%1)").arg(filter.source));
+            } else {
+                m_uncombinedTitles.append(it.key());
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // 只有一条时合并没有意义；合并后无效（如命名分组重名）则逐条判定
+    if (alternatives.size() > 1) {
+        m_titleSet = QRegularExpression(alternatives.join('|'), QRegularExpression::CaseInsensitiveOption);
+        if (m_titleSet.isValid()) {
+            m_titleSet.optimize();
+        } else {
+            m_titleSet = QRegularExpression();
+            m_uncombinedTitles = m_titleTemplates;
+        }
+    } else {
+        m_uncombinedTitles = m_titleTemplates;
+    }
+}
+
+QStringList FollowWindowClassifier::matchKeyed(FollowFilterType type, const QString &value,
+                                               const QHash<QString, QStringList> &memo,
+                                               QHash<QString, QStringList> &nextMemo) const
+{
+    auto it = nextMemo.constFind(value);
+    if (it != nextMemo.constEnd()) {
+        return it.value();
+    }
+    QStringList matched;
+    it = memo.constFind(value);
+    if (it != memo.constEnd()) {
+        matched = it.value();
+    } else {
+        const QStringList &templates = type == FollowFilterType::WindowClass ? m_classTemplates
+                                                                             : m_processTemplates;
+        for (const QString &templateId : templates) {
+            if (m_filters.constFind(templateId)->matcher.indexIn(value) >= 0) {
+                matched.append(templateId);
+            }
+        }
+    }
+    nextMemo.insert(value, matched);
+    return matched;
+}
+
+// 标题随时可能变化，按窗口记下标题与结果，标题不变时直接复用
+QStringList FollowWindowClassifier::matchTitle(const WindowInfo &info,
+                                               QHash<WindowHandle, QPair<QString, QStringList>> &nextMemo) const
+{
+    auto it = m_titleMemo.constFind(info.handle);
+    if (it != m_titleMemo.constEnd() && it.value().first == info.title) {
+        nextMemo.insert(info.handle, it.value());
+        return it.value().second;
+    }
+
+    QStringList matched;
+    // 合并正则整体不命中时，所有可合并的模板都不命中
+    const bool anyCombined = m_titleSet.pattern().isEmpty() || m_titleSet.match(info.title).hasMatch();
+    const QStringList &candidates = anyCombined ? m_titleTemplates : m_uncombinedTitles;
+    for (const QString &templateId : candidates) {
+        if (m_filters.constFind(templateId)->regex.match(info.title).hasMatch()) {
+            matched.append(templateId);
+        }
+    }
+    nextMemo.insert(info.handle, qMakePair(info.title, matched));
+    return matched;
+}
@@ -0,0 +1,60 @@
+#ifndef FOLLOWWINDOWCLASSIFIER_H
+#define FOLLOWWINDOWCLASSIFIER_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QStringMatcher>
+#include "stickerdata.h"
+#include "windowrecognitionservice.h"
+
+// 批量跟随的窗口分类：每份窗口快照只遍历一次，同时判定所有模板的过滤条件。
+// 类名/进程名按取值哈希，同名窗口只判定一次；标题正则先用合并后的正则整体筛掉不命中的窗口
+class FollowWindowClassifier
+{
+public:
+    FollowWindowClassifier();
+
+    // 过滤条件未变时保留已编译结果与记忆
+    void setFilter(const QString &templateId, FollowFilterType type, const QString &value);
+    void removeFilter(const QString &templateId);
+    void clear();
+    bool isEmpty() const;
+
+    // 模板 ID -> 命中的窗口，保持快照中的次序
+    QHash<QString, QList<WindowInfo>> classify(const QList<WindowInfo> &windows);
+
+    // 判定用到的窗口字段
+    WindowRecognitionService::WindowFields requiredFields() const;
+
+private:
+    struct Filter {
+        FollowFilterType type = FollowFilterType::WindowClass;
+        QString source;
+        bool valid = false;
+        bool combinable = false;   // 能否并入合并正则
+        QStringMatcher matcher;
+        QRegularExpression regex;
+    };
+
+    static Filter compile(FollowFilterType type, const QString &value);
+    void rebuild();
+    QStringList matchKeyed(FollowFilterType type, const QString &value,
+                           const QHash<QString, QStringList> &memo, QHash<QString, QStringList> &nextMemo) const;
+    QStringList matchTitle(const WindowInfo &info, QHash<WindowHandle, QPair<QString, QStringList>> &nextMemo) const;
+
+    QHash<QString, Filter> m_filters;
+    QStringList m_classTemplates;
+    QStringList m_processTemplates;
+    QStringList m_titleTemplates;
+    QStringList m_uncombinedTitles;
+    QRegularExpression m_titleSet;
+    QHash<QString, QStringList> m_classMemo;
+    QHash<QString, QStringList> m_processMemo;
+    QHash<WindowHandle, QPair<QString, QStringList>> m_titleMemo;
+};
+
+#endif // FOLLOWWINDOWCLASSIFIER_H
@@ -2,10 +2,12 @@
 #include <QDir>
 #include <QStandardPaths>
 #include <QDebug>
-#include "ApplicationManager.h"
+#include "applicationmanager.h"
 
 int main(int argc, char *argv[])
 {
+    // 所有 Live2D 渲染窗口共享 OpenGL 资源，模型缓存里的窗口换到其他贴纸下时纹理仍然有效
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
     QApplication app(argc, argv);
 
     // 设置应用程序信息
@@ -1,5 +1,6 @@
-#include "MainWindow.h"
+#include "mainwindow.h"
 #include "eventeditorpanel.h"
+#include "stickerlive2dmanifest.h"
 #include <QApplication>
 #include <QMenuBar>
 #include <QStatusBar>
@@ -36,6 +37,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(m_browseImageBtn, &QPushButton::clicked, this, &MainWindow::onBrowseImageClicked);
     connect(m_browseLive2DModelBtn, &QPushButton::clicked, this, &MainWindow::onBrowseLive2DModelClicked);
+    connect(m_browseVideoBtn, &QPushButton::clicked, this, &MainWindow::onBrowseVideoClicked);
     connect(m_browseLive2DRuntimeBtn, &QPushButton::clicked, this, &MainWindow::onBrowseLive2DRuntimeClicked);
 
     connect(m_applyChangesBtn, &QPushButton::clicked, this, &MainWindow::onApplyChangesClicked);
@@ -168,7 +170,7 @@ void MainWindow::setupBasicTab()
 
     basicLayout->addWidget(new QLabel("类型:"), 1, 0);
     m_contentTypeComboBox = new QComboBox;
-    m_contentTypeComboBox->addItems({"图片贴纸", "Live2D贴纸"});
+    m_contentTypeComboBox->addItems({"图片贴纸", "Live2D贴纸", "视频贴纸"});
     basicLayout->addWidget(m_contentTypeComboBox, 1, 1, 1, 2);
 
     basicLayout->addWidget(new QLabel("图片路径:"), 2, 0);
@@ -177,6 +179,10 @@ void MainWindow::setupBasicTab()
     basicLayout->addWidget(m_imagePathEdit, 2, 1);
     basicLayout->addWidget(m_browseImageBtn, 2, 2);
 
+    m_tiledImageCheckBox = new QCheckBox("高分辨率分块加载");
+    m_tiledImageCheckBox->setToolTip("适用于大尺寸海报/地图，按需解码可见分块，不应用描边/阴影效果");
+    basicLayout->addWidget(m_tiledImageCheckBox, 3, 1, 1, 2);
+
     layout->addWidget(basicGroup);
 
     // Live2D 配置组
@@ -203,6 +209,24 @@ void MainWindow::setupBasicTab()
     layout->addWidget(m_live2dGroup);
     m_live2dGroup->setVisible(false);
 
+    // 视频配置组
+    m_videoGroup = new QGroupBox("视频设置");
+    QGridLayout *videoLayout = new QGridLayout(m_videoGroup);
+
+    videoLayout->addWidget(new QLabel("视频文件:"), 0, 0);
+    m_videoPathEdit = new QLineEdit;
+    m_browseVideoBtn = new QPushButton("浏览...");
+    videoLayout->addWidget(m_videoPathEdit, 0, 1);
+    videoLayout->addWidget(m_browseVideoBtn, 0, 2);
+
+    m_videoLoopCheckBox = new QCheckBox("循环播放");
+    m_videoMutedCheckBox = new QCheckBox("静音");
+    videoLayout->addWidget(m_videoLoopCheckBox, 1, 1);
+    videoLayout->addWidget(m_videoMutedCheckBox, 1, 2);
+
+    layout->addWidget(m_videoGroup);
+    m_videoGroup->setVisible(false);
+
     // 位置和大小组
     QGroupBox *positionGroup = new QGroupBox("位置和大小");
     QGridLayout *positionLayout = new QGridLayout(positionGroup);
@@ -268,6 +292,26 @@ void MainWindow::setupBasicTab()
     m_shearYSpinBox->setValue(0.0);
     transformLayout->addWidget(m_shearYSpinBox, 2, 1);
 
+    transformLayout->addWidget(new QLabel("动作:"), 3, 0);
+    m_motionTypeComboBox = new QComboBox;
+    m_motionTypeComboBox->addItems({"无", "浮动", "摇摆", "旋转", "呼吸"});
+    transformLayout->addWidget(m_motionTypeComboBox, 3, 1);
+
+    transformLayout->addWidget(new QLabel("幅度:"), 3, 2);
+    m_motionAmplitudeSpinBox = new QDoubleSpinBox;
+    m_motionAmplitudeSpinBox->setRange(-100.0, 100.0);
+    m_motionAmplitudeSpinBox->setSingleStep(1.0);
+    m_motionAmplitudeSpinBox->setValue(10.0);
+    m_motionAmplitudeSpinBox->setToolTip("浮动为像素，摇摆为角度，呼吸为百分比，旋转取符号决定方向");
+    transformLayout->addWidget(m_motionAmplitudeSpinBox, 3, 3);
+
+    transformLayout->addWidget(new QLabel("周期(ms):"), 4, 0);
+    m_motionPeriodSpinBox = new QSpinBox;
+    m_motionPeriodSpinBox->setRange(200, 60000);
+    m_motionPeriodSpinBox->setSingleStep(100);
+    m_motionPeriodSpinBox->setValue(2000);
+    transformLayout->addWidget(m_motionPeriodSpinBox, 4, 1);
+
     layout->addWidget(transformGroup);
 
     // 显示属性组
@@ -298,8 +342,58 @@ void MainWindow::setupBasicTab()
     m_clickThroughCheckBox->setChecked(false);
     displayLayout->addWidget(m_clickThroughCheckBox, 1, 2);
 
+    displayLayout->addWidget(new QLabel("层叠次序:"), 2, 0);
+    m_zOrderSpinBox = new QSpinBox;
+    m_zOrderSpinBox->setRange(-999, 999);
+    m_zOrderSpinBox->setValue(0);
+    m_zOrderSpinBox->setToolTip("同为桌面模式或同为置顶的贴纸之间，数值大的显示在上方");
+    displayLayout->addWidget(m_zOrderSpinBox, 2, 1);
+
     layout->addWidget(displayGroup);
 
+    // 效果组
+    m_effectsGroup = new QGroupBox("效果");
+    QGridLayout *effectsLayout = new QGridLayout(m_effectsGroup);
+
+    m_outlineCheckBox = new QCheckBox("描边");
+    effectsLayout->addWidget(m_outlineCheckBox, 0, 0);
+    effectsLayout->addWidget(new QLabel("宽度:"), 0, 1);
+    m_outlineWidthSpinBox = new QSpinBox;
+    m_outlineWidthSpinBox->setRange(1, 32);
+    m_outlineWidthSpinBox->setValue(4);
+    effectsLayout->addWidget(m_outlineWidthSpinBox, 0, 2);
+
+    m_shadowCheckBox = new QCheckBox("阴影");
+    effectsLayout->addWidget(m_shadowCheckBox, 1, 0);
+    effectsLayout->addWidget(new QLabel("模糊:"), 1, 1);
+    m_shadowBlurSpinBox = new QSpinBox;
+    m_shadowBlurSpinBox->setRange(0, 64);
+    m_shadowBlurSpinBox->setValue(8);
+    effectsLayout->addWidget(m_shadowBlurSpinBox, 1, 2);
+
+    effectsLayout->addWidget(new QLabel("阴影偏移X:"), 2, 1);
+    m_shadowOffsetXSpinBox = new QSpinBox;
+    m_shadowOffsetXSpinBox->setRange(-64, 64);
+    m_shadowOffsetXSpinBox->setValue(4);
+    effectsLayout->addWidget(m_shadowOffsetXSpinBox, 2, 2);
+
+    effectsLayout->addWidget(new QLabel("阴影偏移Y:"), 2, 3);
+    m_shadowOffsetYSpinBox = new QSpinBox;
+    m_shadowOffsetYSpinBox->setRange(-64, 64);
+    m_shadowOffsetYSpinBox->setValue(4);
+    effectsLayout->addWidget(m_shadowOffsetYSpinBox, 2, 4);
+
+    m_tintCheckBox = new QCheckBox("着色");
+    effectsLayout->addWidget(m_tintCheckBox, 3, 0);
+    effectsLayout->addWidget(new QLabel("强度:"), 3, 1);
+    m_tintStrengthSpinBox = new QDoubleSpinBox;
+    m_tintStrengthSpinBox->setRange(0.0, 1.0);
+    m_tintStrengthSpinBox->setSingleStep(0.05);
+    m_tintStrengthSpinBox->setValue(0.3);
+    effectsLayout->addWidget(m_tintStrengthSpinBox, 3, 2);
+
+    layout->addWidget(m_effectsGroup);
+
     // 跟随模式组
     QGroupBox *followGroup = new QGroupBox("跟随模式");
     QVBoxLayout *followLayout = new QVBoxLayout(followGroup);
@@ -394,6 +488,10 @@ void MainWindow::connectEditorSignals()
     connect(m_contentTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onContentTypeChanged);
     connect(m_imagePathEdit, &QLineEdit::textEdited, this, &MainWindow::onEditorValueChanged);
+    connect(m_tiledImageCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_videoPathEdit, &QLineEdit::textEdited, this, &MainWindow::onEditorValueChanged);
+    connect(m_videoLoopCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_videoMutedCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
     connect(m_live2dModelPathEdit, &QLineEdit::textEdited, this, &MainWindow::onEditorValueChanged);
     connect(m_live2dRuntimeRootEdit, &QLineEdit::textEdited, this, &MainWindow::onEditorValueChanged);
     connect(m_live2dShaderProfileEdit, &QLineEdit::textEdited, this, &MainWindow::onEditorValueChanged);
@@ -406,11 +504,24 @@ void MainWindow::connectEditorSignals()
     connect(m_rotationSpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
     connect(m_shearXSpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
     connect(m_shearYSpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_motionTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onEditorValueChanged);
+    connect(m_motionAmplitudeSpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_motionPeriodSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
     connect(m_opacitySpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_zOrderSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
     connect(m_visibleCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
     connect(m_desktopModeCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
     connect(m_allowDragCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
     connect(m_clickThroughCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_outlineCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_outlineWidthSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_shadowCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_shadowBlurSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_shadowOffsetXSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_shadowOffsetYSpinBox, intChanged, this, &MainWindow::onEditorValueChanged);
+    connect(m_tintCheckBox, &QCheckBox::toggled, this, &MainWindow::onEditorValueChanged);
+    connect(m_tintStrengthSpinBox, doubleChanged, this, &MainWindow::onEditorValueChanged);
     connect(m_followModeCheckBox, &QCheckBox::toggled, this, &MainWindow::onFollowModeToggled);
     connect(m_followBatchCheckBox, &QCheckBox::toggled, this, &MainWindow::onFollowBatchModeToggled);
     connect(m_followFilterTypeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -625,6 +736,21 @@ void MainWindow::onBrowseLive2DModelClicked()
     }
 }
 
+void MainWindow::onBrowseVideoClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this,
+        "选择视频",
+        QStandardPaths::writableLocation(QStandardPaths::MoviesLocation),
+        "视频文件 (*.mp4 *.webm *.avi *.mov *.wmv *.mkv)"
+    );
+
+    if (!fileName.isEmpty()) {
+        m_videoPathEdit->setText(fileName);
+        onEditorValueChanged();
+    }
+}
+
 void MainWindow::onBrowseLive2DRuntimeClicked()
 {
     QString dirName = QFileDialog::getExistingDirectory(
@@ -786,7 +912,8 @@ void MainWindow::onLockWindowClicked()
         onEditorValueChanged();
     }
 
-    WindowInfo info = m_windowService.queryWindow(static_cast<WindowHandle>(handle));
+    WindowInfo info = m_windowService.queryWindow(static_cast<WindowHandle>(handle),
+                                                  WindowRecognitionService::ProcessField);
     if (!info.processName.isEmpty()) {
         m_currentConfig.follow.targetProcessName = info.processName;
         updateFollowModeUi();
@@ -836,7 +963,8 @@ void MainWindow::onBatchLockWindowClicked()
         }
     }
 
-    WindowInfo info = m_windowService.queryWindow(static_cast<WindowHandle>(handle));
+    WindowInfo info = m_windowService.queryWindow(static_cast<WindowHandle>(handle),
+                                                  WindowRecognitionService::ProcessField);
     if (!info.processName.isEmpty()) {
         m_currentConfig.follow.targetProcessName = info.processName;
         updateFollowModeUi();
@@ -997,6 +1125,10 @@ void MainWindow::updateStickerEditor(const StickerConfig &config)
     m_nameEdit->setText(config.name);
     m_contentTypeComboBox->setCurrentIndex(static_cast<int>(config.contentType));
     m_imagePathEdit->setText(config.imagePath);
+    m_tiledImageCheckBox->setChecked(config.tiledImage);
+    m_videoPathEdit->setText(config.video.path);
+    m_videoLoopCheckBox->setChecked(config.video.loop);
+    m_videoMutedCheckBox->setChecked(config.video.muted);
     m_live2dModelPathEdit->setText(config.live2d.modelJsonPath);
     m_live2dRuntimeRootEdit->setText(config.live2d.runtimeRoot);
     m_live2dShaderProfileEdit->setText(
@@ -1010,11 +1142,23 @@ void MainWindow::updateStickerEditor(const StickerConfig &config)
     m_rotationSpinBox->setValue(config.transform.rotation);
     m_shearXSpinBox->setValue(config.transform.shearX);
     m_shearYSpinBox->setValue(config.transform.shearY);
+    m_motionTypeComboBox->setCurrentIndex(static_cast<int>(config.transform.motion.type));
+    m_motionAmplitudeSpinBox->setValue(config.transform.motion.amplitude);
+    m_motionPeriodSpinBox->setValue(config.transform.motion.periodMs);
     m_opacitySpinBox->setValue(config.opacity);
+    m_zOrderSpinBox->setValue(config.zOrder);
     m_visibleCheckBox->setChecked(config.visible);
     m_desktopModeCheckBox->setChecked(config.isDesktopMode);
     m_allowDragCheckBox->setChecked(config.allowDrag);        // 新增
     m_clickThroughCheckBox->setChecked(config.clickThrough);  // 新增
+    m_outlineCheckBox->setChecked(config.effects.outlineEnabled);
+    m_outlineWidthSpinBox->setValue(config.effects.outlineWidth);
+    m_shadowCheckBox->setChecked(config.effects.shadowEnabled);
+    m_shadowBlurSpinBox->setValue(config.effects.shadowBlurRadius);
+    m_shadowOffsetXSpinBox->setValue(config.effects.shadowOffset.x());
+    m_shadowOffsetYSpinBox->setValue(config.effects.shadowOffset.y());
+    m_tintCheckBox->setChecked(config.effects.tintEnabled);
+    m_tintStrengthSpinBox->setValue(config.effects.tintStrength);
     m_followModeCheckBox->setChecked(config.follow.enabled && !config.follow.batchMode);
     m_followBatchCheckBox->setChecked(config.follow.enabled && config.follow.batchMode);
     m_followFilterTypeComboBox->setCurrentIndex(static_cast<int>(config.follow.filterType));
@@ -1041,6 +1185,10 @@ void MainWindow::clearStickerEditor()
     m_nameEdit->clear();
     m_contentTypeComboBox->setCurrentIndex(static_cast<int>(StickerContentType::Image));
     m_imagePathEdit->clear();
+    m_tiledImageCheckBox->setChecked(false);
+    m_videoPathEdit->clear();
+    m_videoLoopCheckBox->setChecked(true);
+    m_videoMutedCheckBox->setChecked(true);
     m_live2dModelPathEdit->clear();
     m_live2dRuntimeRootEdit->clear();
     m_live2dShaderProfileEdit->setText("Standard");
@@ -1053,11 +1201,24 @@ void MainWindow::clearStickerEditor()
     m_rotationSpinBox->setValue(0.0);
     m_shearXSpinBox->setValue(0.0);
     m_shearYSpinBox->setValue(0.0);
+    m_motionTypeComboBox->setCurrentIndex(static_cast<int>(StickerMotionType::None));
+    m_motionAmplitudeSpinBox->setValue(10.0);
+    m_motionPeriodSpinBox->setValue(2000);
     m_opacitySpinBox->setValue(1.0);
+    m_zOrderSpinBox->setValue(0);
     m_visibleCheckBox->setChecked(true);
     m_desktopModeCheckBox->setChecked(true);
     m_allowDragCheckBox->setChecked(true);      // 新增
     m_clickThroughCheckBox->setChecked(false);  // 新增
+    const StickerEffectConfig defaultEffects;
+    m_outlineCheckBox->setChecked(defaultEffects.outlineEnabled);
+    m_outlineWidthSpinBox->setValue(defaultEffects.outlineWidth);
+    m_shadowCheckBox->setChecked(defaultEffects.shadowEnabled);
+    m_shadowBlurSpinBox->setValue(defaultEffects.shadowBlurRadius);
+    m_shadowOffsetXSpinBox->setValue(defaultEffects.shadowOffset.x());
+    m_shadowOffsetYSpinBox->setValue(defaultEffects.shadowOffset.y());
+    m_tintCheckBox->setChecked(defaultEffects.tintEnabled);
+    m_tintStrengthSpinBox->setValue(defaultEffects.tintStrength);
     m_followModeCheckBox->setChecked(false);
     m_followBatchCheckBox->setChecked(false);
     m_followFilterTypeComboBox->setCurrentIndex(static_cast<int>(FollowFilterType::WindowClass));
@@ -1089,6 +1250,10 @@ StickerConfig MainWindow::getStickerConfigFromEditor() const
     config.name = m_nameEdit->text();
     config.contentType = static_cast<StickerContentType>(m_contentTypeComboBox->currentIndex());
     config.imagePath = m_imagePathEdit->text();
+    config.tiledImage = m_tiledImageCheckBox->isChecked();
+    config.video.path = m_videoPathEdit->text().trimmed();
+    config.video.loop = m_videoLoopCheckBox->isChecked();
+    config.video.muted = m_videoMutedCheckBox->isChecked();
     config.live2d.modelJsonPath = m_live2dModelPathEdit->text().trimmed();
     config.live2d.runtimeRoot = m_live2dRuntimeRootEdit->text().trimmed();
     config.live2d.shaderProfile = m_live2dShaderProfileEdit->text().trimmed();
@@ -1102,11 +1267,22 @@ StickerConfig MainWindow::getStickerConfigFromEditor() const
     config.transform.rotation = m_rotationSpinBox->value();
     config.transform.shearX = m_shearXSpinBox->value();
     config.transform.shearY = m_shearYSpinBox->value();
+    config.transform.motion.type = static_cast<StickerMotionType>(m_motionTypeComboBox->currentIndex());
+    config.transform.motion.amplitude = m_motionAmplitudeSpinBox->value();
+    config.transform.motion.periodMs = m_motionPeriodSpinBox->value();
     config.opacity = m_opacitySpinBox->value();
+    config.zOrder = m_zOrderSpinBox->value();
     config.visible = m_visibleCheckBox->isChecked();
     config.isDesktopMode = m_desktopModeCheckBox->isChecked();
     config.allowDrag = m_allowDragCheckBox->isChecked();        // 新增
     config.clickThrough = m_clickThroughCheckBox->isChecked();  // 新增
+    config.effects.outlineEnabled = m_outlineCheckBox->isChecked();
+    config.effects.outlineWidth = m_outlineWidthSpinBox->value();
+    config.effects.shadowEnabled = m_shadowCheckBox->isChecked();
+    config.effects.shadowBlurRadius = m_shadowBlurSpinBox->value();
+    config.effects.shadowOffset = QPoint(m_shadowOffsetXSpinBox->value(), m_shadowOffsetYSpinBox->value());
+    config.effects.tintEnabled = m_tintCheckBox->isChecked();
+    config.effects.tintStrength = m_tintStrengthSpinBox->value();
     bool singleEnabled = m_followModeCheckBox->isChecked();
     bool batchEnabled = m_followBatchCheckBox->isChecked();
     if (config.contentType == StickerContentType::Live2D && batchEnabled) {
@@ -1132,8 +1308,12 @@ StickerConfig MainWindow::getStickerConfigFromEditor() const
         if (!qFuzzyCompare(config.transform.scaleY, config.transform.scaleX)) {
             config.transform.scaleY = config.transform.scaleX;
         }
+        // 换了模型时按新模型的画布比例重新确定基础尺寸
+        if (config.live2d.modelJsonPath != m_currentConfig.live2d.modelJsonPath) {
+            config.live2d.baseSize = QSize();
+        }
         if (config.live2d.baseSize.isEmpty()) {
-            config.live2d.baseSize = config.size;
+            config.live2d.baseSize = StickerLive2DManifest::defaultBaseSize(config.live2d.modelJsonPath, config.size);
         }
     }
 
@@ -1228,16 +1408,30 @@ void MainWindow::updateFollowModeUi()
 void MainWindow::updateContentTypeUi(StickerContentType type)
 {
     bool isLive2D = (type == StickerContentType::Live2D);
+    bool isVideo = (type == StickerContentType::Video);
+    bool isImage = (type == StickerContentType::Image);
     if (m_imagePathEdit) {
-        m_imagePathEdit->setEnabled(!isLive2D);
+        m_imagePathEdit->setEnabled(isImage);
     }
     if (m_browseImageBtn) {
-        m_browseImageBtn->setEnabled(!isLive2D);
+        m_browseImageBtn->setEnabled(isImage);
+    }
+    if (m_tiledImageCheckBox) {
+        m_tiledImageCheckBox->setEnabled(isImage);
     }
     if (m_live2dGroup) {
         m_live2dGroup->setVisible(isLive2D);
         m_live2dGroup->setEnabled(isLive2D);
     }
+    if (m_videoGroup) {
+        m_videoGroup->setVisible(isVideo);
+        m_videoGroup->setEnabled(isVideo);
+    }
+    // 效果阶段只作用于静态图片：视频帧与 Live2D 渲染都不经过它
+    if (m_effectsGroup) {
+        m_effectsGroup->setEnabled(!isLive2D && !isVideo);
+        m_effectsGroup->setToolTip(isImage ? QString() : QString("视频与 Live2D 贴纸不应用效果"));
+    }
     if (isLive2D && m_live2dShaderProfileEdit
         && m_live2dShaderProfileEdit->text().trimmed().isEmpty()) {
         QSignalBlocker blocker(m_live2dShaderProfileEdit);
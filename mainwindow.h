@@ -20,7 +20,7 @@
 #include <QHeaderView>
 #include <QFileDialog>
 #include <QStandardPaths>
-#include "StickerData.h"
+#include "stickerdata.h"
 #include "windowrecognitionservice.h"
 
 class EventEditorPanel;
@@ -65,6 +65,7 @@ private slots:
     void onContentTypeChanged(int index);
     void onBrowseImageClicked();
     void onBrowseLive2DModelClicked();
+    void onBrowseVideoClicked();
     void onBrowseLive2DRuntimeClicked();
     void onEditorValueChanged();
     void onApplyChangesClicked();
@@ -132,24 +133,43 @@ private:
     QComboBox *m_contentTypeComboBox;
     QLineEdit *m_imagePathEdit;
     QPushButton *m_browseImageBtn;
+    QCheckBox *m_tiledImageCheckBox;
     QGroupBox *m_live2dGroup;
     QLineEdit *m_live2dModelPathEdit;
     QPushButton *m_browseLive2DModelBtn;
     QLineEdit *m_live2dRuntimeRootEdit;
     QPushButton *m_browseLive2DRuntimeBtn;
     QLineEdit *m_live2dShaderProfileEdit;
+    QGroupBox *m_videoGroup;
+    QLineEdit *m_videoPathEdit;
+    QPushButton *m_browseVideoBtn;
+    QCheckBox *m_videoLoopCheckBox;
+    QCheckBox *m_videoMutedCheckBox;
     QSpinBox *m_xSpinBox;
     QSpinBox *m_ySpinBox;
     QSpinBox *m_widthSpinBox;
     QSpinBox *m_heightSpinBox;
     QDoubleSpinBox *m_opacitySpinBox;
+    QSpinBox *m_zOrderSpinBox;
     QCheckBox *m_visibleCheckBox;
     QCheckBox *m_desktopModeCheckBox;
+    QGroupBox *m_effectsGroup;
+    QCheckBox *m_outlineCheckBox;
+    QSpinBox *m_outlineWidthSpinBox;
+    QCheckBox *m_shadowCheckBox;
+    QSpinBox *m_shadowBlurSpinBox;
+    QSpinBox *m_shadowOffsetXSpinBox;
+    QSpinBox *m_shadowOffsetYSpinBox;
+    QCheckBox *m_tintCheckBox;
+    QDoubleSpinBox *m_tintStrengthSpinBox;
     QDoubleSpinBox *m_scaleXSpinBox;
     QDoubleSpinBox *m_scaleYSpinBox;
     QDoubleSpinBox *m_rotationSpinBox;
     QDoubleSpinBox *m_shearXSpinBox;
     QDoubleSpinBox *m_shearYSpinBox;
+    QComboBox *m_motionTypeComboBox;
+    QDoubleSpinBox *m_motionAmplitudeSpinBox;
+    QSpinBox *m_motionPeriodSpinBox;
     QCheckBox *m_followModeCheckBox;
     QComboBox *m_followWindowComboBox;
     QPushButton *m_refreshWindowsBtn;
@@ -19,10 +19,42 @@ MessageFollowController::MessageFollowController(QObject *parent)
     : QObject(parent)
     , m_windowService(this)
     , m_timer(new QTimer(this))
+    , m_nativeEvents(WindowEventSource::createNative(this))
+    , m_events(nullptr)
     , m_refreshing(false)
 {
-    m_timer->setSingleShot(false);
     connect(m_timer, &QTimer::timeout, this, &MessageFollowController::refresh);
+    setEventSource(nullptr);
+}
+
+void MessageFollowController::setEventSource(WindowEventSource *source)
+{
+    if (m_events) {
+        disconnect(m_events, nullptr, this, nullptr);
+        m_events->setWatchedWindows(QSet<WindowHandle>(), false);
+    }
+    m_events = source ? source : m_nativeEvents;
+    // 已挂接失败的事件源不再使用
+    if (m_events && m_events->hasFailed()) {
+        m_events = nullptr;
+    }
+    if (m_events) {
+        connect(m_events, &WindowEventSource::windowChanged, this, &MessageFollowController::onWindowChanged);
+    }
+    // 事件驱动时定时器只用于合并一段时间内的事件
+    m_timer->stop();
+    m_timer->setSingleShot(m_events != nullptr);
+    syncTimer();
+}
+
+void MessageFollowController::onWindowChanged(WindowHandle handle, WindowEventSource::Event event)
+{
+    Q_UNUSED(handle)
+    Q_UNUSED(event)
+    const int interval = effectiveIntervalMs();
+    if (interval > 0 && !m_timer->isActive()) {
+        m_timer->start(interval);
+    }
 }
 
 void MessageFollowController::trackMessage(MessageBubbleWidget *bubble,
@@ -44,7 +76,7 @@ void MessageFollowController::trackMessage(MessageBubbleWidget *bubble,
     QSize bubbleSize = bubble->size();
 
     if (state.targetHandle != 0) {
-        WindowInfo info = m_windowService.queryWindow(state.targetHandle);
+        WindowInfo info = m_windowService.queryWindow(state.targetHandle, WindowRecognitionService::RectField);
         if (info.handle != 0 && !info.rect.isNull()) {
             state.anchor = chooseAnchorForPosition(info.rect, initialTopLeft, bubbleSize);
             state.offsetMode = FollowOffsetMode::AbsolutePixels;
@@ -88,6 +120,9 @@ void MessageFollowController::clear()
     if (m_timer->isActive()) {
         m_timer->stop();
     }
+    if (m_events) {
+        m_events->setWatchedWindows(QSet<WindowHandle>(), false);
+    }
 }
 
 void MessageFollowController::refresh()
@@ -110,7 +145,7 @@ void MessageFollowController::refresh()
             continue;
         }
 
-        WindowInfo info = m_windowService.queryWindow(state.targetHandle);
+        WindowInfo info = m_windowService.queryWindow(state.targetHandle, WindowRecognitionService::RectField);
         if (info.handle == 0) {
             stale.append(it.key());
             continue;
@@ -188,6 +223,23 @@ FollowAnchor MessageFollowController::chooseAnchorForPosition(const QRectF &wind
 void MessageFollowController::syncTimer()
 {
     int interval = effectiveIntervalMs();
+    if (m_events) {
+        QSet<WindowHandle> handles;
+        for (auto it = m_messages.constBegin(); it != m_messages.constEnd(); ++it) {
+            if (it.value().bubble && it.value().targetHandle != 0) {
+                handles.insert(it.value().targetHandle);
+            }
+        }
+        m_events->setWatchedWindows(handles, false);
+        if (!m_events->hasFailed()) {
+            return;
+        }
+        // 挂接失败：放弃事件源，按 pollIntervalMs 定时轮询
+        disconnect(m_events, nullptr, this, nullptr);
+        m_events = nullptr;
+        m_timer->stop();
+        m_timer->setSingleShot(false);
+    }
     if (interval <= 0) {
         if (m_timer->isActive()) {
             m_timer->stop();
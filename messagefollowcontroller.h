@@ -5,8 +5,9 @@
 #include <QHash>
 #include <QPointer>
 #include <QPoint>
-#include "StickerData.h"
+#include "stickerdata.h"
 #include "windowattachmentservice.h"
+#include "windoweventsource.h"
 #include "windowrecognitionservice.h"
 
 class MessageBubbleWidget;
@@ -28,8 +29,12 @@ public:
     void untrackMessage(MessageBubbleWidget *bubble);
     void clear();
 
+    // 不接管所有权，传 nullptr 恢复原生事件源；平台没有事件源或挂接失败时定时轮询
+    void setEventSource(WindowEventSource *source);
+
 private slots:
     void refresh();
+    void onWindowChanged(WindowHandle handle, WindowEventSource::Event event);
 
 private:
     struct MessageState {
@@ -53,6 +58,8 @@ private:
     WindowAttachmentService m_attachmentService;
     WindowRecognitionService m_windowService;
     QTimer *m_timer;
+    WindowEventSource *m_nativeEvents;
+    WindowEventSource *m_events;
     QHash<MessageBubbleWidget*, MessageState> m_messages;
     bool m_refreshing;
 };
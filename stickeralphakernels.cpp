@@ -0,0 +1,211 @@
+#include "stickeralphakernels.h"
+#include <QColor>
+#include <QtGlobal>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STICKER_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+// 水平膨胀：每行先拷入两侧补零的行缓冲，再取 [x-r, x+r] 窗口最大值
+void dilateHorizontal(uchar *bits, int width, int height, int stride, int radius)
+{
+    std::vector<uchar> line(size_t(width + radius * 2), 0);
+    const int window = radius * 2;
+    for (int y = 0; y < height; ++y) {
+        uchar *row = bits + size_t(y) * stride;
+        std::memcpy(line.data() + radius, row, size_t(width));
+        const uchar *src = line.data();
+        int x = 0;
+#ifdef STICKER_KERNELS_SSE2
+        for (; x + 16 <= width; x += 16) {
+            __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+            for (int k = 1; k <= window; ++k) {
+                m = _mm_max_epu8(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x + k)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), m);
+        }
+#endif
+        for (; x < width; ++x) {
+            uchar m = src[x];
+            for (int k = 1; k <= window; ++k) {
+                m = qMax(m, src[x + k]);
+            }
+            row[x] = m;
+        }
+    }
+}
+
+// 垂直膨胀：逐行输出，列方向一次处理 16 像素
+void dilateVertical(uchar *bits, int width, int height, int stride, int radius)
+{
+    const std::vector<uchar> copy(bits, bits + size_t(stride) * height);
+    const uchar *src = copy.data();
+    for (int y = 0; y < height; ++y) {
+        const int lo = qMax(0, y - radius);
+        const int hi = qMin(height - 1, y + radius);
+        uchar *out = bits + size_t(y) * stride;
+        int x = 0;
+#ifdef STICKER_KERNELS_SSE2
+        for (; x + 16 <= width; x += 16) {
+            __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + size_t(lo) * stride + x));
+            for (int yy = lo + 1; yy <= hi; ++yy) {
+                m = _mm_max_epu8(m, _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + size_t(yy) * stride + x)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), m);
+        }
+#endif
+        for (; x < width; ++x) {
+            uchar m = src[size_t(lo) * stride + x];
+            for (int yy = lo + 1; yy <= hi; ++yy) {
+                m = qMax(m, src[size_t(yy) * stride + x]);
+            }
+            out[x] = m;
+        }
+    }
+}
+
+// 垂直盒式模糊：滑动窗口求和，越界行按 0 处理；
+// 16 位累加器要求窗口不超过 257 行，除法用 mulhi 倒数近似
+void blurVertical(uchar *bits, int width, int height, int stride, int radius)
+{
+    const int window = radius * 2 + 1;
+    const int inverse = (65536 + window - 1) / window;
+    const std::vector<uchar> copy(bits, bits + size_t(stride) * height);
+    const uchar *src = copy.data();
+    int x = 0;
+#ifdef STICKER_KERNELS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i inv = _mm_set1_epi16(short(inverse));
+    for (; x + 8 <= width; x += 8) {
+        __m128i sum = zero;
+        for (int yy = 0; yy <= radius && yy < height; ++yy) {
+            const __m128i row = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + size_t(yy) * stride + x));
+            sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(row, zero));
+        }
+        for (int y = 0; y < height; ++y) {
+            const __m128i avg = _mm_mulhi_epu16(sum, inv);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(bits + size_t(y) * stride + x),
+                             _mm_packus_epi16(avg, zero));
+            const int addRow = y + radius + 1;
+            if (addRow < height) {
+                const __m128i row = _mm_loadl_epi64(
+                    reinterpret_cast<const __m128i*>(src + size_t(addRow) * stride + x));
+                sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(row, zero));
+            }
+            const int subRow = y - radius;
+            if (subRow >= 0) {
+                const __m128i row = _mm_loadl_epi64(
+                    reinterpret_cast<const __m128i*>(src + size_t(subRow) * stride + x));
+                sum = _mm_sub_epi16(sum, _mm_unpacklo_epi8(row, zero));
+            }
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        int sum = 0;
+        for (int yy = 0; yy <= radius && yy < height; ++yy) {
+            sum += src[size_t(yy) * stride + x];
+        }
+        for (int y = 0; y < height; ++y) {
+            bits[size_t(y) * stride + x] = uchar((sum * inverse) >> 16);
+            const int addRow = y + radius + 1;
+            if (addRow < height) {
+                sum += src[size_t(addRow) * stride + x];
+            }
+            const int subRow = y - radius;
+            if (subRow >= 0) {
+                sum -= src[size_t(subRow) * stride + x];
+            }
+        }
+    }
+}
+
+QImage transposed(const QImage &alpha)
+{
+    QImage result(alpha.height(), alpha.width(), QImage::Format_Alpha8);
+    const int width = alpha.width();
+    const int height = alpha.height();
+    for (int y = 0; y < height; ++y) {
+        const uchar *line = alpha.constScanLine(y);
+        for (int x = 0; x < width; ++x) {
+            result.scanLine(x)[y] = line[x];
+        }
+    }
+    return result;
+}
+}
+
+QImage StickerAlphaKernels::extractAlpha(const QImage &image, int padding)
+{
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    padding = qMax(0, padding);
+    const QImage source = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QImage alpha(source.width() + padding * 2, source.height() + padding * 2, QImage::Format_Alpha8);
+    alpha.fill(0);
+    for (int y = 0; y < source.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+        uchar *out = alpha.scanLine(y + padding) + padding;
+        for (int x = 0; x < source.width(); ++x) {
+            out[x] = uchar(qAlpha(line[x]));
+        }
+    }
+    return alpha;
+}
+
+void StickerAlphaKernels::dilate(QImage &alpha, int radius)
+{
+    if (alpha.isNull() || radius <= 0 || alpha.format() != QImage::Format_Alpha8) {
+        return;
+    }
+    dilateHorizontal(alpha.bits(), alpha.width(), alpha.height(), alpha.bytesPerLine(), radius);
+    dilateVertical(alpha.bits(), alpha.width(), alpha.height(), alpha.bytesPerLine(), radius);
+}
+
+void StickerAlphaKernels::boxBlur(QImage &alpha, int radius, int passes)
+{
+    if (alpha.isNull() || radius <= 0 || passes <= 0 || alpha.format() != QImage::Format_Alpha8) {
+        return;
+    }
+
+    radius = qMin(radius, 128);
+    for (int i = 0; i < passes; ++i) {
+        blurVertical(alpha.bits(), alpha.width(), alpha.height(), alpha.bytesPerLine(), radius);
+    }
+
+    // 水平方向转置后复用垂直核，连续读写更利于向量化
+    QImage columns = transposed(alpha);
+    for (int i = 0; i < passes; ++i) {
+        blurVertical(columns.bits(), columns.width(), columns.height(), columns.bytesPerLine(), radius);
+    }
+    alpha = transposed(columns);
+}
+
+QImage StickerAlphaKernels::colorize(const QImage &alpha, const QColor &color)
+{
+    if (alpha.isNull()) {
+        return QImage();
+    }
+
+    QImage result(alpha.size(), QImage::Format_ARGB32_Premultiplied);
+    const int ca = color.alpha();
+    const int cr = color.red();
+    const int cg = color.green();
+    const int cb = color.blue();
+    for (int y = 0; y < alpha.height(); ++y) {
+        const uchar *line = alpha.constScanLine(y);
+        QRgb *out = reinterpret_cast<QRgb*>(result.scanLine(y));
+        for (int x = 0; x < alpha.width(); ++x) {
+            const int a = (line[x] * ca + 127) / 255;
+            out[x] = qRgba((cr * a + 127) / 255, (cg * a + 127) / 255, (cb * a + 127) / 255, a);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,23 @@
+#ifndef STICKERALPHAKERNELS_H
+#define STICKERALPHAKERNELS_H
+
+#include <QImage>
+
+// 单通道 Alpha 平面上的可分离核（SSE2 可用时走向量路径）
+class StickerAlphaKernels
+{
+public:
+    // 提取 Alpha 平面，四周各留 padding 像素透明边
+    static QImage extractAlpha(const QImage &image, int padding = 0);
+
+    // 方形膨胀（先水平后垂直），radius 为单侧像素数
+    static void dilate(QImage &alpha, int radius);
+
+    // 盒式模糊（先垂直后水平），passes 次叠加近似高斯
+    static void boxBlur(QImage &alpha, int radius, int passes = 3);
+
+    // 将 Alpha 平面按颜色着色为预乘 ARGB 图像
+    static QImage colorize(const QImage &alpha, const QColor &color);
+};
+
+#endif // STICKERALPHAKERNELS_H
@@ -5,6 +5,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QUuid>
+#include "stickerlive2dmanifest.h"
 
 StickerAssetStore::StickerAssetStore()
 {
@@ -12,6 +13,7 @@ StickerAssetStore::StickerAssetStore()
     m_rootDir = QDir::cleanPath(appDir.filePath("data"));
     m_tapesDir = ensureSubdir("Tapes");
     m_modulesDir = ensureSubdir("Modules");
+    m_videosDir = ensureSubdir("Videos");
 }
 
 QString StickerAssetStore::tapesRoot() const
@@ -24,7 +26,23 @@ QString StickerAssetStore::modulesRoot() const
     return m_modulesDir;
 }
 
+QString StickerAssetStore::videosRoot() const
+{
+    return m_videosDir;
+}
+
 QString StickerAssetStore::importImage(const QString &sourcePath, QString *error) const
+{
+    return importFile(sourcePath, m_tapesDir, "图片", error);
+}
+
+QString StickerAssetStore::importVideo(const QString &sourcePath, QString *error) const
+{
+    return importFile(sourcePath, m_videosDir, "视频", error);
+}
+
+QString StickerAssetStore::importFile(const QString &sourcePath, const QString &targetDir,
+                                      const QString &kind, QString *error) const
 {
     if (sourcePath.trimmed().isEmpty()) {
         return QString();
@@ -32,26 +50,26 @@ QString StickerAssetStore::importImage(const QString &sourcePath, QString *error
 
     const QFileInfo sourceInfo(sourcePath);
     const QString absoluteSource = QDir::cleanPath(sourceInfo.absoluteFilePath());
-    if (isPathUnderRoot(absoluteSource, m_tapesDir)) {
+    if (isPathUnderRoot(absoluteSource, targetDir)) {
         return absoluteSource;
     }
 
     if (!sourceInfo.exists() || !sourceInfo.isFile()) {
         if (error) {
-            *error = QString("图片不存在: %1").arg(sourcePath);
+            *error = QString("%1不存在: %2").arg(kind, sourcePath);
         }
         return sourcePath;
     }
 
-    QDir().mkpath(m_tapesDir);
-    QString targetPath = QDir(m_tapesDir).filePath(sourceInfo.fileName());
+    QDir().mkpath(targetDir);
+    QString targetPath = QDir(targetDir).filePath(sourceInfo.fileName());
     if (QFile::exists(targetPath)) {
-        targetPath = uniqueFilePath(m_tapesDir, sourceInfo.fileName());
+        targetPath = uniqueFilePath(targetDir, sourceInfo.fileName());
     }
 
     if (!QFile::copy(absoluteSource, targetPath)) {
         if (error) {
-            *error = QString("复制图片失败: %1").arg(sourcePath);
+            *error = QString("复制%1失败: %2").arg(kind, sourcePath);
         }
         return sourcePath;
     }
@@ -68,6 +86,7 @@ QString StickerAssetStore::importLive2DModel(const QString &modelJsonPath, QStri
     const QFileInfo sourceInfo(modelJsonPath);
     const QString absoluteSource = QDir::cleanPath(sourceInfo.absoluteFilePath());
     if (isPathUnderRoot(absoluteSource, m_modulesDir)) {
+        indexLive2DModel(absoluteSource, error);
         return absoluteSource;
     }
 
@@ -91,8 +110,26 @@ QString StickerAssetStore::importLive2DModel(const QString &modelJsonPath, QStri
         return modelJsonPath;
     }
 
-    QString targetModel = QDir(targetDir).filePath(sourceInfo.fileName());
-    return QDir::cleanPath(targetModel);
+    const QString targetModel = QDir::cleanPath(QDir(targetDir).filePath(sourceInfo.fileName()));
+    indexLive2DModel(targetModel, error);
+    return targetModel;
+}
+
+// 导入时解析一次 model3.json 写出清单；文件缺失只作为错误提示，模型仍然导入
+void StickerAssetStore::indexLive2DModel(const QString &modelJsonPath, QString *error) const
+{
+    StickerLive2DManifest manifest;
+    QString manifestError;
+    if (!StickerLive2DManifest::ensure(modelJsonPath, manifest, &manifestError)) {
+        if (error) {
+            *error = manifestError;
+        }
+        return;
+    }
+    if (!manifest.isComplete() && error) {
+        *error = QString("模型文件不完整: %1 缺少 %2")
+            .arg(modelJsonPath, manifest.missingFiles.join(", "));
+    }
 }
 
 QString StickerAssetStore::ensureSubdir(const QString &name) const
@@ -10,12 +10,17 @@ public:
 
     QString tapesRoot() const;
     QString modulesRoot() const;
+    QString videosRoot() const;
 
     QString importImage(const QString &sourcePath, QString *error = nullptr) const;
     QString importLive2DModel(const QString &modelJsonPath, QString *error = nullptr) const;
+    QString importVideo(const QString &sourcePath, QString *error = nullptr) const;
 
 private:
     QString ensureSubdir(const QString &name) const;
+    void indexLive2DModel(const QString &modelJsonPath, QString *error) const;
+    QString importFile(const QString &sourcePath, const QString &targetDir,
+                       const QString &kind, QString *error) const;
     QString uniqueFilePath(const QString &dirPath, const QString &fileName) const;
     QString uniqueDirPath(const QString &dirPath, const QString &baseName) const;
     bool copyDirRecursive(const QString &sourceDir, const QString &targetDir, QString *error) const;
@@ -24,6 +29,7 @@ private:
     QString m_rootDir;
     QString m_tapesDir;
     QString m_modulesDir;
+    QString m_videosDir;
 };
 
 #endif // STICKERASSETSTORE_H
@@ -0,0 +1,253 @@
+#include "stickercompositor.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
+#include "stickeroverlaywindow.h"
+#include "stickerwidget.h"
+
+StickerCompositor *StickerCompositor::instance()
+{
+    static StickerCompositor *s_instance = new StickerCompositor(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerCompositor::StickerCompositor(QObject *parent)
+    : QObject(parent)
+    , m_enabled(false)
+    , m_rasterSurfaces(true)
+{
+    if (auto *app = qobject_cast<QGuiApplication*>(QCoreApplication::instance())) {
+        connect(app, &QGuiApplication::screenAdded, this, &StickerCompositor::rebuildOverlays);
+        connect(app, &QGuiApplication::screenRemoved, this, &StickerCompositor::rebuildOverlays);
+        connect(app, &QCoreApplication::aboutToQuit, this, &StickerCompositor::releaseOverlays);
+    }
+}
+
+void StickerCompositor::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    qDebug() << "贴纸叠加层合成" << (m_enabled ? "启用" : "停用");
+
+    const QList<StickerWidget*> stickers = m_stickers;
+    for (StickerWidget *sticker : stickers) {
+        refresh(sticker);
+    }
+}
+
+bool StickerCompositor::isEnabled() const
+{
+    return m_enabled;
+}
+
+void StickerCompositor::setRasterSurfacesEnabled(bool enabled)
+{
+    if (m_rasterSurfaces == enabled) {
+        return;
+    }
+    m_rasterSurfaces = enabled;
+    qDebug() << "图片贴纸轻量窗口" << (m_rasterSurfaces ? "启用" : "停用");
+
+    const QList<StickerWidget*> stickers = m_stickers;
+    for (StickerWidget *sticker : stickers) {
+        refresh(sticker);
+    }
+}
+
+bool StickerCompositor::rasterSurfacesEnabled() const
+{
+    return m_rasterSurfaces;
+}
+
+void StickerCompositor::registerSticker(StickerWidget *sticker)
+{
+    if (sticker && !m_stickers.contains(sticker)) {
+        m_stickers.append(sticker);
+    }
+}
+
+void StickerCompositor::unregisterSticker(StickerWidget *sticker)
+{
+    m_stickers.removeAll(sticker);
+    auto it = m_composited.find(sticker);
+    if (it == m_composited.end()) {
+        return;
+    }
+    const Layer layer = it.value();
+    m_composited.erase(it);
+    markLayerDirty(layer, sticker->geometry());
+    updateOverlays();
+}
+
+void StickerCompositor::refresh(StickerWidget *sticker)
+{
+    if (!sticker || !m_stickers.contains(sticker)) {
+        return;
+    }
+
+    const bool eligible = m_enabled && sticker->isCompositeEligible();
+    auto it = m_composited.find(sticker);
+    if (!eligible) {
+        const bool wasComposited = it != m_composited.end();
+        if (wasComposited) {
+            const Layer layer = it.value();
+            m_composited.erase(it);
+            markLayerDirty(layer, sticker->geometry());
+        }
+        // 不进叠加层的图片贴纸在非编辑状态下用轻量窗口
+        sticker->setPresentation(m_rasterSurfaces && sticker->isRasterSurfaceEligible()
+                                 ? StickerWidget::Presentation::RasterSurface
+                                 : StickerWidget::Presentation::Widget);
+        if (wasComposited) {
+            hitRegionChanged(sticker);
+            updateOverlays();
+        }
+        return;
+    }
+
+    const Layer layer = layerFor(sticker);
+    if (it != m_composited.end()) {
+        if (it.value() == layer) {
+            return;
+        }
+        markLayerDirty(it.value(), sticker->geometry());
+        it.value() = layer;
+    } else {
+        m_composited.insert(sticker, layer);
+    }
+    updateOverlays();
+    sticker->setPresentation(StickerWidget::Presentation::Composited);
+    markLayerDirty(layer, sticker->geometry());
+    hitRegionChanged(sticker);
+}
+
+void StickerCompositor::markDirty(StickerWidget *sticker, const QRect &globalRect)
+{
+    auto it = m_composited.constFind(sticker);
+    if (it != m_composited.constEnd()) {
+        markLayerDirty(it.value(), globalRect);
+    }
+}
+
+void StickerCompositor::stickerGeometryChanged(StickerWidget *sticker, const QRect &oldGlobalRect)
+{
+    auto it = m_composited.constFind(sticker);
+    if (it == m_composited.constEnd()) {
+        return;
+    }
+    markLayerDirty(it.value(), oldGlobalRect);
+    markLayerDirty(it.value(), sticker->geometry());
+    hitRegionChanged(sticker);
+}
+
+void StickerCompositor::hitRegionChanged(StickerWidget *sticker)
+{
+    auto it = m_composited.constFind(sticker);
+    for (StickerOverlayWindow *overlay : qAsConst(m_overlays)) {
+        if (it == m_composited.constEnd() || overlay->layer() == it.value()) {
+            overlay->scheduleSync();
+        }
+    }
+}
+
+QList<StickerWidget*> StickerCompositor::stickers(Layer layer) const
+{
+    QList<StickerWidget*> result;
+    for (StickerWidget *sticker : m_stickers) {
+        auto it = m_composited.constFind(sticker);
+        if (it != m_composited.constEnd() && it.value() == layer) {
+            result.append(sticker);
+        }
+    }
+    // 同层内按 zOrder 绘制，次序相同时先注册的在下
+    std::stable_sort(result.begin(), result.end(), [](const StickerWidget *a, const StickerWidget *b) {
+        return a->stackOrder() < b->stackOrder();
+    });
+    return result;
+}
+
+StickerWidget *StickerCompositor::stickerAt(Layer layer, const QPoint &globalPos) const
+{
+    // 自上而下命中测试，与绘制顺序相反
+    const QList<StickerWidget*> candidates = stickers(layer);
+    for (int i = candidates.size() - 1; i >= 0; --i) {
+        StickerWidget *sticker = candidates.at(i);
+        if (!sticker->isShownOnScreen() || !sticker->geometry().contains(globalPos)) {
+            continue;
+        }
+        if (sticker->hitRegion().contains(globalPos - sticker->pos())) {
+            return sticker;
+        }
+    }
+    return nullptr;
+}
+
+StickerCompositor::Layer StickerCompositor::layerFor(const StickerWidget *sticker)
+{
+    const StickerConfig config = sticker->getConfig();
+    if (!config.clickThrough) {
+        return Layer::DesktopInteractive;
+    }
+    return config.isDesktopMode ? Layer::DesktopClickThrough : Layer::TopClickThrough;
+}
+
+void StickerCompositor::markLayerDirty(Layer layer, const QRect &globalRect)
+{
+    if (globalRect.isEmpty()) {
+        return;
+    }
+    for (StickerOverlayWindow *overlay : qAsConst(m_overlays)) {
+        if (overlay->layer() != layer) {
+            continue;
+        }
+        const QRect local = (globalRect & overlay->geometry()).translated(-overlay->pos());
+        if (!local.isEmpty()) {
+            overlay->update(local);
+        }
+    }
+}
+
+// 每层在每个屏幕上按需创建一个叠加层，层内无贴纸时隐藏
+void StickerCompositor::updateOverlays()
+{
+    const QList<QScreen*> screens = QGuiApplication::screens();
+    const Layer layers[] = { Layer::DesktopInteractive, Layer::DesktopClickThrough, Layer::TopClickThrough };
+    for (Layer layer : layers) {
+        if (stickers(layer).isEmpty()) {
+            continue;
+        }
+        for (QScreen *screen : screens) {
+            bool exists = false;
+            for (StickerOverlayWindow *overlay : qAsConst(m_overlays)) {
+                if (overlay->layer() == layer && overlay->targetScreen() == screen) {
+                    exists = true;
+                    break;
+                }
+            }
+            if (!exists) {
+                m_overlays.append(new StickerOverlayWindow(screen, layer));
+            }
+        }
+    }
+
+    for (StickerOverlayWindow *overlay : qAsConst(m_overlays)) {
+        overlay->scheduleSync();
+    }
+}
+
+void StickerCompositor::rebuildOverlays()
+{
+    releaseOverlays();
+    updateOverlays();
+    qDebug() << "屏幕配置变化，重建贴纸叠加层:" << m_overlays.size();
+}
+
+void StickerCompositor::releaseOverlays()
+{
+    qDeleteAll(m_overlays);
+    m_overlays.clear();
+}
@@ -0,0 +1,70 @@
+#ifndef STICKERCOMPOSITOR_H
+#define STICKERCOMPOSITOR_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+
+class QScreen;
+class StickerOverlayWindow;
+class StickerWidget;
+
+// 桌面/穿透贴纸合成器：把符合条件的贴纸画到每个屏幕的透明叠加层上，
+// 不再为每张贴纸维护一个原生分层窗口
+class StickerCompositor : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 同一窗口不能既穿透又可交互，按层拆分叠加层
+    enum class Layer {
+        DesktopInteractive,
+        DesktopClickThrough,
+        TopClickThrough
+    };
+
+    static StickerCompositor *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // 未合成的图片贴纸在非编辑状态下是否使用 QRasterWindow 轻量窗口
+    void setRasterSurfacesEnabled(bool enabled);
+    bool rasterSurfacesEnabled() const;
+
+    void registerSticker(StickerWidget *sticker);
+    void unregisterSticker(StickerWidget *sticker);
+
+    // 重新决定贴纸的显示方式（模式/编辑/类型变化后调用）
+    void refresh(StickerWidget *sticker);
+
+    // globalRect 为全局坐标下需要重绘的区域
+    void markDirty(StickerWidget *sticker, const QRect &globalRect);
+    void stickerGeometryChanged(StickerWidget *sticker, const QRect &oldGlobalRect);
+    void hitRegionChanged(StickerWidget *sticker);
+
+    // 按绘制顺序（先注册的在下）返回某层的贴纸
+    QList<StickerWidget*> stickers(Layer layer) const;
+    StickerWidget *stickerAt(Layer layer, const QPoint &globalPos) const;
+
+private slots:
+    void rebuildOverlays();
+
+private:
+    explicit StickerCompositor(QObject *parent = nullptr);
+
+    static Layer layerFor(const StickerWidget *sticker);
+    void markLayerDirty(Layer layer, const QRect &globalRect);
+    void updateOverlays();
+    void releaseOverlays();
+
+    bool m_enabled;
+    bool m_rasterSurfaces;
+    QList<StickerWidget*> m_stickers;
+    QHash<StickerWidget*, Layer> m_composited;
+    QList<StickerOverlayWindow*> m_overlays;
+};
+
+#endif // STICKERCOMPOSITOR_H
@@ -0,0 +1,89 @@
+# 贴纸引擎：应用与独立渲染基准共用的源码和编译设置。
+# 依赖 Live2D 模块的部分由 STICKER_NO_LIVE2D 关闭，消息气泡由 STICKER_NO_MESSAGE_SDK 关闭
+QT += core gui widgets multimedia opengl
+
+CONFIG += c++11
+msvc: QMAKE_CXXFLAGS += /utf-8
+msvc: QMAKE_CFLAGS += /utf-8
+win32: LIBS += user32.lib gdi32.lib shell32.lib ole32.lib
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/eventhandler.cpp \
+    $$PWD/followlayouthelper.cpp \
+    $$PWD/followwindowclassifier.cpp \
+    $$PWD/stickerdata.cpp \
+    $$PWD/stickeralphakernels.cpp \
+    $$PWD/stickercontextmenucontroller.cpp \
+    $$PWD/stickercursorpoller.cpp \
+    $$PWD/stickereventcontroller.cpp \
+    $$PWD/stickereditcontroller.cpp \
+    $$PWD/stickereffectstage.cpp \
+    $$PWD/stickerfollowcontroller.cpp \
+    $$PWD/stickercompositor.cpp \
+    $$PWD/stickerframeclock.cpp \
+    $$PWD/stickergeometrybatch.cpp \
+    $$PWD/stickerimage.cpp \
+    $$PWD/stickerinteractioncontroller.cpp \
+    $$PWD/stickerlive2dbudget.cpp \
+    $$PWD/stickerlive2dhost.cpp \
+    $$PWD/stickerlive2dloader.cpp \
+    $$PWD/stickerlive2dmanifest.cpp \
+    $$PWD/stickerlive2dmodelcache.cpp \
+    $$PWD/stickerlive2dthrottle.cpp \
+    $$PWD/stickeroverlaywindow.cpp \
+    $$PWD/stickerrestackengine.cpp \
+    $$PWD/stickerrastersurface.cpp \
+    $$PWD/stickerrenderer.cpp \
+    $$PWD/stickerruntime.cpp \
+    $$PWD/stickertiledimage.cpp \
+    $$PWD/stickermemorybudget.cpp \
+    $$PWD/stickerocclusiontracker.cpp \
+    $$PWD/stickerpresenter.cpp \
+    $$PWD/stickertransformlayout.cpp \
+    $$PWD/stickervideosource.cpp \
+    $$PWD/stickerwidget.cpp \
+    $$PWD/windowattachmentservice.cpp \
+    $$PWD/windoweventsource.cpp \
+    $$PWD/windowrecognitionservice.cpp
+
+HEADERS += \
+    $$PWD/eventhandler.h \
+    $$PWD/followlayouthelper.h \
+    $$PWD/followwindowclassifier.h \
+    $$PWD/stickerdata.h \
+    $$PWD/stickeralphakernels.h \
+    $$PWD/stickercontextmenucontroller.h \
+    $$PWD/stickercursorpoller.h \
+    $$PWD/stickereventcontroller.h \
+    $$PWD/stickereditcontroller.h \
+    $$PWD/stickereffectstage.h \
+    $$PWD/stickerfollowcontroller.h \
+    $$PWD/stickercompositor.h \
+    $$PWD/stickerframeclock.h \
+    $$PWD/stickergeometrybatch.h \
+    $$PWD/stickerimage.h \
+    $$PWD/stickerinstance.h \
+    $$PWD/stickerinteractioncontroller.h \
+    $$PWD/stickerlive2dbudget.h \
+    $$PWD/stickerlive2dhost.h \
+    $$PWD/stickerlive2dloader.h \
+    $$PWD/stickerlive2dmanifest.h \
+    $$PWD/stickerlive2dmodelcache.h \
+    $$PWD/stickerlive2dthrottle.h \
+    $$PWD/stickeroverlaywindow.h \
+    $$PWD/stickerrestackengine.h \
+    $$PWD/stickerrastersurface.h \
+    $$PWD/stickerrenderer.h \
+    $$PWD/stickerruntime.h \
+    $$PWD/stickertiledimage.h \
+    $$PWD/stickermemorybudget.h \
+    $$PWD/stickerocclusiontracker.h \
+    $$PWD/stickerpresenter.h \
+    $$PWD/stickertransformlayout.h \
+    $$PWD/stickervideosource.h \
+    $$PWD/stickerwidget.h \
+    $$PWD/windowattachmentservice.h \
+    $$PWD/windoweventsource.h \
+    $$PWD/windowrecognitionservice.h
@@ -0,0 +1,58 @@
+#include "stickercursorpoller.h"
+#include <QCoreApplication>
+#include <QCursor>
+#include <QList>
+
+namespace {
+const int kCursorPollMs = 50;
+}
+
+StickerCursorPoller *StickerCursorPoller::instance()
+{
+    static StickerCursorPoller *s_instance = new StickerCursorPoller(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerCursorPoller::StickerCursorPoller(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(kCursorPollMs);
+    connect(&m_timer, &QTimer::timeout, this, &StickerCursorPoller::onTick);
+}
+
+void StickerCursorPoller::registerClient(const void *client, Callbacks callbacks)
+{
+    if (!client) {
+        return;
+    }
+    m_clients.insert(client, std::move(callbacks));
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void StickerCursorPoller::unregisterClient(const void *client)
+{
+    if (m_clients.remove(client) > 0 && m_clients.isEmpty()) {
+        m_timer.stop();
+    }
+}
+
+void StickerCursorPoller::onTick()
+{
+    const QPoint cursor = QCursor::pos();
+    // 先挑出光标附近的贴纸再通知，回调里可能注销自己或别的贴纸
+    QList<const void*> near;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it.value().hotRect().contains(cursor)) {
+            near.append(it.key());
+        }
+    }
+    for (const void *client : near) {
+        auto it = m_clients.constFind(client);
+        if (it != m_clients.constEnd()) {
+            const Callbacks callbacks = it.value();
+            callbacks.cursorNear(cursor);
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef STICKERCURSORPOLLER_H
+#define STICKERCURSORPOLLER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <QTimer>
+#include <functional>
+
+// 全局光标轮询：需要按光标位置做命中判定的贴纸共用一个定时器，每拍只读一次光标，
+// 只唤醒光标所在范围内的贴纸；没有贴纸登记时定时器停止
+class StickerCursorPoller : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Callbacks {
+        // 全局坐标，光标进入时唤醒
+        std::function<QRect()> hotRect;
+        std::function<void(const QPoint &)> cursorNear;
+    };
+
+    static StickerCursorPoller *instance();
+
+    void registerClient(const void *client, Callbacks callbacks);
+    void unregisterClient(const void *client);
+
+private slots:
+    void onTick();
+
+private:
+    explicit StickerCursorPoller(QObject *parent = nullptr);
+
+    QHash<const void*, Callbacks> m_clients;
+    QTimer m_timer;
+};
+
+#endif // STICKERCURSORPOLLER_H
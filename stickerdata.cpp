@@ -1,8 +1,9 @@
-#include "StickerData.h"
+#include "stickerdata.h"
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonValue>
 #include <QtMath>
+#include <cmath>
 
 namespace {
 QJsonObject live2dToJson(const Live2DConfig &config)
@@ -29,6 +30,35 @@ void live2dFromJson(const QJsonObject &json, Live2DConfig &config)
         config.baseSize = QSize();
     }
 }
+
+const int kMinMotionPeriodMs = 200;
+const int kEnvelopeSamples = 64;
+
+struct MotionKeyframe {
+    double time;
+    double value;
+};
+
+// 各动作的归一化关键帧，值再乘以 amplitude
+const MotionKeyframe kBobFrames[] = { { 0.0, 0.0 }, { 0.5, -1.0 }, { 1.0, 0.0 } };
+const MotionKeyframe kSwayFrames[] = { { 0.0, -1.0 }, { 0.5, 1.0 }, { 1.0, -1.0 } };
+const MotionKeyframe kPulseFrames[] = { { 0.0, 0.0 }, { 0.5, 1.0 }, { 1.0, 0.0 } };
+
+template <int N>
+double sampleKeyframes(const MotionKeyframe (&frames)[N], double phase)
+{
+    for (int i = 1; i < N; ++i) {
+        if (phase <= frames[i].time) {
+            const MotionKeyframe &from = frames[i - 1];
+            const MotionKeyframe &to = frames[i];
+            const double span = to.time - from.time;
+            double t = span > 0 ? (phase - from.time) / span : 1.0;
+            t = t * t * (3.0 - 2.0 * t);
+            return from.value + (to.value - from.value) * t;
+        }
+    }
+    return frames[N - 1].value;
+}
 }
 
 StickerTransform::StickerTransform()
@@ -40,6 +70,93 @@ StickerTransform::StickerTransform()
 {
 }
 
+QTransform StickerMotionFrame::toTransform() const
+{
+    QTransform transform;
+    transform.translate(offset.x(), offset.y());
+    transform.rotate(rotation);
+    transform.scale(scale, scale);
+    return transform;
+}
+
+StickerMotion::StickerMotion()
+    : type(StickerMotionType::None)
+    , amplitude(10.0)
+    , periodMs(2000)
+{
+}
+
+bool StickerMotion::isActive() const
+{
+    return type != StickerMotionType::None;
+}
+
+StickerMotionFrame StickerMotion::sample(double phase) const
+{
+    StickerMotionFrame frame;
+    phase = phase - std::floor(phase);
+    switch (type) {
+    case StickerMotionType::Bob:
+        frame.offset.setY(amplitude * sampleKeyframes(kBobFrames, phase));
+        break;
+    case StickerMotionType::Sway:
+        frame.rotation = amplitude * sampleKeyframes(kSwayFrames, phase);
+        break;
+    case StickerMotionType::Spin:
+        frame.rotation = (amplitude < 0 ? -360.0 : 360.0) * phase;
+        break;
+    case StickerMotionType::Pulse:
+        frame.scale = qMax(0.1, 1.0 + amplitude / 100.0 * sampleKeyframes(kPulseFrames, phase));
+        break;
+    case StickerMotionType::None:
+        break;
+    }
+    return frame;
+}
+
+QRectF StickerMotion::envelope(const QRectF &bounds) const
+{
+    if (!isActive() || bounds.isEmpty()) {
+        return bounds;
+    }
+
+    if (type == StickerMotionType::Spin) {
+        // 旋转一周扫过的是外接圆
+        double radius = 0.0;
+        const QPointF corners[] = { bounds.topLeft(), bounds.topRight(),
+                                    bounds.bottomLeft(), bounds.bottomRight() };
+        for (const QPointF &corner : corners) {
+            radius = qMax(radius, std::hypot(corner.x(), corner.y()));
+        }
+        return QRectF(-radius, -radius, radius * 2, radius * 2);
+    }
+
+    // 采样点包含所有关键帧时刻，再留 1px 余量覆盖关键帧之间的旋转外扩
+    QRectF united = bounds;
+    for (int i = 0; i < kEnvelopeSamples; ++i) {
+        united |= sample(double(i) / kEnvelopeSamples).toTransform().mapRect(bounds);
+    }
+    return united.adjusted(-1, -1, 1, 1);
+}
+
+QJsonObject StickerMotion::toJson() const
+{
+    QJsonObject obj;
+    obj["type"] = static_cast<int>(type);
+    obj["amplitude"] = amplitude;
+    obj["periodMs"] = periodMs;
+    return obj;
+}
+
+void StickerMotion::fromJson(const QJsonObject &json)
+{
+    const int typeValue = json["type"].toInt(0);
+    type = (typeValue >= 0 && typeValue <= static_cast<int>(StickerMotionType::Pulse))
+        ? static_cast<StickerMotionType>(typeValue) : StickerMotionType::None;
+    amplitude = json["amplitude"].toDouble(10.0);
+    periodMs = qMax(kMinMotionPeriodMs, json["periodMs"].toInt(2000));
+}
+
 QString StickerEvent::parametersText() const
 {
     if (parameters.contains("text")) {
@@ -107,6 +224,9 @@ QJsonObject StickerTransform::toJson() const
     obj["rotation"] = rotation;
     obj["shearX"] = shearX;
     obj["shearY"] = shearY;
+    if (motion.isActive()) {
+        obj["motion"] = motion.toJson();
+    }
     return obj;
 }
 
@@ -117,6 +237,10 @@ void StickerTransform::fromJson(const QJsonObject &json)
     rotation = json["rotation"].toDouble(0.0);
     shearX = json["shearX"].toDouble(0.0);
     shearY = json["shearY"].toDouble(0.0);
+    motion = StickerMotion();
+    if (json["motion"].isObject()) {
+        motion.fromJson(json["motion"].toObject());
+    }
 }
 
 QJsonObject StickerEvent::toJson() const
@@ -153,6 +277,63 @@ void StickerEvent::fromJson(const QJsonObject &json)
     enabled = json["enabled"].toBool(true);
 }
 
+StickerEffectConfig::StickerEffectConfig()
+    : outlineEnabled(false)
+    , outlineColor(255, 255, 255)
+    , outlineWidth(4)
+    , shadowEnabled(false)
+    , shadowColor(0, 0, 0, 160)
+    , shadowBlurRadius(8)
+    , shadowOffset(4, 4)
+    , tintEnabled(false)
+    , tintColor(255, 200, 120)
+    , tintStrength(0.3)
+{
+}
+
+bool StickerEffectConfig::isActive() const
+{
+    return (outlineEnabled && outlineWidth > 0)
+        || shadowEnabled
+        || (tintEnabled && tintStrength > 0.0);
+}
+
+QJsonObject StickerEffectConfig::toJson() const
+{
+    QJsonObject obj;
+    obj["outlineEnabled"] = outlineEnabled;
+    obj["outlineColor"] = outlineColor.name(QColor::HexArgb);
+    obj["outlineWidth"] = outlineWidth;
+    obj["shadowEnabled"] = shadowEnabled;
+    obj["shadowColor"] = shadowColor.name(QColor::HexArgb);
+    obj["shadowBlurRadius"] = shadowBlurRadius;
+    obj["shadowOffset"] = QJsonArray{shadowOffset.x(), shadowOffset.y()};
+    obj["tintEnabled"] = tintEnabled;
+    obj["tintColor"] = tintColor.name(QColor::HexArgb);
+    obj["tintStrength"] = tintStrength;
+    return obj;
+}
+
+void StickerEffectConfig::fromJson(const QJsonObject &json)
+{
+    const StickerEffectConfig defaults;
+    outlineEnabled = json["outlineEnabled"].toBool(false);
+    outlineColor = QColor(json["outlineColor"].toString(defaults.outlineColor.name(QColor::HexArgb)));
+    outlineWidth = qBound(0, json["outlineWidth"].toInt(defaults.outlineWidth), 32);
+    shadowEnabled = json["shadowEnabled"].toBool(false);
+    shadowColor = QColor(json["shadowColor"].toString(defaults.shadowColor.name(QColor::HexArgb)));
+    shadowBlurRadius = qBound(0, json["shadowBlurRadius"].toInt(defaults.shadowBlurRadius), 64);
+    QJsonArray offsetArray = json["shadowOffset"].toArray();
+    if (offsetArray.size() >= 2) {
+        shadowOffset = QPoint(offsetArray[0].toInt(), offsetArray[1].toInt());
+    } else {
+        shadowOffset = defaults.shadowOffset;
+    }
+    tintEnabled = json["tintEnabled"].toBool(false);
+    tintColor = QColor(json["tintColor"].toString(defaults.tintColor.name(QColor::HexArgb)));
+    tintStrength = qBound(0.0, json["tintStrength"].toDouble(defaults.tintStrength), 1.0);
+}
+
 StickerFollowConfig::StickerFollowConfig()
     : enabled(false)
     , batchMode(false)
@@ -203,6 +384,28 @@ void StickerFollowConfig::fromJson(const QJsonObject &json)
     hideWhenMinimized = json["hideWhenMinimized"].toBool(true);
 }
 
+StickerVideoConfig::StickerVideoConfig()
+    : loop(true)
+    , muted(true)
+{
+}
+
+QJsonObject StickerVideoConfig::toJson() const
+{
+    QJsonObject obj;
+    obj["path"] = path;
+    obj["loop"] = loop;
+    obj["muted"] = muted;
+    return obj;
+}
+
+void StickerVideoConfig::fromJson(const QJsonObject &json)
+{
+    path = json["path"].toString();
+    loop = json["loop"].toBool(true);
+    muted = json["muted"].toBool(true);
+}
+
 QJsonObject StickerConfig::toJson() const
 {
     QJsonObject obj;
@@ -210,7 +413,9 @@ QJsonObject StickerConfig::toJson() const
     obj["name"] = name;
     obj["contentType"] = static_cast<int>(contentType);
     obj["imagePath"] = imagePath;
+    obj["tiledImage"] = tiledImage;
     obj["live2d"] = live2dToJson(live2d);
+    obj["video"] = video.toJson();
     obj["position"] = QJsonArray{position.x(), position.y()};
     obj["size"] = QJsonArray{size.width(), size.height()};
     obj["isDesktopMode"] = isDesktopMode;
@@ -218,7 +423,9 @@ QJsonObject StickerConfig::toJson() const
     obj["opacity"] = opacity;
     obj["allowDrag"] = allowDrag;       // 新增
     obj["clickThrough"] = clickThrough; // 新增
+    obj["zOrder"] = zOrder;
     obj["transform"] = transform.toJson();
+    obj["effects"] = effects.toJson();
     obj["follow"] = follow.toJson();
 
     QJsonArray eventsArray;
@@ -239,16 +446,22 @@ void StickerConfig::fromJson(const QJsonObject &json)
         ? json["contentType"].toInt(static_cast<int>(StickerContentType::Image))
         : static_cast<int>(StickerContentType::Image);
     if (typeValue != static_cast<int>(StickerContentType::Image)
-        && typeValue != static_cast<int>(StickerContentType::Live2D)) {
+        && typeValue != static_cast<int>(StickerContentType::Live2D)
+        && typeValue != static_cast<int>(StickerContentType::Video)) {
         typeValue = static_cast<int>(StickerContentType::Image);
     }
     contentType = static_cast<StickerContentType>(typeValue);
     imagePath = json["imagePath"].toString();
+    tiledImage = json["tiledImage"].toBool(false);
     if (json["live2d"].isObject()) {
         live2dFromJson(json["live2d"].toObject(), live2d);
     } else {
         live2d = Live2DConfig();
     }
+    video = StickerVideoConfig();
+    if (json["video"].isObject()) {
+        video.fromJson(json["video"].toObject());
+    }
     if (!hasContentType && !live2d.modelJsonPath.isEmpty()) {
         contentType = StickerContentType::Live2D;
     }
@@ -268,6 +481,7 @@ void StickerConfig::fromJson(const QJsonObject &json)
     opacity = json["opacity"].toDouble(1.0);
     allowDrag = json["allowDrag"].toBool(true);         // 新增，默认允许拖动
     clickThrough = json["clickThrough"].toBool(false);  // 新增，默认不穿透
+    zOrder = json["zOrder"].toInt(0);
     if (json["transform"].isObject()) {
         transform.fromJson(json["transform"].toObject());
     } else if (json["transform"].isArray()) {
@@ -284,6 +498,12 @@ void StickerConfig::fromJson(const QJsonObject &json)
         transform = StickerTransform();
     }
 
+    if (json["effects"].isObject()) {
+        effects.fromJson(json["effects"].toObject());
+    } else {
+        effects = StickerEffectConfig();
+    }
+
     if (json["follow"].isObject()) {
         follow.fromJson(json["follow"].toObject());
     } else {
@@ -299,6 +519,33 @@ void StickerConfig::fromJson(const QJsonObject &json)
     }
 }
 
+StickerRuntimeSettings::StickerRuntimeSettings()
+    : memoryBudgetMb(256)
+    , compositeDesktopStickers(false)
+    , rasterSurfaces(true)
+    , maxAnimatedLive2D(4)
+{
+}
+
+QJsonObject StickerRuntimeSettings::toJson() const
+{
+    QJsonObject obj;
+    obj["memoryBudgetMb"] = memoryBudgetMb;
+    obj["compositeDesktopStickers"] = compositeDesktopStickers;
+    obj["rasterSurfaces"] = rasterSurfaces;
+    obj["maxAnimatedLive2D"] = maxAnimatedLive2D;
+    return obj;
+}
+
+void StickerRuntimeSettings::fromJson(const QJsonObject &json)
+{
+    const StickerRuntimeSettings defaults;
+    memoryBudgetMb = qBound(16, json["memoryBudgetMb"].toInt(defaults.memoryBudgetMb), 4096);
+    compositeDesktopStickers = json["compositeDesktopStickers"].toBool(defaults.compositeDesktopStickers);
+    rasterSurfaces = json["rasterSurfaces"].toBool(defaults.rasterSurfaces);
+    maxAnimatedLive2D = qBound(0, json["maxAnimatedLive2D"].toInt(defaults.maxAnimatedLive2D), 64);
+}
+
 QString mouseTriggersToString(MouseTrigger trigger)
 {
     switch (trigger) {
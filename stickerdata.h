@@ -8,8 +8,20 @@
 #include <QList>
 #include <QTransform>
 #include <QPointF>
+#include <QRectF>
 #include <QVariantMap>
+#include <QColor>
+#ifndef STICKER_NO_LIVE2D
 #include "live2dconfig.h"
+#else
+// 不链接 Live2D 模块时（独立渲染基准）只需要配置的数据字段，与 live2dconfig.h 保持一致
+struct Live2DConfig {
+    QString modelJsonPath;
+    QString runtimeRoot;
+    QString shaderProfile = QStringLiteral("Standard");
+    QSize baseSize;
+};
+#endif
 
 // 前向声明
 struct StickerEvent;
@@ -40,7 +52,8 @@ enum class MouseTrigger {
 // 贴纸内容类型
 enum class StickerContentType {
     Image = 0,
-    Live2D
+    Live2D,
+    Video
 };
 
 // 贴纸事件数据
@@ -80,6 +93,60 @@ inline bool operator!=(const StickerEvent &a, const StickerEvent &b)
     return !(a == b);
 }
 
+// 贴纸关键帧动作，绕内容中心叠加在静态变换之后
+enum class StickerMotionType {
+    None = 0,
+    Bob,        // 上下浮动，amplitude 为像素
+    Sway,       // 左右摇摆，amplitude 为角度
+    Spin,       // 匀速旋转，amplitude 为负时逆时针
+    Pulse       // 缩放呼吸，amplitude 为百分比
+};
+
+// 动作在某一相位的偏移
+struct StickerMotionFrame {
+    QPointF offset;
+    double rotation; // 度
+    double scale;
+
+    StickerMotionFrame()
+        : offset(0, 0)
+        , rotation(0.0)
+        , scale(1.0)
+    {
+    }
+
+    QTransform toTransform() const;
+};
+
+struct StickerMotion {
+    StickerMotionType type;
+    double amplitude;
+    int periodMs;
+
+    StickerMotion();
+
+    bool isActive() const;
+    // phase 取 [0, 1)，在关键帧之间缓动插值
+    StickerMotionFrame sample(double phase) const;
+    // 整个周期内内容外接矩形的并集，窗口按它一次性定好大小
+    QRectF envelope(const QRectF &bounds) const;
+
+    QJsonObject toJson() const;
+    void fromJson(const QJsonObject &json);
+};
+
+inline bool operator==(const StickerMotion &a, const StickerMotion &b)
+{
+    return a.type == b.type
+        && qFuzzyCompare(a.amplitude + 1.0, b.amplitude + 1.0)
+        && a.periodMs == b.periodMs;
+}
+
+inline bool operator!=(const StickerMotion &a, const StickerMotion &b)
+{
+    return !(a == b);
+}
+
 // 贴纸变换参数
 struct StickerTransform {
     double scaleX;
@@ -87,6 +154,7 @@ struct StickerTransform {
     double rotation; // 度
     double shearX;
     double shearY;
+    StickerMotion motion;
 
     StickerTransform();
 
@@ -133,13 +201,76 @@ struct StickerFollowConfig {
     void fromJson(const QJsonObject &json);
 };
 
+// 贴纸效果参数（描边、阴影、着色）
+struct StickerEffectConfig {
+    bool outlineEnabled;
+    QColor outlineColor;
+    int outlineWidth;        // 像素
+    bool shadowEnabled;
+    QColor shadowColor;
+    int shadowBlurRadius;    // 像素
+    QPoint shadowOffset;
+    bool tintEnabled;
+    QColor tintColor;
+    double tintStrength;     // 0~1
+
+    StickerEffectConfig();
+
+    bool isActive() const;
+    QJsonObject toJson() const;
+    void fromJson(const QJsonObject &json);
+};
+
+inline bool operator==(const StickerEffectConfig &a, const StickerEffectConfig &b)
+{
+    return a.outlineEnabled == b.outlineEnabled
+        && a.outlineColor == b.outlineColor
+        && a.outlineWidth == b.outlineWidth
+        && a.shadowEnabled == b.shadowEnabled
+        && a.shadowColor == b.shadowColor
+        && a.shadowBlurRadius == b.shadowBlurRadius
+        && a.shadowOffset == b.shadowOffset
+        && a.tintEnabled == b.tintEnabled
+        && a.tintColor == b.tintColor
+        && qFuzzyCompare(a.tintStrength + 1.0, b.tintStrength + 1.0);
+}
+
+inline bool operator!=(const StickerEffectConfig &a, const StickerEffectConfig &b)
+{
+    return !(a == b);
+}
+
+// 视频贴纸参数
+struct StickerVideoConfig {
+    QString path;            // 视频路径
+    bool loop;               // 循环播放
+    bool muted;              // 静音
+
+    StickerVideoConfig();
+
+    QJsonObject toJson() const;
+    void fromJson(const QJsonObject &json);
+};
+
+inline bool operator==(const StickerVideoConfig &a, const StickerVideoConfig &b)
+{
+    return a.path == b.path && a.loop == b.loop && a.muted == b.muted;
+}
+
+inline bool operator!=(const StickerVideoConfig &a, const StickerVideoConfig &b)
+{
+    return !(a == b);
+}
+
 // 贴纸配置数据
 struct StickerConfig {
     QString id;              // 唯一标识
     QString name;            // 贴纸名称
     StickerContentType contentType; // 贴纸类型
     QString imagePath;       // 图片路径
+    bool tiledImage;         // 高分辨率分块加载（不受 600px 上限）
     Live2DConfig live2d;     // Live2D 配置
+    StickerVideoConfig video; // 视频配置
     QPoint position;         // 位置
     QSize size;              // 大小
     bool isDesktopMode;      // 是否为桌面模式
@@ -147,18 +278,22 @@ struct StickerConfig {
     double opacity;          // 透明度
     bool allowDrag;          // 允许拖动
     bool clickThrough;       // 点击穿透
+    int zOrder;              // 同一层带（桌面置底/普通置顶）内的叠放次序，越大越靠上
     StickerTransform transform; // 变换参数
+    StickerEffectConfig effects; // 效果参数
     StickerFollowConfig follow; // 跟随配置
     QList<StickerEvent> events; // 事件列表
 
     // 构造函数
     StickerConfig()
         : contentType(StickerContentType::Image)
+        , tiledImage(false)
         , isDesktopMode(true)
         , visible(true)
         , opacity(1.0)
         , allowDrag(true)        // 默认允许拖动
         , clickThrough(false)    // 默认不穿透
+        , zOrder(0)
     {
     }
 
@@ -166,6 +301,19 @@ struct StickerConfig {
     void fromJson(const QJsonObject &json);
 };
 
+// 全局运行时设置（保存在 sticker.json 的 runtime 节点）
+struct StickerRuntimeSettings {
+    int memoryBudgetMb;      // 贴纸常驻内存预算（MB）
+    bool compositeDesktopStickers; // 桌面/穿透贴纸合成到每屏叠加层
+    bool rasterSurfaces;     // 非编辑状态的图片贴纸使用轻量窗口
+    int maxAnimatedLive2D;   // 同时渲染的 Live2D 模型上限，0 表示不限
+
+    StickerRuntimeSettings();
+
+    QJsonObject toJson() const;
+    void fromJson(const QJsonObject &json);
+};
+
 // 鼠标触发器转换函数
 QString mouseTriggersToString(MouseTrigger trigger);
 MouseTrigger stringToMouseTrigger(const QString &str);
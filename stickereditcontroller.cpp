@@ -60,4 +60,5 @@ void StickerEditController::applyWindowFlags(bool isDesktopMode, bool isFollowMo
             m_host->activateWindow();
         }
     }
+    emit windowFlagsApplied();
 }
@@ -18,6 +18,8 @@ public:
 
 signals:
     void editModeChanged(bool enabled);
+    // setWindowFlags 会重建原生窗口，直接设在旧 QWindow 上的状态随之丢失
+    void windowFlagsApplied();
 
 private:
     QWidget *m_host;
@@ -0,0 +1,208 @@
+#include "stickereffectstage.h"
+#include "stickeralphakernels.h"
+#include "stickerimage.h"
+#include <QImage>
+#include <QPainter>
+#include <QtGlobal>
+
+namespace {
+int scaled(int logical, qreal scale)
+{
+    return qRound(logical * scale);
+}
+}
+
+StickerEffectStage::StickerEffectStage(const StickerImage *image)
+    : m_image(image)
+    , m_padding(0)
+    , m_active(false)
+    , m_builtGeneration(0)
+    , m_dirty(true)
+{
+}
+
+void StickerEffectStage::setImage(const StickerImage *image)
+{
+    m_image = image;
+    m_dirty = true;
+}
+
+void StickerEffectStage::setEffects(const StickerEffectConfig &effects)
+{
+    if (m_effects == effects) {
+        return;
+    }
+    m_effects = effects;
+    m_dirty = true;
+}
+
+const StickerEffectConfig &StickerEffectStage::effects() const
+{
+    return m_effects;
+}
+
+QPixmap StickerEffectStage::pixmap(qreal devicePixelRatio) const
+{
+    ensureLayout();
+    if (!m_active) {
+        return m_image ? m_image->pixmap(devicePixelRatio) : QPixmap();
+    }
+
+    const int key = StickerImage::rasterKey(devicePixelRatio);
+    auto it = m_results.constFind(key);
+    if (it != m_results.constEnd()) {
+        return it.value();
+    }
+
+    QPixmap result = buildResult(key);
+    m_results.insert(key, result);
+    StickerImage::pruneRasters(m_results, key);
+    return result;
+}
+
+bool StickerEffectStage::isNull() const
+{
+    return !m_image || m_image->isNull();
+}
+
+QRect StickerEffectStage::contentRect() const
+{
+    ensureLayout();
+    if (m_active) {
+        return m_resultContentRect;
+    }
+    return m_image ? m_image->contentRect() : QRect();
+}
+
+QSize StickerEffectStage::baseSize() const
+{
+    ensureLayout();
+    if (m_active) {
+        return m_resultContentRect.isValid() ? m_resultContentRect.size() : m_resultSize;
+    }
+    return m_image ? m_image->baseSize() : QSize();
+}
+
+QRectF StickerEffectStage::sourceRect(qreal devicePixelRatio) const
+{
+    ensureLayout();
+    if (!m_active) {
+        return m_image ? m_image->sourceRect(devicePixelRatio) : QRectF();
+    }
+
+    const QPixmap result = pixmap(devicePixelRatio);
+    const qreal sx = qreal(result.width()) / m_resultSize.width();
+    const qreal sy = qreal(result.height()) / m_resultSize.height();
+    const QRect logical = m_resultContentRect.isValid()
+        ? m_resultContentRect
+        : QRect(QPoint(0, 0), m_resultSize);
+    return QRectF(logical.x() * sx, logical.y() * sy, logical.width() * sx, logical.height() * sy);
+}
+
+void StickerEffectStage::releaseResults()
+{
+    m_results.clear();
+}
+
+qint64 StickerEffectStage::residentBytes() const
+{
+    qint64 bytes = 0;
+    for (auto it = m_results.constBegin(); it != m_results.constEnd(); ++it) {
+        const QPixmap &result = it.value();
+        bytes += qint64(result.width()) * result.height() * (result.depth() / 8);
+    }
+    return bytes;
+}
+
+void StickerEffectStage::ensureLayout() const
+{
+    const quint64 generation = m_image ? m_image->generation() : 0;
+    if (!m_dirty && generation == m_builtGeneration) {
+        return;
+    }
+
+    m_results.clear();
+    m_builtGeneration = generation;
+    m_dirty = false;
+    m_active = m_image && !m_image->isNull() && m_effects.isActive();
+    if (!m_active) {
+        m_resultSize = QSize();
+        m_resultContentRect = QRect();
+        m_padding = 0;
+        return;
+    }
+
+    const int outline = m_effects.outlineEnabled ? qMax(0, m_effects.outlineWidth) : 0;
+    const bool shadow = m_effects.shadowEnabled;
+    const int blur = shadow ? qMax(0, m_effects.shadowBlurRadius) : 0;
+    const QPoint shadowOffset = shadow ? m_effects.shadowOffset : QPoint(0, 0);
+    // 三次盒式模糊的实际扩散约为 3 * ceil(blur / 3)，多留 2 像素
+    const int spread = blur + 2;
+    const int shadowReach = shadow
+        ? outline + spread + qMax(qAbs(shadowOffset.x()), qAbs(shadowOffset.y()))
+        : 0;
+    m_padding = qMax(outline, shadowReach);
+
+    const QSize logical = m_image->logicalSize();
+    m_resultSize = QSize(logical.width() + m_padding * 2, logical.height() + m_padding * 2);
+
+    QRect content = m_image->contentRect().isValid()
+        ? m_image->contentRect()
+        : QRect(QPoint(0, 0), logical);
+    content.translate(m_padding, m_padding);
+    QRect expanded = content.adjusted(-outline, -outline, outline, outline);
+    if (shadow) {
+        expanded |= expanded.translated(shadowOffset).adjusted(-spread, -spread, spread, spread);
+    }
+    m_resultContentRect = expanded & QRect(QPoint(0, 0), m_resultSize);
+}
+
+QPixmap StickerEffectStage::buildResult(int key) const
+{
+    const qreal scale = StickerImage::rasterScale(key);
+    const QImage source = m_image->pixmap(scale).toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const int padding = scaled(m_padding, scale);
+    const int outline = m_effects.outlineEnabled ? scaled(qMax(0, m_effects.outlineWidth), scale) : 0;
+    const bool shadow = m_effects.shadowEnabled;
+    const int blur = shadow ? scaled(qMax(0, m_effects.shadowBlurRadius), scale) : 0;
+    const QPoint shadowOffset = shadow
+        ? QPoint(scaled(m_effects.shadowOffset.x(), scale), scaled(m_effects.shadowOffset.y(), scale))
+        : QPoint(0, 0);
+
+    QImage result(source.width() + padding * 2, source.height() + padding * 2,
+                  QImage::Format_ARGB32_Premultiplied);
+    result.fill(Qt::transparent);
+    QPainter painter(&result);
+
+    QImage silhouette;
+    if (outline > 0 || shadow) {
+        silhouette = StickerAlphaKernels::extractAlpha(source, padding);
+        StickerAlphaKernels::dilate(silhouette, outline);
+    }
+
+    if (shadow) {
+        QImage shadowAlpha = silhouette;
+        StickerAlphaKernels::boxBlur(shadowAlpha, (blur + 2) / 3, 3);
+        painter.drawImage(shadowOffset, StickerAlphaKernels::colorize(shadowAlpha, m_effects.shadowColor));
+    }
+
+    if (outline > 0) {
+        painter.drawImage(0, 0, StickerAlphaKernels::colorize(silhouette, m_effects.outlineColor));
+    }
+
+    QImage body = source;
+    if (m_effects.tintEnabled && m_effects.tintStrength > 0.0) {
+        QColor tint = m_effects.tintColor;
+        tint.setAlphaF(qBound(0.0, m_effects.tintStrength, 1.0) * tint.alphaF());
+        QPainter tintPainter(&body);
+        tintPainter.setCompositionMode(QPainter::CompositionMode_SourceAtop);
+        tintPainter.fillRect(body.rect(), tint);
+        tintPainter.end();
+    }
+    painter.drawImage(padding, padding, body);
+    painter.end();
+
+    QPixmap pixmap = QPixmap::fromImage(result);
+    pixmap.setDevicePixelRatio(scale);
+    return pixmap;
+}
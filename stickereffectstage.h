@@ -0,0 +1,48 @@
+#ifndef STICKEREFFECTSTAGE_H
+#define STICKEREFFECTSTAGE_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QRect>
+#include <QSize>
+#include "stickerdata.h"
+
+class StickerImage;
+
+// 位于 StickerImage 与 StickerRenderer 之间的效果阶段：
+// 描边/阴影/着色结果只在图像代次或效果参数变化时重建，绘制时直接取缓存；
+// 布局（逻辑尺寸、内容区域）与 DPR 无关，栅格按 DPR 分别缓存
+class StickerEffectStage
+{
+public:
+    explicit StickerEffectStage(const StickerImage *image = nullptr);
+
+    void setImage(const StickerImage *image);
+    void setEffects(const StickerEffectConfig &effects);
+    const StickerEffectConfig &effects() const;
+
+    QPixmap pixmap(qreal devicePixelRatio = 1.0) const;
+    bool isNull() const;
+    QRect contentRect() const;
+    QSize baseSize() const;
+    QRectF sourceRect(qreal devicePixelRatio = 1.0) const;
+
+    void releaseResults();
+    qint64 residentBytes() const;
+
+private:
+    void ensureLayout() const;
+    QPixmap buildResult(int key) const;
+
+    const StickerImage *m_image;
+    StickerEffectConfig m_effects;
+    mutable QHash<int, QPixmap> m_results;
+    mutable QSize m_resultSize;
+    mutable QRect m_resultContentRect;
+    mutable int m_padding;
+    mutable bool m_active;
+    mutable quint64 m_builtGeneration;
+    mutable bool m_dirty;
+};
+
+#endif // STICKEREFFECTSTAGE_H
@@ -2,8 +2,8 @@
 #define STICKEREVENTCONTROLLER_H
 
 #include <QObject>
-#include "EventHandler.h"
-#include "StickerData.h"
+#include "eventhandler.h"
+#include "stickerdata.h"
 
 class QWidget;
 
@@ -3,7 +3,6 @@
 #include "stickerinstance.h"
 #include "stickerruntime.h"
 #include "stickerwidget.h"
-#include <QRegularExpression>
 #include <QtMath>
 
 namespace {
@@ -24,15 +23,22 @@ StickerFollowController::StickerFollowController(StickerRuntime *runtime, QObjec
     , m_runtime(runtime)
     , m_windowService(this)
     , m_timer(new QTimer(this))
+    , m_nativeEvents(WindowEventSource::createNative(this))
+    , m_events(nullptr)
+    , m_dirtyAll(false)
     , m_refreshing(false)
 {
-    m_timer->setSingleShot(false);
-    connect(m_timer, &QTimer::timeout, this, &StickerFollowController::refresh);
+    connect(m_timer, &QTimer::timeout, this, &StickerFollowController::onTimer);
+    setEventSource(nullptr);
+    if (m_runtime) {
+        m_attachmentService.setGeometryBatch(m_runtime->geometryBatch());
+    }
 }
 
 void StickerFollowController::setRuntime(StickerRuntime *runtime)
 {
     m_runtime = runtime;
+    m_attachmentService.setGeometryBatch(m_runtime ? m_runtime->geometryBatch() : nullptr);
 }
 
 void StickerFollowController::setTemplates(const QList<StickerConfig> &configs)
@@ -72,6 +78,11 @@ void StickerFollowController::updateTemplate(const StickerConfig &config)
 
     TemplateState &state = m_templates[sanitized.id];
     state.config = sanitized;
+    if (sanitized.follow.enabled && sanitized.follow.batchMode) {
+        m_classifier.setFilter(sanitized.id, sanitized.follow.filterType, sanitized.follow.filterValue);
+    } else {
+        m_classifier.removeFilter(sanitized.id);
+    }
 
     updateTemplateVisibility(sanitized);
 
@@ -95,6 +106,7 @@ void StickerFollowController::removeTemplate(const QString &templateId)
 
     removeAllInstances(it.value());
     m_templates.erase(it);
+    m_classifier.removeFilter(templateId);
     syncTimer();
 }
 
@@ -111,7 +123,39 @@ void StickerFollowController::clear()
 
 bool StickerFollowController::isActive() const
 {
-    return m_timer->isActive();
+    return m_timer->isActive() || (m_events && m_events->isWatching());
+}
+
+StickerFollowController::RefreshStats StickerFollowController::refreshStats() const
+{
+    return m_refreshStats;
+}
+
+void StickerFollowController::resetRefreshStats()
+{
+    m_refreshStats = RefreshStats();
+}
+
+void StickerFollowController::setEventSource(WindowEventSource *source)
+{
+    if (m_events) {
+        disconnect(m_events, nullptr, this, nullptr);
+        m_events->setWatchedWindows(QSet<WindowHandle>(), false);
+    }
+    m_events = source ? source : m_nativeEvents;
+    // 已挂接失败的事件源不再使用
+    if (m_events && m_events->hasFailed()) {
+        m_events = nullptr;
+    }
+    if (m_events) {
+        connect(m_events, &WindowEventSource::windowChanged, this, &StickerFollowController::onWindowChanged);
+    }
+    // 事件驱动时定时器只用于合并一段时间内的事件
+    m_timer->stop();
+    m_timer->setSingleShot(m_events != nullptr);
+    m_dirtyHandles.clear();
+    m_dirtyAll = false;
+    syncTimer();
 }
 
 bool StickerFollowController::lockToTargetWindow(const QString &templateId,
@@ -127,7 +171,8 @@ bool StickerFollowController::lockToTargetWindow(const QString &templateId,
         return false;
     }
 
-    WindowInfo info = m_windowService.queryWindow(handle);
+    WindowInfo info = m_windowService.queryWindow(handle, WindowRecognitionService::RectField
+                                                          | WindowRecognitionService::ProcessField);
     if (info.handle == 0 || info.rect.isNull()) {
         return false;
     }
@@ -180,55 +225,165 @@ void StickerFollowController::clearTarget(const QString &templateId)
 
 void StickerFollowController::refresh()
 {
-    if (m_refreshing || !m_runtime) {
+    refreshTemplates(nullptr);
+}
+
+void StickerFollowController::onTimer()
+{
+    if (!m_events) {
+        refresh();
         return;
     }
+    const QSet<WindowHandle> dirty = m_dirtyHandles;
+    const bool all = m_dirtyAll;
+    m_dirtyHandles.clear();
+    m_dirtyAll = false;
+    refreshTemplates(all ? nullptr : &dirty);
+}
 
-    m_refreshing = true;
+// 目标窗口变化后合并到下一次刷新；窗口出现/消失或前台切换时需要重新枚举，
+// 批量实例的目标移动只更新该实例
+void StickerFollowController::onWindowChanged(WindowHandle handle, WindowEventSource::Event event)
+{
+    const bool tracked = m_trackedHandles.contains(handle);
+    const bool enumerated = m_enumeratedHandles.contains(handle);
+    if (event == WindowEventSource::Event::Moved && enumerated) {
+        m_dirtyHandles.insert(handle);
+    } else if (event == WindowEventSource::Event::Foreground || enumerated
+        || (!tracked && needsEnumeration())) {
+        m_dirtyAll = true;
+    } else if (tracked) {
+        m_dirtyHandles.insert(handle);
+    } else {
+        return;
+    }
+    if (!m_timer->isActive()) {
+        m_timer->start(qMax(16, effectiveIntervalMs()));
+    }
+}
 
-    QList<WindowInfo> windows;
-    bool needEnumeration = false;
+bool StickerFollowController::needsEnumeration() const
+{
     for (auto it = m_templates.constBegin(); it != m_templates.constEnd(); ++it) {
         const StickerFollowConfig &follow = it.value().config.follow;
         if (!follow.enabled) {
             continue;
         }
         if (isBatchAnchored(follow, it.value().primaryHandle)) {
-            needEnumeration = true;
-            break;
+            return true;
         }
         if (it.value().primaryHandle == 0 && !follow.targetProcessName.trimmed().isEmpty()) {
-            needEnumeration = true;
-            break;
+            return true;
         }
     }
+    return false;
+}
+
+// 定位只要位置与状态，按进程找目标要进程名，标题/类名只在批量过滤用到时才读
+WindowRecognitionService::WindowFields StickerFollowController::enumerationFields() const
+{
+    return WindowRecognitionService::RectField
+        | WindowRecognitionService::StateField
+        | WindowRecognitionService::ProcessField
+        | m_classifier.requiredFields();
+}
+
+void StickerFollowController::refreshTemplates(const QSet<WindowHandle> *dirty)
+{
+    if (m_refreshing || !m_runtime) {
+        return;
+    }
+
+    m_refreshing = true;
 
+    // 枚举一次，所有批量模板在同一遍分类里得出各自命中的窗口
+    WindowSnapshot snapshot;
+    const bool needEnumeration = dirty == nullptr && needsEnumeration();
+    if (dirty) {
+        ++m_refreshStats.partialRefreshes;
+    } else {
+        ++m_refreshStats.fullRefreshes;
+    }
     if (needEnumeration) {
-        windows = m_windowService.listWindows(true);
+        ++m_refreshStats.enumerations;
+        snapshot = buildSnapshot(m_windowService.listWindows(true, enumerationFields()), !m_classifier.isEmpty());
     }
 
+    // 本次刷新内所有实例的移动与层级调整合并为一次提交
+    m_runtime->beginGeometryBatch();
+
     for (auto it = m_templates.begin(); it != m_templates.end(); ++it) {
         if (!it.value().config.follow.enabled) {
             continue;
         }
+        // 批量跟随要重新枚举才能判断实例增减；局部刷新只移动目标窗口变化了的实例
+        if (dirty && it.value().config.follow.batchMode) {
+            if (refreshBatchInstances(it.value(), *dirty)) {
+                ++m_refreshStats.templateRefreshes[it.key()];
+            }
+            continue;
+        }
+        if (dirty && !dirty->contains(it.value().primaryHandle)) {
+            continue;
+        }
+        ++m_refreshStats.templateRefreshes[it.key()];
         if (!it.value().config.follow.batchMode && it.value().primaryHandle != 0 && !needEnumeration) {
-            WindowInfo info = m_windowService.queryWindow(it.value().primaryHandle);
+            WindowInfo info = m_windowService.queryWindow(it.value().primaryHandle,
+                                                          WindowRecognitionService::RectField
+                                                          | WindowRecognitionService::StateField);
             QList<WindowInfo> subset;
             if (info.handle != 0 && info.visible) {
                 subset.append(info);
             }
-            updateInstancesForTemplate(it.value(), subset);
+            updateInstancesForTemplate(it.value(), buildSnapshot(subset, false));
         } else {
-            updateInstancesForTemplate(it.value(), windows);
+            updateInstancesForTemplate(it.value(), snapshot);
         }
     }
 
+    m_runtime->commitGeometryBatch();
     m_refreshing = false;
+    // 刷新可能锁定了新的目标窗口或去掉了实例，同步事件源的关注范围
+    if (m_events) {
+        syncTimer();
+    }
 }
 
 void StickerFollowController::syncTimer()
 {
     int interval = effectiveIntervalMs();
+    if (m_events) {
+        m_trackedHandles.clear();
+        m_enumeratedHandles.clear();
+        if (interval > 0) {
+            for (auto it = m_templates.constBegin(); it != m_templates.constEnd(); ++it) {
+                if (!it.value().config.follow.enabled) {
+                    continue;
+                }
+                QSet<WindowHandle> &handles = it.value().config.follow.batchMode
+                    ? m_enumeratedHandles : m_trackedHandles;
+                if (it.value().primaryHandle != 0) {
+                    handles.insert(it.value().primaryHandle);
+                }
+                for (auto handle = it.value().instanceIds.constBegin();
+                     handle != it.value().instanceIds.constEnd(); ++handle) {
+                    handles.insert(handle.key());
+                }
+            }
+        }
+        m_events->setWatchedWindows(m_trackedHandles + m_enumeratedHandles, interval > 0 && needsEnumeration());
+        if (!m_events->hasFailed()) {
+            return;
+        }
+        // 挂接失败：放弃事件源，按 pollIntervalMs 定时轮询
+        disconnect(m_events, nullptr, this, nullptr);
+        m_events = nullptr;
+        m_timer->stop();
+        m_timer->setSingleShot(false);
+        m_dirtyHandles.clear();
+        m_dirtyAll = false;
+    }
+
     if (interval <= 0) {
         if (m_timer->isActive()) {
             m_timer->stop();
@@ -266,40 +421,21 @@ int StickerFollowController::effectiveIntervalMs() const
     return interval;
 }
 
-QList<WindowInfo> StickerFollowController::filterWindows(const StickerFollowConfig &follow,
-                                                         const QList<WindowInfo> &windows) const
+StickerFollowController::WindowSnapshot StickerFollowController::buildSnapshot(const QList<WindowInfo> &windows,
+                                                                               bool classify)
 {
-    QList<WindowInfo> result;
-    if (!follow.enabled || follow.filterValue.trimmed().isEmpty()) {
-        return result;
-    }
-
+    WindowSnapshot snapshot;
     for (const WindowInfo &info : windows) {
-        if (matchesFilter(follow, info)) {
-            result.append(info);
-        }
-    }
-    return result;
-}
-
-bool StickerFollowController::matchesFilter(const StickerFollowConfig &follow, const WindowInfo &info) const
-{
-    switch (follow.filterType) {
-    case FollowFilterType::WindowClass:
-        return info.className.contains(follow.filterValue, Qt::CaseInsensitive);
-    case FollowFilterType::ProcessName:
-        return info.processName.contains(follow.filterValue, Qt::CaseInsensitive);
-    case FollowFilterType::WindowTitleRegex: {
-        QRegularExpression regex(follow.filterValue, QRegularExpression::CaseInsensitiveOption);
-        if (!regex.isValid()) {
-            return false;
+        snapshot.byHandle.insert(info.handle, info);
+        const QString process = info.processName.toCaseFolded();
+        if (!process.isEmpty() && !snapshot.byProcess.contains(process)) {
+            snapshot.byProcess.insert(process, info);
         }
-        return regex.match(info.title).hasMatch();
     }
-    default:
-        break;
+    if (classify) {
+        snapshot.batchMatches = m_classifier.classify(windows);
     }
-    return false;
+    return snapshot;
 }
 
 QPoint StickerFollowController::computeAnchoredPosition(const QRectF &windowRect,
@@ -353,7 +489,7 @@ QString StickerFollowController::makeInstanceId(const QString &templateId, Windo
 }
 
 void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
-                                                         const QList<WindowInfo> &windows)
+                                                         const WindowSnapshot &snapshot)
 {
     const StickerFollowConfig &follow = state.config.follow;
     if (follow.batchMode && !isBatchAnchored(follow, state.primaryHandle)) {
@@ -363,26 +499,22 @@ void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
     }
     QList<WindowInfo> matched;
     if (!follow.batchMode && state.primaryHandle != 0) {
-        for (const WindowInfo &info : windows) {
-            if (info.handle == state.primaryHandle) {
-                matched.append(info);
-                break;
-            }
+        auto found = snapshot.byHandle.constFind(state.primaryHandle);
+        if (found != snapshot.byHandle.constEnd()) {
+            matched.append(found.value());
         }
     }
     if (matched.isEmpty()) {
         if (!follow.batchMode && state.primaryHandle == 0
             && !follow.targetProcessName.trimmed().isEmpty()) {
-            for (const WindowInfo &info : windows) {
-                if (info.processName.compare(follow.targetProcessName, Qt::CaseInsensitive) == 0) {
-                    matched.append(info);
-                    state.primaryHandle = info.handle;
-                    updateTemplateVisibility(state.config);
-                    break;
-                }
+            auto found = snapshot.byProcess.constFind(follow.targetProcessName.toCaseFolded());
+            if (found != snapshot.byProcess.constEnd()) {
+                matched.append(found.value());
+                state.primaryHandle = found.value().handle;
+                updateTemplateVisibility(state.config);
             }
         } else if (follow.batchMode) {
-            matched = filterWindows(follow, windows);
+            matched = snapshot.batchMatches.value(state.config.id);
         }
     }
     QSet<WindowHandle> aliveHandles;
@@ -390,6 +522,9 @@ void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
     if (matched.isEmpty()) {
         removeStaleInstances(state, aliveHandles);
         state.primaryHandle = 0;
+        if (StickerWidget *primary = m_runtime->widget(state.config.id)) {
+            primary->setFollowTargetMinimized(false);
+        }
         return;
     }
 
@@ -434,8 +569,9 @@ void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
 
             StickerInstance *updated = m_runtime->createOrUpdatePrimary(instanceConfig);
             if (updated && updated->widget) {
-                m_attachmentService.detach(updated->widget);
-                m_attachmentService.ensureZOrder(updated->widget, target.handle);
+                updated->widget->setFollowTargetMinimized(target.minimized);
+                m_attachmentService.detach(updated->widget->nativeHandle());
+                m_attachmentService.ensureZOrder(updated->widget->nativeHandle(), target.handle);
             }
             return;
         }
@@ -454,11 +590,12 @@ void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
         StickerInstance *instance = m_runtime->createOrUpdateInstance(instanceConfig, instanceId,
                                                                       state.config.id, false);
         if (instance && instance->widget) {
+            instance->widget->setFollowTargetMinimized(target.minimized);
             if (instanceConfig.contentType == StickerContentType::Live2D) {
-                m_attachmentService.detach(instance->widget);
-                m_attachmentService.ensureZOrder(instance->widget, target.handle);
+                m_attachmentService.detach(instance->widget->nativeHandle());
+                m_attachmentService.ensureZOrder(instance->widget->nativeHandle(), target.handle);
             } else {
-                m_attachmentService.attach(instance->widget, target.handle);
+                m_attachmentService.attach(instance->widget->nativeHandle(), target.handle);
             }
         }
         state.instanceIds[target.handle] = instanceId;
@@ -468,31 +605,56 @@ void StickerFollowController::updateInstancesForTemplate(TemplateState &state,
 
     for (const WindowInfo &info : matched) {
         aliveHandles.insert(info.handle);
-        QString instanceId = makeInstanceId(state.config.id, info.handle);
-        StickerInstance *existing = m_runtime->instance(instanceId);
-        QSize stickerSize = resolveStickerSize(state.config, existing);
-        StickerConfig instanceConfig = state.config;
-        if (!stickerSize.isEmpty()) {
-            instanceConfig.size = stickerSize;
-        }
-        instanceConfig.position = computeAnchoredPosition(info.rect, instanceConfig.size, follow);
-        instanceConfig.visible = state.config.visible
-            && (!info.minimized || !follow.hideWhenMinimized);
+        updateBatchInstance(state, info);
+    }
 
-        StickerInstance *instance = m_runtime->createOrUpdateInstance(instanceConfig, instanceId,
-                                                                      state.config.id, false);
-        if (instance && instance->widget) {
-            if (instanceConfig.contentType == StickerContentType::Live2D) {
-                m_attachmentService.detach(instance->widget);
-                m_attachmentService.ensureZOrder(instance->widget, info.handle);
-            } else {
-                m_attachmentService.attach(instance->widget, info.handle);
-            }
+    removeStaleInstances(state, aliveHandles);
+}
+
+void StickerFollowController::updateBatchInstance(TemplateState &state, const WindowInfo &info)
+{
+    const StickerFollowConfig &follow = state.config.follow;
+    QString instanceId = makeInstanceId(state.config.id, info.handle);
+    StickerInstance *existing = m_runtime->instance(instanceId);
+    QSize stickerSize = resolveStickerSize(state.config, existing);
+    StickerConfig instanceConfig = state.config;
+    if (!stickerSize.isEmpty()) {
+        instanceConfig.size = stickerSize;
+    }
+    instanceConfig.position = computeAnchoredPosition(info.rect, instanceConfig.size, follow);
+    instanceConfig.visible = state.config.visible
+        && (!info.minimized || !follow.hideWhenMinimized);
+
+    StickerInstance *instance = m_runtime->createOrUpdateInstance(instanceConfig, instanceId,
+                                                                  state.config.id, false);
+    if (instance && instance->widget) {
+        instance->widget->setFollowTargetMinimized(info.minimized);
+        if (instanceConfig.contentType == StickerContentType::Live2D) {
+            m_attachmentService.detach(instance->widget->nativeHandle());
+            m_attachmentService.ensureZOrder(instance->widget->nativeHandle(), info.handle);
+        } else {
+            m_attachmentService.attach(instance->widget->nativeHandle(), info.handle);
         }
-        state.instanceIds[info.handle] = instanceId;
     }
+    state.instanceIds[info.handle] = instanceId;
+}
 
-    removeStaleInstances(state, aliveHandles);
+// 已有实例的目标窗口移动：逐个查询，不重新枚举；窗口已消失的留给随后的隐藏/销毁事件整体刷新
+bool StickerFollowController::refreshBatchInstances(TemplateState &state, const QSet<WindowHandle> &dirty)
+{
+    bool updated = false;
+    for (WindowHandle handle : dirty) {
+        if (!state.instanceIds.contains(handle)) {
+            continue;
+        }
+        const WindowInfo info = m_windowService.queryWindow(handle, WindowRecognitionService::RectField
+                                                                    | WindowRecognitionService::StateField);
+        if (info.handle != 0 && info.visible) {
+            updateBatchInstance(state, info);
+            updated = true;
+        }
+    }
+    return updated;
 }
 
 void StickerFollowController::updateTemplateVisibility(const StickerConfig &config)
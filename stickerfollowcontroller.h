@@ -8,8 +8,10 @@
 #include <QRectF>
 #include <QSet>
 #include <QTimer>
+#include "followwindowclassifier.h"
 #include "stickerdata.h"
 #include "windowattachmentservice.h"
+#include "windoweventsource.h"
 #include "windowrecognitionservice.h"
 
 class StickerRuntime;
@@ -31,10 +33,32 @@ public:
     bool lockToTargetWindow(const QString &templateId, WindowHandle handle, StickerConfig *outConfig = nullptr);
     void clearTarget(const QString &templateId);
 
+    // 刷新统计：整体/局部刷新次数、重新枚举次数，以及各模板实际被刷新的次数
+    struct RefreshStats {
+        quint64 fullRefreshes = 0;
+        quint64 partialRefreshes = 0;
+        quint64 enumerations = 0;
+        QHash<QString, quint64> templateRefreshes;
+    };
+    RefreshStats refreshStats() const;
+    void resetRefreshStats();
+
+    // 不接管所有权，传 nullptr 恢复原生事件源；平台没有事件源或挂接失败时按 pollIntervalMs 定时轮询
+    void setEventSource(WindowEventSource *source);
+
 private slots:
     void refresh();
+    void onTimer();
+    void onWindowChanged(WindowHandle handle, WindowEventSource::Event event);
 
 private:
+    // 一次枚举的窗口快照：按句柄、按进程名索引，批量模板的命中在一遍分类中得出
+    struct WindowSnapshot {
+        QHash<WindowHandle, WindowInfo> byHandle;
+        QHash<QString, WindowInfo> byProcess;          // 折叠大小写的进程名 -> 首个窗口
+        QHash<QString, QList<WindowInfo>> batchMatches;
+    };
+
     struct TemplateState {
         StickerConfig config;
         QHash<WindowHandle, QString> instanceIds;
@@ -43,9 +67,10 @@ private:
 
     void syncTimer();
     int effectiveIntervalMs() const;
-    QList<WindowInfo> filterWindows(const StickerFollowConfig &follow,
-                                    const QList<WindowInfo> &windows) const;
-    bool matchesFilter(const StickerFollowConfig &follow, const WindowInfo &info) const;
+    // dirty 为空指针时刷新全部模板，否则只刷新目标窗口在其中的模板
+    void refreshTemplates(const QSet<WindowHandle> *dirty);
+    bool needsEnumeration() const;
+    WindowRecognitionService::WindowFields enumerationFields() const;
     QPoint computeAnchoredPosition(const QRectF &windowRect,
                                    const QSize &stickerSize,
                                    const StickerFollowConfig &follow) const;
@@ -56,7 +81,10 @@ private:
                                      const StickerFollowConfig &follow) const;
     QSize resolveStickerSize(const StickerConfig &config, const StickerInstance *instance) const;
     QString makeInstanceId(const QString &templateId, WindowHandle handle) const;
-    void updateInstancesForTemplate(TemplateState &state, const QList<WindowInfo> &windows);
+    WindowSnapshot buildSnapshot(const QList<WindowInfo> &windows, bool classify);
+    void updateInstancesForTemplate(TemplateState &state, const WindowSnapshot &snapshot);
+    void updateBatchInstance(TemplateState &state, const WindowInfo &info);
+    bool refreshBatchInstances(TemplateState &state, const QSet<WindowHandle> &dirty);
     void updateTemplateVisibility(const StickerConfig &config);
     void removeStaleInstances(TemplateState &state, const QSet<WindowHandle> &aliveHandles);
     void removeAllInstances(TemplateState &state);
@@ -65,7 +93,15 @@ private:
     WindowAttachmentService m_attachmentService;
     WindowRecognitionService m_windowService;
     QTimer *m_timer;
+    WindowEventSource *m_nativeEvents;
+    WindowEventSource *m_events;
+    QSet<WindowHandle> m_trackedHandles;      // 单目标跟随的窗口，移动时只刷新对应模板
+    QSet<WindowHandle> m_enumeratedHandles;   // 批量跟随实例的窗口，移动时只更新对应实例，显隐/销毁时整体重新枚举
+    QSet<WindowHandle> m_dirtyHandles;
+    bool m_dirtyAll;
+    FollowWindowClassifier m_classifier;
     QHash<QString, TemplateState> m_templates;
+    RefreshStats m_refreshStats;
     bool m_refreshing;
 };
 
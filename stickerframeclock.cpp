@@ -0,0 +1,117 @@
+#include "stickerframeclock.h"
+#include <QCoreApplication>
+#include <QList>
+
+namespace {
+const int kMinIntervalMs = 8;
+}
+
+StickerFrameClock *StickerFrameClock::instance()
+{
+    static StickerFrameClock *s_instance = new StickerFrameClock(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerFrameClock::StickerFrameClock(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &StickerFrameClock::onTick);
+    m_clock.start();
+}
+
+void StickerFrameClock::subscribe(const QObject *client, TickCallback callback, int intervalMs)
+{
+    if (!client) {
+        return;
+    }
+    Subscription &subscription = m_subscriptions[client];
+    subscription.callback = std::move(callback);
+    subscription.intervalMs = qMax(kMinIntervalMs, intervalMs);
+    updateTimer();
+}
+
+void StickerFrameClock::unsubscribe(const QObject *client)
+{
+    if (m_subscriptions.remove(client) > 0) {
+        updateTimer();
+    }
+}
+
+void StickerFrameClock::setActive(const QObject *client, bool active)
+{
+    auto it = m_subscriptions.find(client);
+    if (it == m_subscriptions.end() || it->active == active) {
+        return;
+    }
+    it->active = active;
+    it->lastTickMs = m_clock.elapsed();
+    updateTimer();
+}
+
+void StickerFrameClock::setInterval(const QObject *client, int intervalMs)
+{
+    auto it = m_subscriptions.find(client);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    it->intervalMs = qMax(kMinIntervalMs, intervalMs);
+    updateTimer();
+}
+
+bool StickerFrameClock::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+int StickerFrameClock::activeCount() const
+{
+    int count = 0;
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        if (it->active) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void StickerFrameClock::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+    // 回调中可能取消订阅，先拷贝键
+    const QList<const QObject*> clients = m_subscriptions.keys();
+    for (const QObject *client : clients) {
+        auto it = m_subscriptions.find(client);
+        if (it == m_subscriptions.end() || !it->active) {
+            continue;
+        }
+        const qint64 elapsed = now - it->lastTickMs;
+        // 允许提前半个定时器粒度触发，避免间隔较长的订阅被推迟一整拍
+        if (elapsed + m_timer.interval() / 2 < it->intervalMs) {
+            continue;
+        }
+        it->lastTickMs = now;
+        const TickCallback callback = it->callback;
+        if (callback) {
+            callback(elapsed);
+        }
+    }
+}
+
+void StickerFrameClock::updateTimer()
+{
+    int interval = 0;
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        if (it->active && (interval == 0 || it->intervalMs < interval)) {
+            interval = it->intervalMs;
+        }
+    }
+
+    if (interval == 0) {
+        m_timer.stop();
+        return;
+    }
+    if (m_timer.interval() != interval || !m_timer.isActive()) {
+        m_timer.start(interval);
+    }
+}
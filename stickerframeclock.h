@@ -0,0 +1,50 @@
+#ifndef STICKERFRAMECLOCK_H
+#define STICKERFRAMECLOCK_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+
+// 全局帧时钟：所有贴纸动画共用一个定时器，只驱动“已订阅且正在动画、可见”的贴纸，
+// 没有活动订阅时定时器完全停止
+class StickerFrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    // elapsedMs 为距该订阅上一次 tick 的毫秒数
+    using TickCallback = std::function<void(qint64 elapsedMs)>;
+
+    static StickerFrameClock *instance();
+
+    void subscribe(const QObject *client, TickCallback callback, int intervalMs = 50);
+    void unsubscribe(const QObject *client);
+    void setActive(const QObject *client, bool active);
+    void setInterval(const QObject *client, int intervalMs);
+
+    bool isRunning() const;
+    int activeCount() const;
+
+private slots:
+    void onTick();
+
+private:
+    explicit StickerFrameClock(QObject *parent = nullptr);
+
+    struct Subscription {
+        TickCallback callback;
+        int intervalMs = 50;
+        bool active = false;
+        qint64 lastTickMs = 0;
+    };
+
+    void updateTimer();
+
+    QHash<const QObject*, Subscription> m_subscriptions;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif // STICKERFRAMECLOCK_H
@@ -0,0 +1,169 @@
+#include "stickergeometrybatch.h"
+#include "stickerwidget.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+void StickerGeometryBatch::RecordingBackend::commit(const QList<Entry> &entries)
+{
+    m_batchSizes.append(entries.size());
+    m_lastBatch = entries;
+}
+
+QList<int> StickerGeometryBatch::RecordingBackend::batchSizes() const
+{
+    return m_batchSizes;
+}
+
+QList<StickerGeometryBatch::Entry> StickerGeometryBatch::RecordingBackend::lastBatch() const
+{
+    return m_lastBatch;
+}
+
+void StickerGeometryBatch::RecordingBackend::reset()
+{
+    m_batchSizes.clear();
+    m_lastBatch.clear();
+}
+
+StickerGeometryBatch::StickerGeometryBatch()
+    : m_depth(0)
+    , m_backend(nullptr)
+{
+}
+
+void StickerGeometryBatch::setBackend(Backend *backend)
+{
+    m_backend = backend;
+}
+
+void StickerGeometryBatch::begin()
+{
+    ++m_depth;
+}
+
+void StickerGeometryBatch::commit()
+{
+    if (m_depth == 0 || --m_depth > 0) {
+        return;
+    }
+    if (m_entries.isEmpty()) {
+        return;
+    }
+
+    const QList<Entry> entries = m_entries;
+    m_entries.clear();
+    m_index.clear();
+
+    bool applied = false;
+    if (m_backend) {
+        m_backend->commit(entries);
+    } else {
+        applied = commitNative(entries);
+    }
+
+    // 原生窗口已到位时贴纸只同步 Qt 侧的缓存几何，不再二次下发移动
+    for (const Entry &entry : entries) {
+        if (entry.sticker) {
+            entry.sticker->commitBatchedGeometry(applied);
+        }
+    }
+}
+
+bool StickerGeometryBatch::isOpen() const
+{
+    return m_depth > 0;
+}
+
+int StickerGeometryBatch::pendingCount() const
+{
+    return m_entries.size();
+}
+
+void StickerGeometryBatch::setPosition(WindowHandle handle, const QPoint &position, StickerWidget *sticker)
+{
+    if (handle == 0) {
+        return;
+    }
+    Entry &entry = entryFor(handle);
+    entry.hasPosition = true;
+    entry.position = position;
+    entry.sticker = sticker;
+}
+
+void StickerGeometryBatch::setZOrder(WindowHandle handle, WindowHandle insertAfter)
+{
+    if (handle == 0) {
+        return;
+    }
+    Entry &entry = entryFor(handle);
+    entry.hasZOrder = true;
+    entry.insertAfter = insertAfter;
+}
+
+StickerGeometryBatch::Entry &StickerGeometryBatch::entryFor(WindowHandle handle)
+{
+    auto it = m_index.constFind(handle);
+    if (it != m_index.constEnd()) {
+        return m_entries[it.value()];
+    }
+    Entry entry;
+    entry.handle = handle;
+    m_index.insert(handle, m_entries.size());
+    m_entries.append(entry);
+    return m_entries.last();
+}
+
+bool StickerGeometryBatch::commitNative(const QList<Entry> &entries)
+{
+#ifdef Q_OS_WIN
+    auto flagsFor = [](const Entry &entry) {
+        UINT flags = SWP_NOACTIVATE | SWP_NOSIZE;
+        if (!entry.hasPosition) {
+            flags |= SWP_NOMOVE;
+        }
+        if (!entry.hasZOrder) {
+            flags |= SWP_NOZORDER;
+        }
+        return flags;
+    };
+
+    QList<Entry> valid;
+    for (const Entry &entry : entries) {
+        if (IsWindow(reinterpret_cast<HWND>(entry.handle))) {
+            valid.append(entry);
+        }
+    }
+    if (valid.isEmpty()) {
+        return true;
+    }
+
+    HDWP hdwp = BeginDeferWindowPos(valid.size());
+    for (const Entry &entry : valid) {
+        if (!hdwp) {
+            break;
+        }
+        hdwp = DeferWindowPos(hdwp, reinterpret_cast<HWND>(entry.handle),
+                              reinterpret_cast<HWND>(entry.insertAfter),
+                              entry.position.x(), entry.position.y(), 0, 0,
+                              flagsFor(entry));
+    }
+    if (hdwp && EndDeferWindowPos(hdwp)) {
+        return true;
+    }
+
+    // 延迟句柄失败时之前累积的条目已丢弃，逐个补交
+    for (const Entry &entry : valid) {
+        SetWindowPos(reinterpret_cast<HWND>(entry.handle),
+                     reinterpret_cast<HWND>(entry.insertAfter),
+                     entry.position.x(), entry.position.y(), 0, 0,
+                     flagsFor(entry));
+    }
+    return true;
+#else
+    // 贴纸随后在 commitBatchedGeometry 中经 Qt 下发，X11 上同一轮事件循环只刷新一次连接
+    Q_UNUSED(entries)
+    return false;
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef STICKERGEOMETRYBATCH_H
+#define STICKERGEOMETRYBATCH_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QPoint>
+#include "windowrecognitionservice.h"
+
+class StickerWidget;
+
+// 一次刷新内多张贴纸的位置/层级变化统一提交：
+// Windows 上用 BeginDeferWindowPos/EndDeferWindowPos 一次生效；
+// 其他平台在提交时依次同步到 Qt，由窗口系统连接在同一轮事件循环里合并发出
+class StickerGeometryBatch
+{
+public:
+    struct Entry {
+        WindowHandle handle = 0;
+        bool hasPosition = false;
+        QPoint position;
+        bool hasZOrder = false;
+        WindowHandle insertAfter = 0;   // hasZOrder 时有效，放在该窗口之后
+        QPointer<StickerWidget> sticker;
+    };
+
+    // 提交后端，默认直接操作原生窗口
+    class Backend
+    {
+    public:
+        virtual ~Backend() {}
+        virtual void commit(const QList<Entry> &entries) = 0;
+    };
+
+    // 只记录每批的条目，不触碰原生窗口，用于基准与回归检查
+    class RecordingBackend : public Backend
+    {
+    public:
+        void commit(const QList<Entry> &entries) override;
+        QList<int> batchSizes() const;
+        QList<Entry> lastBatch() const;
+        void reset();
+
+    private:
+        QList<int> m_batchSizes;
+        QList<Entry> m_lastBatch;
+    };
+
+    StickerGeometryBatch();
+
+    // 不接管所有权，传 nullptr 恢复原生后端
+    void setBackend(Backend *backend);
+
+    // 可嵌套，最外层 commit 时才真正提交
+    void begin();
+    void commit();
+    bool isOpen() const;
+    int pendingCount() const;
+
+    // 同一窗口多次变化合并为一条，后写入的覆盖之前的。
+    // 尺寸不进批次：固定尺寸窗口的最小/最大尺寸约束会把延迟的缩放夹回原尺寸
+    void setPosition(WindowHandle handle, const QPoint &position, StickerWidget *sticker);
+    void setZOrder(WindowHandle handle, WindowHandle insertAfter);
+
+private:
+    Entry &entryFor(WindowHandle handle);
+    // 返回原生窗口是否已经到位；不支持的平台返回 false，由贴纸经 Qt 下发
+    static bool commitNative(const QList<Entry> &entries);
+
+    int m_depth;
+    QList<Entry> m_entries;
+    QHash<WindowHandle, int> m_index;
+    Backend *m_backend;
+};
+
+#endif // STICKERGEOMETRYBATCH_H
@@ -1,40 +1,200 @@
 #include "stickerimage.h"
-#include <QImage>
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImageReader>
 #include <QPainter>
 #include <QRadialGradient>
+#include <QScreen>
 #include <QtGlobal>
+#include <QtMath>
+#include <QDebug>
+
+namespace {
+const qreal kMinRasterScale = 1.0;
+const qreal kMaxRasterScale = 4.0;
+const int kSourceCacheKb = 64 * 1024;
+
+// 源图只保留到当前所有屏幕中最大缩放比所需的分辨率
+qreal maxScreenScale()
+{
+    qreal scale = kMinRasterScale;
+    const QList<QScreen*> screens = QGuiApplication::screens();
+    for (QScreen *screen : screens) {
+        if (screen) {
+            scale = qMax(scale, screen->devicePixelRatio());
+        }
+    }
+    return qMin(scale, kMaxRasterScale);
+}
+
+qint64 imageBytes(const QImage &image)
+{
+    return qint64(image.bytesPerLine()) * image.height();
+}
+
+// 被回收贴纸的源图缓存，按 KB 计成本；重新显示时优先从这里恢复，避免重新解码
+QCache<QString, QImage> &sourceCache()
+{
+    static QCache<QString, QImage> cache(kSourceCacheKb);
+    return cache;
+}
+
+QString sourceCacheKey(const QString &imagePath)
+{
+    const QFileInfo info(imagePath);
+    return info.absoluteFilePath() + QLatin1Char('@')
+        + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+}
 
 StickerImage::StickerImage(int maxWindowSize)
-    : m_maxWindowSize(maxWindowSize)
+    : m_defaultSize(0)
+    , m_maxWindowSize(maxWindowSize)
+    , m_generation(0)
+    , m_released(false)
+    , m_sourceCap(0.0)
 {
 }
 
 bool StickerImage::loadFromPath(const QString &imagePath)
 {
-    QPixmap originalPixmap(imagePath);
-    if (originalPixmap.isNull()) {
+    QSize originalSize;
+    const qreal scale = maxScreenScale();
+    const QImage image = decodeSource(imagePath, scale, &originalSize);
+    if (image.isNull()) {
         return false;
     }
 
-    m_pixmap = scalePixmapKeepRatio(originalPixmap, m_maxWindowSize);
-    m_contentRect = computeContentRect(m_pixmap);
+    m_source = image;
+    m_sourceCap = (originalSize.isValid() && image.width() < originalSize.width()) ? scale : 0.0;
+    m_path = imagePath;
+    m_released = false;
+    m_logicalSize = fitLogicalSize(originalSize.isValid() ? originalSize : image.size(), m_maxWindowSize);
+    m_defaultSize = 0;
+    m_rasters.clear();
+
+    const QRect sourceContent = computeContentRect(m_source);
+    const qreal sx = qreal(m_logicalSize.width()) / m_source.width();
+    const qreal sy = qreal(m_logicalSize.height()) / m_source.height();
+    m_contentRect = QRectF(sourceContent.x() * sx, sourceContent.y() * sy,
+                           sourceContent.width() * sx, sourceContent.height() * sy).toAlignedRect()
+        & QRect(QPoint(0, 0), m_logicalSize);
+    ++m_generation;
     return true;
 }
 
 void StickerImage::createDefault(int size)
 {
-    m_pixmap = createDefaultPixmap(size);
-    m_contentRect = computeContentRect(m_pixmap);
+    m_source = QImage();
+    m_path.clear();
+    m_released = false;
+    m_sourceCap = 0.0;
+    m_defaultSize = size;
+    m_logicalSize = QSize(size, size);
+    m_rasters.clear();
+    m_contentRect = computeContentRect(createDefaultPixmap(size, 1.0).toImage());
+    ++m_generation;
+}
+
+void StickerImage::clear()
+{
+    m_source = QImage();
+    m_path.clear();
+    m_released = false;
+    m_sourceCap = 0.0;
+    m_defaultSize = 0;
+    m_logicalSize = QSize();
+    m_contentRect = QRect();
+    m_rasters.clear();
+    ++m_generation;
 }
 
-const QPixmap &StickerImage::pixmap() const
+bool StickerImage::setFrame(const QImage &frame, qreal devicePixelRatio)
 {
-    return m_pixmap;
+    if (frame.isNull()) {
+        return false;
+    }
+
+    const qreal dpr = qBound(kMinRasterScale, devicePixelRatio, kMaxRasterScale);
+    const QSize logicalSize = fitLogicalSize(QSize(qMax(1, qRound(frame.width() / dpr)),
+                                                   qMax(1, qRound(frame.height() / dpr))),
+                                             m_maxWindowSize);
+    const bool sizeChanged = logicalSize != m_logicalSize;
+    m_source = frame;
+    m_path.clear();
+    m_released = false;
+    m_sourceCap = 0.0;
+    m_defaultSize = 0;
+    m_rasters.clear();
+    if (sizeChanged) {
+        m_logicalSize = logicalSize;
+        // 视频帧按不透明整帧处理，不逐帧扫描内容区域
+        m_contentRect = QRect(QPoint(0, 0), m_logicalSize);
+    }
+    ++m_generation;
+    return sizeChanged;
+}
+
+QPixmap StickerImage::pixmap(qreal devicePixelRatio) const
+{
+    if (isNull()) {
+        return QPixmap();
+    }
+
+    const int key = rasterKey(devicePixelRatio);
+    ensureResolution(key);
+    auto it = m_rasters.constFind(key);
+    if (it != m_rasters.constEnd()) {
+        return it.value();
+    }
+
+    ensureSource();
+    QPixmap raster = createRaster(key);
+    m_rasters.insert(key, raster);
+    pruneRasters(m_rasters, key);
+    return raster;
+}
+
+void StickerImage::release()
+{
+    if (m_released || isNull()) {
+        return;
+    }
+
+    if (!m_source.isNull() && !m_path.isEmpty()) {
+        const int costKb = int(qMax<qint64>(1, imageBytes(m_source) / 1024));
+        sourceCache().insert(sourceCacheKey(m_path), new QImage(m_source), costKb);
+    }
+    m_source = QImage();
+    m_rasters.clear();
+    m_released = true;
+}
+
+bool StickerImage::isReleased() const
+{
+    return m_released;
+}
+
+qint64 StickerImage::residentBytes() const
+{
+    qint64 bytes = imageBytes(m_source);
+    for (auto it = m_rasters.constBegin(); it != m_rasters.constEnd(); ++it) {
+        const QPixmap &raster = it.value();
+        bytes += qint64(raster.width()) * raster.height() * (raster.depth() / 8);
+    }
+    return bytes;
 }
 
 bool StickerImage::isNull() const
 {
-    return m_pixmap.isNull();
+    return m_logicalSize.isEmpty();
+}
+
+QSize StickerImage::logicalSize() const
+{
+    return m_logicalSize;
 }
 
 QRect StickerImage::contentRect() const
@@ -47,44 +207,79 @@ QSize StickerImage::baseSize() const
     if (m_contentRect.isValid()) {
         return m_contentRect.size();
     }
-    return m_pixmap.size();
+    return m_logicalSize;
 }
 
-QRectF StickerImage::sourceRect() const
+QRectF StickerImage::sourceRect(qreal devicePixelRatio) const
 {
-    if (m_pixmap.isNull()) {
+    if (isNull()) {
         return QRectF();
     }
-    return m_contentRect.isValid() ? QRectF(m_contentRect) : QRectF(m_pixmap.rect());
+
+    const QSize physical = physicalSize(m_logicalSize, rasterKey(devicePixelRatio));
+    const qreal sx = qreal(physical.width()) / m_logicalSize.width();
+    const qreal sy = qreal(physical.height()) / m_logicalSize.height();
+    const QRect logical = m_contentRect.isValid() ? m_contentRect : QRect(QPoint(0, 0), m_logicalSize);
+    return QRectF(logical.x() * sx, logical.y() * sy, logical.width() * sx, logical.height() * sy);
 }
 
-QPixmap StickerImage::scalePixmapKeepRatio(const QPixmap &pixmap, int maxSize) const
+quint64 StickerImage::generation() const
 {
-    if (pixmap.isNull()) {
-        return QPixmap();
+    return m_generation;
+}
+
+int StickerImage::rasterKey(qreal devicePixelRatio)
+{
+    return qRound(qBound(kMinRasterScale, devicePixelRatio, kMaxRasterScale) * 100.0);
+}
+
+qreal StickerImage::rasterScale(int key)
+{
+    return key / 100.0;
+}
+
+QSize StickerImage::physicalSize(const QSize &logicalSize, int key)
+{
+    const qreal scale = rasterScale(key);
+    return QSize(qMax(1, qRound(logicalSize.width() * scale)),
+                 qMax(1, qRound(logicalSize.height() * scale)));
+}
+
+void StickerImage::pruneRasters(QHash<int, QPixmap> &rasters, int currentKey)
+{
+    if (rasters.size() <= 1) {
+        return;
     }
+    const int maxKey = rasterKey(maxScreenScale());
+    for (auto it = rasters.begin(); it != rasters.end(); ) {
+        if (it.key() == currentKey || it.key() == maxKey) {
+            ++it;
+        } else {
+            it = rasters.erase(it);
+        }
+    }
+}
 
-    int originalWidth = pixmap.width();
-    int originalHeight = pixmap.height();
+QSize StickerImage::fitLogicalSize(const QSize &sourceSize, int maxSize) const
+{
+    int originalWidth = sourceSize.width();
+    int originalHeight = sourceSize.height();
 
     if (originalWidth <= maxSize && originalHeight <= maxSize) {
-        return pixmap;
+        return sourceSize;
     }
 
     double scale = qMin(double(maxSize) / originalWidth, double(maxSize) / originalHeight);
-    int newWidth = int(originalWidth * scale);
-    int newHeight = int(originalHeight * scale);
-
-    return pixmap.scaled(newWidth, newHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    return QSize(qMax(1, int(originalWidth * scale)), qMax(1, int(originalHeight * scale)));
 }
 
-QRect StickerImage::computeContentRect(const QPixmap &pixmap) const
+QRect StickerImage::computeContentRect(const QImage &source) const
 {
-    if (pixmap.isNull()) {
+    if (source.isNull()) {
         return QRect();
     }
 
-    QImage image = pixmap.toImage().convertToFormat(QImage::Format_ARGB32);
+    QImage image = source.convertToFormat(QImage::Format_ARGB32);
     int minX = image.width();
     int minY = image.height();
     int maxX = -1;
@@ -109,9 +304,91 @@ QRect StickerImage::computeContentRect(const QPixmap &pixmap) const
     return QRect(QPoint(minX, minY), QPoint(maxX, maxY));
 }
 
-QPixmap StickerImage::createDefaultPixmap(int size) const
+void StickerImage::ensureSource() const
+{
+    if (!m_released) {
+        return;
+    }
+    m_released = false;
+    if (m_path.isEmpty()) {
+        return;
+    }
+
+    QImage *cached = sourceCache().take(sourceCacheKey(m_path));
+    if (cached) {
+        m_source = *cached;
+        delete cached;
+        return;
+    }
+
+    qDebug() << "贴纸源图缓存未命中，重新解码:" << m_path;
+    m_source = decodeSource(m_path, m_sourceCap > 0 ? m_sourceCap : maxScreenScale(), nullptr);
+}
+
+// 源图截断时的缩放比低于要取的栅格（新接入或调高缩放比的屏幕）时，按现在的最大缩放比重新解码；
+// 之前按旧源图放大的高 DPR 栅格一并作废，代数变化让效果阶段重建
+void StickerImage::ensureResolution(int key) const
+{
+    const qreal scale = rasterScale(key);
+    if (m_sourceCap <= 0 || m_path.isEmpty() || scale <= m_sourceCap + 0.01) {
+        return;
+    }
+    const qreal target = qMax(scale, maxScreenScale());
+    QSize originalSize;
+    const QImage image = decodeSource(m_path, target, &originalSize);
+    if (image.isNull()) {
+        return;
+    }
+    qDebug() << "屏幕缩放比提高，重新解码贴纸源图:" << m_path << m_sourceCap << "->" << target;
+    m_source = image;
+    m_released = false;
+    m_sourceCap = (originalSize.isValid() && image.width() < originalSize.width()) ? target : 0.0;
+    m_rasters.clear();
+    ++m_generation;
+}
+
+QImage StickerImage::decodeSource(const QString &imagePath, qreal scale, QSize *originalSize) const
+{
+    QImageReader reader(imagePath);
+    const QSize sourceSize = reader.size();
+    if (originalSize) {
+        *originalSize = sourceSize;
+    }
+    const int maxSourceSize = qCeil(m_maxWindowSize * scale);
+    if (sourceSize.isValid()
+        && (sourceSize.width() > maxSourceSize || sourceSize.height() > maxSourceSize)) {
+        reader.setScaledSize(sourceSize.scaled(maxSourceSize, maxSourceSize, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return QImage();
+    }
+    if (image.width() > maxSourceSize || image.height() > maxSourceSize) {
+        image = image.scaled(maxSourceSize, maxSourceSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QPixmap StickerImage::createRaster(int key) const
+{
+    const qreal scale = rasterScale(key);
+    if (m_defaultSize > 0) {
+        return createDefaultPixmap(m_defaultSize, scale);
+    }
+
+    const QSize physical = physicalSize(m_logicalSize, key);
+    QPixmap raster = QPixmap::fromImage(m_source.size() == physical
+        ? m_source
+        : m_source.scaled(physical, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    raster.setDevicePixelRatio(scale);
+    return raster;
+}
+
+QPixmap StickerImage::createDefaultPixmap(int size, qreal devicePixelRatio) const
 {
-    QPixmap pixmap(size, size);
+    QPixmap pixmap(physicalSize(QSize(size, size), rasterKey(devicePixelRatio)));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
     pixmap.fill(Qt::transparent);
 
     QPainter painter(&pixmap);
@@ -1,11 +1,16 @@
 #ifndef STICKERIMAGE_H
 #define STICKERIMAGE_H
 
+#include <QHash>
+#include <QImage>
 #include <QPixmap>
 #include <QRect>
 #include <QSize>
 #include <QString>
 
+// 贴纸图像：解码一次保留源图，按设备像素比惰性生成并缓存栅格（只留当前与最大屏幕缩放比两份），
+// 逻辑尺寸与内容区域与 DPR 无关。源图按解码时的最大屏幕缩放比截断，
+// 之后接入更高缩放比的屏幕、取更高 DPR 的栅格时重新解码
 class StickerImage
 {
 public:
@@ -13,21 +18,48 @@ public:
 
     bool loadFromPath(const QString &imagePath);
     void createDefault(int size = 200);
+    void clear();
+    // 视频帧：frame 已按 devicePixelRatio 缩放到物理尺寸；逻辑尺寸变化时返回 true
+    bool setFrame(const QImage &frame, qreal devicePixelRatio);
 
-    const QPixmap &pixmap() const;
+    QPixmap pixmap(qreal devicePixelRatio = 1.0) const;
     bool isNull() const;
+    QSize logicalSize() const;
     QRect contentRect() const;
     QSize baseSize() const;
-    QRectF sourceRect() const;
+    QRectF sourceRect(qreal devicePixelRatio = 1.0) const;
+    quint64 generation() const;
+
+    // 内存预算回收：丢弃栅格并把源图移入共享缓存，下次取栅格时再恢复
+    void release();
+    bool isReleased() const;
+    qint64 residentBytes() const;
+
+    static int rasterKey(qreal devicePixelRatio);
+    static qreal rasterScale(int key);
+    static QSize physicalSize(const QSize &logicalSize, int key);
+    // 按 DPR 缓存的栅格只保留刚用到的与当前所有屏幕中最大缩放比的两份
+    static void pruneRasters(QHash<int, QPixmap> &rasters, int currentKey);
 
 private:
-    QPixmap scalePixmapKeepRatio(const QPixmap &pixmap, int maxSize) const;
-    QRect computeContentRect(const QPixmap &pixmap) const;
-    QPixmap createDefaultPixmap(int size) const;
+    QSize fitLogicalSize(const QSize &sourceSize, int maxSize) const;
+    QRect computeContentRect(const QImage &image) const;
+    QPixmap createRaster(int key) const;
+    void ensureSource() const;
+    void ensureResolution(int key) const;
+    QImage decodeSource(const QString &imagePath, qreal scale, QSize *originalSize) const;
+    QPixmap createDefaultPixmap(int size, qreal devicePixelRatio) const;
 
-    QPixmap m_pixmap;
+    mutable QImage m_source;
+    QString m_path;
+    QSize m_logicalSize;
     QRect m_contentRect;
+    int m_defaultSize;
     int m_maxWindowSize;
+    mutable quint64 m_generation;
+    mutable bool m_released;
+    mutable qreal m_sourceCap;          // 源图被截断到的缩放比，0 表示已是原始分辨率
+    mutable QHash<int, QPixmap> m_rasters;
 };
 
 #endif // STICKERIMAGE_H
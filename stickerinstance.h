@@ -2,7 +2,7 @@
 #define STICKERINSTANCE_H
 
 #include <QString>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class StickerWidget;
 
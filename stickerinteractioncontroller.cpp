@@ -57,6 +57,9 @@ bool StickerInteractionController::handleMouseMove(QMouseEvent *event, StickerCo
         double angle = angleFromCenter(event->pos(), rect);
         double delta = qRadiansToDegrees(angle - m_rotateStartAngle);
         config.transform.rotation = m_rotateStartRotation + delta;
+        if (m_callbacks.beginInteractiveChange) {
+            m_callbacks.beginInteractiveChange();
+        }
         if (m_callbacks.updateTransformLayout) {
             m_callbacks.updateTransformLayout();
         }
@@ -125,6 +128,9 @@ bool StickerInteractionController::handleWheel(QWheelEvent *event, StickerConfig
         config.transform.scaleY = qBound(0.1, config.transform.scaleY * factor, 5.0);
     }
 
+    if (m_callbacks.beginInteractiveChange) {
+        m_callbacks.beginInteractiveChange();
+    }
     if (m_callbacks.updateTransformLayout) {
         m_callbacks.updateTransformLayout();
     }
@@ -6,7 +6,7 @@
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <functional>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class StickerInteractionController
 {
@@ -15,6 +15,8 @@ public:
         std::function<QRect()> widgetRect;
         std::function<QRect()> frameGeometry;
         std::function<void(const QPoint &pos)> moveWindow;
+        // 旋转/缩放手势的每次输入前调用，宿主据此进入低保真绘制
+        std::function<void()> beginInteractiveChange;
         std::function<void()> updateTransformLayout;
         std::function<void()> applyMask;
         std::function<void()> requestUpdate;
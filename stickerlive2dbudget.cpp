@@ -0,0 +1,133 @@
+#include "stickerlive2dbudget.h"
+#include <QDebug>
+
+namespace {
+const int kDefaultMaxAnimated = 4;
+}
+
+StickerLive2DBudget &StickerLive2DBudget::instance()
+{
+    static StickerLive2DBudget s_instance;
+    return s_instance;
+}
+
+StickerLive2DBudget::StickerLive2DBudget()
+    : m_maxAnimated(kDefaultMaxAnimated)
+    , m_enforcing(false)
+{
+}
+
+void StickerLive2DBudget::setMaxAnimated(int count)
+{
+    m_maxAnimated = qMax(0, count);
+    enforce();
+}
+
+int StickerLive2DBudget::maxAnimated() const
+{
+    return m_maxAnimated;
+}
+
+void StickerLive2DBudget::registerClient(const void *client, Callbacks callbacks)
+{
+    if (!client) {
+        return;
+    }
+    Client entry;
+    entry.callbacks = std::move(callbacks);
+    m_clients.insert(client, entry);
+    m_recency.removeAll(client);
+    m_recency.append(client);
+}
+
+void StickerLive2DBudget::unregisterClient(const void *client)
+{
+    const bool wasAnimating = m_clients.value(client).animating;
+    m_clients.remove(client);
+    m_recency.removeAll(client);
+    if (wasAnimating) {
+        enforce();
+    }
+}
+
+void StickerLive2DBudget::setAnimating(const void *client, bool animating)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || it.value().animating == animating) {
+        return;
+    }
+    it.value().animating = animating;
+    enforce();
+}
+
+void StickerLive2DBudget::noteInteraction(const void *client)
+{
+    if (!m_clients.contains(client)) {
+        return;
+    }
+    if (m_recency.isEmpty() || m_recency.last() != client) {
+        m_recency.removeAll(client);
+        m_recency.append(client);
+    }
+    enforce();
+}
+
+void StickerLive2DBudget::enforce()
+{
+    // 降级/恢复回调会回头更新 animating，避免重入
+    if (m_enforcing) {
+        return;
+    }
+    m_enforcing = true;
+
+    // 从最近交互的一端开始保留，超出上限的依次降级
+    int live = 0;
+    const QList<const void*> order = m_recency;
+    for (int i = order.size() - 1; i >= 0; --i) {
+        auto it = m_clients.constFind(order.at(i));
+        if (it == m_clients.constEnd() || !it.value().animating) {
+            continue;
+        }
+        const Callbacks &callbacks = it.value().callbacks;
+        const bool demoted = isDemoted(it.value());
+        if (m_maxAnimated <= 0 || live < m_maxAnimated) {
+            ++live;
+            if (demoted && callbacks.promote) {
+                callbacks.promote();
+            }
+        } else if (!demoted && callbacks.demote) {
+            callbacks.demote();
+            qDebug() << "Live2D 动画预算已满，降级为静态快照:"
+                     << (callbacks.stickerId ? callbacks.stickerId() : QString());
+        }
+    }
+
+    m_enforcing = false;
+}
+
+int StickerLive2DBudget::animatingCount() const
+{
+    int count = 0;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it.value().animating && !isDemoted(it.value())) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int StickerLive2DBudget::demotedCount() const
+{
+    int count = 0;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (isDemoted(it.value())) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool StickerLive2DBudget::isDemoted(const Client &client) const
+{
+    return client.callbacks.isDemoted && client.callbacks.isDemoted();
+}
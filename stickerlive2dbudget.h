@@ -0,0 +1,55 @@
+#ifndef STICKERLIVE2DBUDGET_H
+#define STICKERLIVE2DBUDGET_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <functional>
+
+// 全局 Live2D 动画预算：同时渲染的模型数超出上限时，把最久未交互的降级为静态快照，
+// 悬停/点击时立即恢复
+class StickerLive2DBudget
+{
+public:
+    struct Callbacks {
+        std::function<QString()> stickerId;
+        std::function<bool()> isDemoted;
+        std::function<void()> demote;
+        std::function<void()> promote;
+    };
+
+    static StickerLive2DBudget &instance();
+
+    // 0 表示不限
+    void setMaxAnimated(int count);
+    int maxAnimated() const;
+
+    void registerClient(const void *client, Callbacks callbacks);
+    void unregisterClient(const void *client);
+
+    // 可见、未被遮挡的 Live2D 贴纸才参与预算
+    void setAnimating(const void *client, bool animating);
+    // 移到最近交互一端并重新分配，被降级的立即恢复
+    void noteInteraction(const void *client);
+    void enforce();
+
+    int animatingCount() const;
+    int demotedCount() const;
+
+private:
+    StickerLive2DBudget();
+
+    struct Client {
+        Callbacks callbacks;
+        bool animating = false;
+    };
+
+    bool isDemoted(const Client &client) const;
+
+    QHash<const void*, Client> m_clients;
+    QList<const void*> m_recency;   // 队尾为最近交互
+    int m_maxAnimated;
+    bool m_enforcing;
+};
+
+#endif // STICKERLIVE2DBUDGET_H
@@ -0,0 +1,710 @@
+#include "stickerlive2dhost.h"
+#include <QApplication>
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLWidget>
+#include <QPainter>
+#include <QWidget>
+#include <QWindow>
+#include <QtMath>
+#include "stickeralphakernels.h"
+#include "stickercursorpoller.h"
+#include "stickerlive2dbudget.h"
+#include "stickerlive2dloader.h"
+#include "stickerlive2dmanifest.h"
+#include "stickerlive2dmodelcache.h"
+
+#ifndef STICKER_NO_LIVE2D
+#include "live2dwidget.h"
+#endif
+
+namespace {
+const int kActivityCheckMs = 500;
+const int kPosterDelayMs = 4000;
+// 包围盒按 250ms 时间片记录，取最近 2 秒的并集作为包络；窗口调整至多约每 300ms 一次
+const int kEnvelopeSlotMs = 250;
+const int kEnvelopeSlots = 8;
+const int kFitIntervalMs = 300;
+const double kShrinkRatio = 0.1;
+const double kBoundsMarginRatio = 0.02;
+const double kBoundsStableRatio = 0.05;
+// 命中位图：每 8 个逻辑像素取一格，光标靠近时由全局轮询唤醒，每 250ms 重新采样
+const int kHitCellPx = 8;
+const int kHitSampleMs = 250;
+const int kHitMarginPx = 48;
+const int kHitAlpha = 16;
+
+bool live2dEqual(const Live2DConfig &a, const Live2DConfig &b)
+{
+    return a.modelJsonPath == b.modelJsonPath
+        && a.runtimeRoot == b.runtimeRoot
+        && a.shaderProfile == b.shaderProfile
+        && a.baseSize == b.baseSize;
+}
+}
+
+StickerLive2DHost::StickerLive2DHost(QWidget *owner, const StickerConfig *config, Callbacks callbacks)
+    : QObject(owner)
+    , m_owner(owner)
+    , m_config(config)
+    , m_callbacks(std::move(callbacks))
+    , m_widget(nullptr)
+    , m_boundsOffset(0, 0)
+    , m_hasBounds(false)
+    , m_throttle()
+    , m_demoted(false)
+    , m_pending(false)
+    , m_configApplied(false)
+    , m_textureBytes(0)
+    , m_hitTesting(false)
+    , m_inputTransparent(false)
+{
+    // 包围盒变化限频合并后再调整窗口
+    m_fitTimer.setSingleShot(true);
+    connect(&m_fitTimer, &QTimer::timeout, this, &StickerLive2DHost::applyFit);
+
+    // 可见期间定时复查遮挡，被完全盖住时挂起渲染
+    m_activityTimer.setInterval(kActivityCheckMs);
+    connect(&m_activityTimer, &QTimer::timeout, this, &StickerLive2DHost::updateActivity);
+
+    StickerLive2DBudget::Callbacks budgetCallbacks;
+    budgetCallbacks.stickerId = [this]() { return m_config->id; };
+    budgetCallbacks.isDemoted = [this]() { return m_demoted; };
+    budgetCallbacks.demote = [this]() { demote(); };
+    budgetCallbacks.promote = [this]() { promote(); };
+    StickerLive2DBudget::instance().registerClient(this, std::move(budgetCallbacks));
+}
+
+StickerLive2DHost::~StickerLive2DHost()
+{
+    // 渲染窗口交给模型缓存，同一模型的贴纸再创建时直接取回
+    releaseWidget();
+    StickerCursorPoller::instance()->unregisterClient(this);
+    setInputTransparent(false);
+    StickerLive2DBudget::instance().unregisterClient(this);
+    StickerLive2DLoader::instance()->cancel(this);
+}
+
+void StickerLive2DHost::start()
+{
+    if (!m_widget && (m_pending || StickerLive2DLoader::instance()->isDeferring())) {
+        defer();
+    } else {
+        ensureWidget();
+        applyConfig();
+    }
+}
+
+void StickerLive2DHost::reload(bool modelChanged)
+{
+    if (m_pending) {
+        if (modelChanged) {
+            instantiate();
+        }
+    } else if (!m_callbacks.isEvicted()) {
+        ensureWidget();
+        if (modelChanged) {
+            applyConfig();
+        }
+    }
+}
+
+// 内存回收时销毁渲染窗口，但保留包围盒状态，恢复时窗口位置不跳动
+void StickerLive2DHost::evict()
+{
+    if (m_pending) {
+        // 仍在排队创建时只丢掉海报，恢复时重新读取
+        m_snapshot = QPixmap();
+    }
+    if (!m_widget) {
+        return;
+    }
+    m_throttle.attach(nullptr);
+    m_activityTimer.stop();
+    m_demoted = false;
+    m_snapshot = QPixmap();
+    m_hitMask = QImage();
+    StickerLive2DBudget::instance().setAnimating(this, false);
+    m_widget->hide();
+    disconnect(m_widget, nullptr, this, nullptr);
+    m_widget->deleteLater();
+    m_widget = nullptr;
+    m_configApplied = false;
+}
+
+void StickerLive2DHost::restore()
+{
+    if (m_pending) {
+        m_snapshot = StickerLive2DLoader::loadPoster(m_config->id);
+    } else {
+        ensureWidget();
+        applyConfig();
+    }
+}
+
+void StickerLive2DHost::ensureWidget()
+{
+    if (!m_widget) {
+        const StickerLive2DModelCache::Parked parked =
+            StickerLive2DModelCache::instance()->take(m_config->live2d, m_owner);
+        if (parked.widget) {
+            m_widget = parked.widget;
+            m_appliedConfig = parked.config;
+            m_configApplied = true;
+        } else {
+            m_widget = createWidget();
+            m_configApplied = false;
+        }
+        if (!m_widget) {
+            return;
+        }
+        watchBounds();
+        // 缓存取回的模型不会重新上报包围盒，沿用暂存时的结果
+        if (parked.boundsValid) {
+            onBoundsChanged(parked.bounds, true);
+        }
+        // 模型跑起来之后留一帧作为下次启动的海报；已有同一模型、同一尺寸的海报时不再抓取
+        if (StickerLive2DLoader::posterKey(m_config->id) != posterKey()) {
+            QTimer::singleShot(kPosterDelayMs, this, [this]() { capturePoster(); });
+        }
+    }
+
+    updateGeometry();
+    // 降级期间由贴纸绘制快照，渲染窗口保持隐藏
+    if (!m_demoted) {
+        m_widget->show();
+        m_widget->raise();
+    }
+    m_throttle.attach(m_widget);
+    updateActivity();
+}
+
+QWidget *StickerLive2DHost::createWidget()
+{
+#ifdef STICKER_NO_LIVE2D
+    return nullptr;
+#else
+    Live2DWidget *widget = new Live2DWidget(m_owner);
+    widget->setAttribute(Qt::WA_TranslucentBackground);
+    widget->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    widget->setAutoFillBackground(false);
+    widget->setFocusPolicy(Qt::NoFocus);
+    return widget;
+#endif
+}
+
+void StickerLive2DHost::watchBounds()
+{
+#ifndef STICKER_NO_LIVE2D
+    connect(static_cast<Live2DWidget *>(m_widget), &Live2DWidget::visibleBoundsChanged,
+            this, &StickerLive2DHost::onBoundsChanged, Qt::UniqueConnection);
+#endif
+}
+
+void StickerLive2DHost::releaseWidget()
+{
+    if (m_pending) {
+        m_pending = false;
+        m_snapshot = QPixmap();
+        StickerLive2DLoader::instance()->cancel(this);
+    }
+    if (!m_widget) {
+        return;
+    }
+    m_throttle.attach(nullptr);
+    m_activityTimer.stop();
+    m_demoted = false;
+    m_snapshot = QPixmap();
+    m_hitMask = QImage();
+    StickerLive2DBudget::instance().setAnimating(this, false);
+    disconnect(m_widget, nullptr, this, nullptr);
+    if (m_configApplied) {
+        StickerLive2DModelCache::Parked parked;
+        parked.widget = m_widget;
+        parked.config = m_appliedConfig;
+        parked.bounds = m_boundsPx;
+        parked.boundsValid = m_hasBounds;
+        StickerLive2DModelCache::instance()->park(parked);
+    } else {
+        m_widget->hide();
+        m_widget->deleteLater();
+    }
+    m_widget = nullptr;
+    m_configApplied = false;
+    m_renderSize = QSize();
+    m_boundsSourceSize = QSize();
+    m_boundsPx = QRectF();
+    m_boundsOffset = QPoint(0, 0);
+    m_hasBounds = false;
+    resetEnvelope();
+}
+
+void StickerLive2DHost::applyConfig()
+{
+    if (!m_widget) {
+        return;
+    }
+    // 文件是否齐全和纹理占用取自模型清单，缺文件时不交给渲染窗口加载
+    StickerLive2DManifest manifest;
+    m_textureBytes = 0;
+    if (StickerLive2DManifest::inspect(m_config->live2d.modelJsonPath, manifest)) {
+        if (!manifest.isComplete()) {
+            qDebug() << "Live2D 模型文件不完整，跳过加载:" << m_config->live2d.modelJsonPath
+                     << manifest.missingFiles;
+            return;
+        }
+        m_textureBytes = manifest.textureBytes();
+    }
+    // 从模型缓存取回、配置未变的窗口不再重新加载
+    if (m_configApplied && live2dEqual(m_appliedConfig, m_config->live2d)) {
+        return;
+    }
+#ifndef STICKER_NO_LIVE2D
+    static_cast<Live2DWidget *>(m_widget)->applyConfig(m_config->live2d);
+#endif
+    m_appliedConfig = m_config->live2d;
+    m_configApplied = true;
+}
+
+void StickerLive2DHost::updateGeometry()
+{
+    if (!m_widget) {
+        return;
+    }
+    const QSize renderSize = m_renderSize.isValid() ? m_renderSize : m_owner->size();
+    const QPoint offset = m_hasBounds ? m_boundsOffset : QPoint(0, 0);
+    m_widget->setGeometry(QRect(QPoint(-offset.x(), -offset.y()), renderSize));
+}
+
+// 隐藏、跟随目标最小化、离屏或被完全遮挡时挂起渲染，恢复可见后继续
+void StickerLive2DHost::updateActivity()
+{
+    updateHitTesting();
+    if (!m_widget) {
+        m_activityTimer.stop();
+        return;
+    }
+    const bool shown = m_callbacks.isShown();
+    // 遮挡结果取全局检测的缓存，窗口事件会使其失效
+    const bool animating = shown && !m_callbacks.isSuppressed();
+    // 先恢复渲染再交给预算：超出预算时会立即降级并抓取当前帧
+    m_throttle.setSuspended(!animating || m_demoted);
+    StickerLive2DBudget::instance().setAnimating(this, animating);
+    if (shown) {
+        if (!m_activityTimer.isActive()) {
+            m_activityTimer.start();
+        }
+    } else {
+        m_activityTimer.stop();
+    }
+}
+
+void StickerLive2DHost::noteInteraction()
+{
+    if (m_pending) {
+        StickerLive2DLoader::instance()->instantiateNow(this);
+    }
+    if (m_widget) {
+        m_throttle.noteInteraction();
+        StickerLive2DBudget::instance().noteInteraction(this);
+    }
+}
+
+// 包围盒加一点余量后裁到渲染区域内；变化不足稳定阈值时保持当前窗口，避免来回抖动
+StickerLive2DHost::Fit StickerLive2DHost::fitWindow(const QSize &renderSize, const QSize &currentSize)
+{
+    Fit fit;
+    fit.windowSize = renderSize;
+    fit.oldRenderSize = m_renderSize.isValid() ? m_renderSize : renderSize;
+    fit.oldBoundsOffset = m_boundsOffset;
+    m_renderSize = renderSize;
+    if (m_hasBounds && m_boundsSourceSize == renderSize) {
+        QRectF bounds = m_boundsPx;
+        if (bounds.isValid()) {
+            const double marginX = bounds.width() * kBoundsMarginRatio * 0.5;
+            const double marginY = bounds.height() * kBoundsMarginRatio * 0.5;
+            if (marginX > 0.0 || marginY > 0.0) {
+                bounds.adjust(-marginX, -marginY, marginX, marginY);
+            }
+        }
+        const QRectF clipped = bounds.intersected(QRectF(QPointF(0, 0), QSizeF(renderSize)));
+        if (clipped.isValid() && clipped.width() >= 1.0 && clipped.height() >= 1.0) {
+            const QSize candidateSize(qMax(1, int(qCeil(clipped.width()))),
+                                      qMax(1, int(qCeil(clipped.height()))));
+            const QPoint candidateOffset = clipped.topLeft().toPoint();
+            bool applyCandidate = true;
+            if (renderSize == fit.oldRenderSize && currentSize.isValid()) {
+                const int stableDx = qMax(1, int(qRound(renderSize.width() * kBoundsStableRatio)));
+                const int stableDy = qMax(1, int(qRound(renderSize.height() * kBoundsStableRatio)));
+                if (qAbs(candidateSize.width() - currentSize.width()) < stableDx
+                    && qAbs(candidateSize.height() - currentSize.height()) < stableDy
+                    && qAbs(candidateOffset.x() - m_boundsOffset.x()) < stableDx
+                    && qAbs(candidateOffset.y() - m_boundsOffset.y()) < stableDy) {
+                    applyCandidate = false;
+                }
+            }
+            if (applyCandidate) {
+                fit.windowSize = candidateSize;
+                fit.boundsOffset = candidateOffset;
+            } else {
+                fit.windowSize = currentSize;
+                fit.boundsOffset = m_boundsOffset;
+            }
+        }
+    }
+    m_boundsOffset = fit.boundsOffset;
+    return fit;
+}
+
+bool StickerLive2DHost::showsSnapshot() const
+{
+    return m_demoted || m_pending;
+}
+
+QPixmap StickerLive2DHost::snapshot() const
+{
+    return m_snapshot;
+}
+
+qint64 StickerLive2DHost::residentBytes() const
+{
+    qint64 bytes = 0;
+    if (m_widget) {
+        // 资源由外部模块持有：帧缓冲按双缓冲估算，纹理取自模型清单
+        const qreal dpr = m_owner->devicePixelRatioF();
+        const QSize renderSize = m_widget->size();
+        bytes += qint64(renderSize.width() * dpr) * qint64(renderSize.height() * dpr) * 4 * 2;
+        bytes += m_textureBytes;
+    }
+    if (!m_snapshot.isNull()) {
+        bytes += qint64(m_snapshot.width()) * m_snapshot.height() * 4;
+    }
+    return bytes;
+}
+
+StickerLive2DHost::Stats StickerLive2DHost::stats() const
+{
+    return m_stats;
+}
+
+// 动作播放时包围盒逐帧变化：扩大时限频跟上，缩小要等包络整体缩到一定比例，
+// 其余信号不引起窗口调整
+void StickerLive2DHost::onBoundsChanged(const QRectF &bounds, bool valid)
+{
+    ++m_stats.boundsUpdates;
+    const QSize sourceSize = m_widget ? m_widget->size() : QSize();
+    if (!valid || !bounds.isValid()) {
+        resetEnvelope();
+        m_hasBounds = false;
+        m_boundsPx = QRectF();
+        m_boundsSourceSize = sourceSize;
+        m_callbacks.refit();
+        return;
+    }
+    // 渲染尺寸变化后坐标系不同，旧包络作废
+    if (sourceSize != m_boundsSourceSize) {
+        resetEnvelope();
+        m_boundsSourceSize = sourceSize;
+    }
+    noteBounds(bounds);
+
+    bool needsFit = !m_hasBounds || !m_boundsPx.contains(bounds);
+    if (!needsFit) {
+        const QRectF current = envelope();
+        needsFit = current.width() < m_boundsPx.width() * (1.0 - kShrinkRatio)
+            || current.height() < m_boundsPx.height() * (1.0 - kShrinkRatio);
+    }
+    if (!needsFit) {
+        ++m_stats.resizesAvoided;
+        return;
+    }
+    scheduleFit();
+}
+
+void StickerLive2DHost::noteBounds(const QRectF &bounds)
+{
+    if (!m_envelopeClock.isValid()) {
+        m_envelopeClock.start();
+    }
+    const qint64 slot = m_envelopeClock.elapsed() / kEnvelopeSlotMs;
+    if (!m_envelopeSlots.isEmpty() && m_envelopeSlots.last().first == slot) {
+        m_envelopeSlots.last().second |= bounds;
+    } else {
+        m_envelopeSlots.append(qMakePair(slot, bounds));
+    }
+    while (m_envelopeSlots.first().first <= slot - kEnvelopeSlots) {
+        m_envelopeSlots.removeFirst();
+    }
+}
+
+QRectF StickerLive2DHost::envelope() const
+{
+    const qint64 slot = m_envelopeClock.isValid() ? m_envelopeClock.elapsed() / kEnvelopeSlotMs : 0;
+    QRectF result;
+    for (const QPair<qint64, QRectF> &entry : m_envelopeSlots) {
+        if (entry.first > slot - kEnvelopeSlots) {
+            result |= entry.second;
+        }
+    }
+    return result;
+}
+
+void StickerLive2DHost::resetEnvelope()
+{
+    m_envelopeSlots.clear();
+    m_envelopeClock.invalidate();
+    m_lastFit.invalidate();
+    m_fitTimer.stop();
+}
+
+void StickerLive2DHost::scheduleFit()
+{
+    if (m_fitTimer.isActive()) {
+        ++m_stats.resizesAvoided;
+        return;
+    }
+    const qint64 sinceLast = m_lastFit.isValid() ? m_lastFit.elapsed() : kFitIntervalMs;
+    if (sinceLast >= kFitIntervalMs) {
+        applyFit();
+    } else {
+        m_fitTimer.start(int(kFitIntervalMs - sinceLast));
+    }
+}
+
+void StickerLive2DHost::applyFit()
+{
+    const QRectF current = envelope();
+    if (!current.isValid()) {
+        return;
+    }
+    m_hasBounds = true;
+    m_boundsPx = current;
+    m_lastFit.restart();
+    ++m_stats.boundsFits;
+    m_callbacks.refit();
+}
+
+// 超出动画预算：抓下当前帧作为静态快照，隐藏并挂起渲染窗口
+void StickerLive2DHost::demote()
+{
+    if (!m_widget || m_demoted) {
+        return;
+    }
+    m_snapshot = captureFrame();
+    m_demoted = true;
+    m_widget->hide();
+    m_hitMask = QImage();
+    updateActivity();
+    m_callbacks.requestRepaint();
+}
+
+void StickerLive2DHost::promote()
+{
+    if (!m_demoted) {
+        return;
+    }
+    m_demoted = false;
+    m_snapshot = QPixmap();
+    m_hitMask = QImage();
+    if (m_widget) {
+        m_widget->show();
+        m_widget->raise();
+    }
+    updateActivity();
+    m_callbacks.requestRepaint();
+}
+
+void StickerLive2DHost::defer()
+{
+    if (!m_pending) {
+        m_pending = true;
+        m_snapshot = StickerLive2DLoader::loadPoster(m_config->id);
+    }
+    StickerLive2DLoader::instance()->enqueue(this, [this]() { instantiate(); });
+    m_callbacks.requestRepaint();
+}
+
+void StickerLive2DHost::instantiate()
+{
+    if (!m_pending) {
+        return;
+    }
+    m_pending = false;
+    m_snapshot = QPixmap();
+    StickerLive2DLoader::instance()->cancel(this);
+    // 已被内存预算回收时等到重新显示再创建
+    if (!m_callbacks.isEvicted()) {
+        ensureWidget();
+        applyConfig();
+    }
+    m_callbacks.requestRepaint();
+}
+
+// 渲染窗口当前帧按贴纸窗口大小取下，作为降级快照和海报
+QPixmap StickerLive2DHost::captureFrame()
+{
+    if (!m_widget) {
+        return QPixmap();
+    }
+    const qreal dpr = m_owner->devicePixelRatioF();
+    QPixmap frame(m_owner->size() * dpr);
+    frame.setDevicePixelRatio(dpr);
+    frame.fill(Qt::transparent);
+    QPainter painter(&frame);
+    painter.drawPixmap(m_widget->geometry().topLeft(), m_widget->grab());
+    painter.end();
+    return frame;
+}
+
+void StickerLive2DHost::capturePoster()
+{
+    // 批量跟随实例的 ID 随目标窗口变化，不留海报
+    if (!m_widget || m_demoted || m_throttle.isSuspended()
+        || (m_config->follow.enabled && m_config->follow.batchMode)) {
+        return;
+    }
+    StickerLive2DLoader::savePoster(m_config->id, captureFrame(), posterKey());
+}
+
+QString StickerLive2DHost::posterKey() const
+{
+    return QString("%1|%2x%3").arg(m_config->live2d.modelJsonPath)
+        .arg(m_config->size.width()).arg(m_config->size.height());
+}
+
+// 模型以外的透明区域放行点击：不设窗口遮罩（会裁掉渲染），
+// 而是由全局轮询在光标靠近时唤醒，落在命中位图透明处时让整个窗口暂时对输入透明
+void StickerLive2DHost::updateHitTesting()
+{
+    const bool active = (m_widget || m_pending)
+        && !m_callbacks.isEvicted()
+        && !m_callbacks.isEditing()
+        && m_callbacks.isShown();
+    if (active == m_hitTesting) {
+        return;
+    }
+    m_hitTesting = active;
+    if (active) {
+        // 光标远离时不读回画面，进入外扩范围后开始采样，到达前位图已就绪
+        StickerCursorPoller::Callbacks callbacks;
+        callbacks.hotRect = [this]() {
+            return m_owner->frameGeometry().adjusted(-kHitMarginPx, -kHitMarginPx, kHitMarginPx, kHitMarginPx);
+        };
+        callbacks.cursorNear = [this](const QPoint &cursor) { onCursorNear(cursor); };
+        StickerCursorPoller::instance()->registerClient(this, std::move(callbacks));
+        return;
+    }
+    StickerCursorPoller::instance()->unregisterClient(this);
+    m_hitMask = QImage();
+    m_hitClock.invalidate();
+    setInputTransparent(false);
+}
+
+void StickerLive2DHost::resetInputTransparent()
+{
+    m_inputTransparent = false;
+}
+
+void StickerLive2DHost::onCursorNear(const QPoint &cursor)
+{
+    // 渲染窗口被释放、进入编辑或隐藏时在这里停下并恢复可点
+    updateHitTesting();
+    if (!m_hitTesting) {
+        return;
+    }
+    const QRect bounds = m_owner->frameGeometry();
+    if (m_hitMask.isNull() || !m_hitClock.isValid() || m_hitClock.elapsed() >= kHitSampleMs) {
+        sampleHitMask();
+    }
+    if (m_hitMask.isNull()) {
+        setInputTransparent(false);
+        return;
+    }
+    if (!bounds.contains(cursor)) {
+        return;
+    }
+    // 拖动、缩放等交互进行中保持可点
+    if (QApplication::mouseButtons() != Qt::NoButton) {
+        setInputTransparent(false);
+        return;
+    }
+    const QPoint cell = (cursor - bounds.topLeft()) / kHitCellPx;
+    const bool hit = m_hitMask.valid(cell) && m_hitMask.constScanLine(cell.y())[cell.x()] >= kHitAlpha;
+    setInputTransparent(!hit);
+}
+
+// 降级或排队期间缩小静态快照，否则从渲染窗口直接取每格一个像素，再膨胀一格覆盖采样间隔内的动作
+void StickerLive2DHost::sampleHitMask()
+{
+    m_hitClock.restart();
+    const QSize cells((m_owner->width() + kHitCellPx - 1) / kHitCellPx,
+                      (m_owner->height() + kHitCellPx - 1) / kHitCellPx);
+    QImage small;
+    if (m_demoted || m_pending) {
+        if (!m_snapshot.isNull()) {
+            small = m_snapshot.toImage().scaled(cells, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    } else if (m_widget && !m_throttle.isSuspended()) {
+        small = readHitCells(cells);
+    }
+    if (small.isNull()) {
+        m_hitMask = QImage();
+        return;
+    }
+    m_hitMask = StickerAlphaKernels::extractAlpha(small);
+    StickerAlphaKernels::dilate(m_hitMask, 1);
+}
+
+// 在 GPU 上把贴纸窗口覆盖的那部分帧缓冲线性缩到命中格大小再读回，只传几百个像素；
+// 渲染窗口不是 OpenGL 控件、带多重采样或上下文不支持 blit 时退回整帧抓取
+QImage StickerLive2DHost::readHitCells(const QSize &cells)
+{
+    QOpenGLWidget *gl = qobject_cast<QOpenGLWidget *>(m_widget);
+    if (!gl || !gl->isValid() || gl->format().samples() > 1
+        || !QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
+        return captureFrame().toImage().scaled(cells, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    // 贴纸窗口在渲染窗口中的范围，换算为帧缓冲设备像素（原点在左下）
+    const qreal dpr = gl->devicePixelRatioF();
+    const QRect area(-m_widget->pos(), m_owner->size());
+    const int left = qRound(area.left() * dpr);
+    const int right = qRound((area.left() + area.width()) * dpr);
+    const int bottom = qRound((gl->height() - area.top() - area.height()) * dpr);
+    const int top = qRound((gl->height() - area.top()) * dpr);
+
+    QImage image;
+    gl->makeCurrent();
+    {
+        QOpenGLFramebufferObject target(cells);
+        QOpenGLExtraFunctions *functions = gl->context()->extraFunctions();
+        // 源范围超出渲染窗口的部分不会被写入，先清成透明
+        target.bind();
+        functions->glClearColor(0, 0, 0, 0);
+        functions->glClear(GL_COLOR_BUFFER_BIT);
+        functions->glBindFramebuffer(GL_READ_FRAMEBUFFER, gl->defaultFramebufferObject());
+        functions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.handle());
+        functions->glBlitFramebuffer(left, bottom, right, top, 0, 0, cells.width(), cells.height(),
+                                     GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        image = target.toImage();
+    }
+    gl->doneCurrent();
+    return image;
+}
+
+void StickerLive2DHost::setInputTransparent(bool transparent)
+{
+    if (m_inputTransparent == transparent) {
+        return;
+    }
+    QWindow *window = m_owner->windowHandle();
+    if (!window) {
+        m_inputTransparent = false;
+        return;
+    }
+    // 直接改 QWindow 标志，平台层就地更新扩展样式/输入区域，不会像 QWidget 那样重建窗口
+    window->setFlag(Qt::WindowTransparentForInput, transparent);
+    m_inputTransparent = transparent;
+}
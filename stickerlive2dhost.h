@@ -0,0 +1,130 @@
+#ifndef STICKERLIVE2DHOST_H
+#define STICKERLIVE2DHOST_H
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QPixmap>
+#include <QPoint>
+#include <QRectF>
+#include <QSize>
+#include <QTimer>
+#include <functional>
+#include "stickerdata.h"
+#include "stickerlive2dthrottle.h"
+
+class QWidget;
+
+// 贴纸里 Live2D 内容的承载：渲染窗口的创建/暂存、错峰加载与海报、动画预算降级、
+// 渲染挂起、包围盒包络和透明区域点击放行。只为 Live2D 贴纸创建，图片/视频贴纸不持有这些定时器与状态。
+// 定义 STICKER_NO_LIVE2D 时（独立渲染基准）不链接 Live2D 模块，不创建渲染窗口，只显示海报
+class StickerLive2DHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Callbacks {
+        std::function<bool()> isShown;          // 贴纸在屏幕上显示
+        std::function<bool()> isSuppressed;     // 跟随目标最小化、离屏或被完全遮挡
+        std::function<bool()> isEvicted;        // 渲染资源已被内存预算回收
+        std::function<bool()> isEditing;
+        std::function<void()> requestRepaint;
+        std::function<void()> refit;            // 包围盒变化后按左上角重新计算窗口尺寸
+    };
+
+    // 按包围盒裁掉模型周围的透明区域后的窗口尺寸，以及渲染窗口相对贴纸窗口的偏移
+    struct Fit {
+        QSize windowSize;
+        QPoint boundsOffset;
+        QSize oldRenderSize;
+        QPoint oldBoundsOffset;
+    };
+
+    struct Stats {
+        quint64 boundsUpdates = 0;
+        quint64 boundsFits = 0;
+        quint64 resizesAvoided = 0;
+    };
+
+    // config 由贴纸持有，生命周期覆盖本对象
+    StickerLive2DHost(QWidget *owner, const StickerConfig *config, Callbacks callbacks);
+    ~StickerLive2DHost() override;
+
+    // 启动加载期间先贴海报帧，渲染窗口稍后错峰创建
+    void start();
+    // 配置变化：排队中的模型变化时直接创建，已被回收时等到重新显示
+    void reload(bool modelChanged);
+    void evict();
+    void restore();
+
+    void updateActivity();
+    void updateHitTesting();
+    // 重设窗口标志会重建原生窗口，之前设在旧窗口上的输入穿透随之失效
+    void resetInputTransparent();
+    void updateGeometry();
+    void noteInteraction();
+    Fit fitWindow(const QSize &renderSize, const QSize &currentSize);
+
+    // 降级快照或尚未创建渲染窗口时的海报帧由贴纸绘制
+    bool showsSnapshot() const;
+    QPixmap snapshot() const;
+    qint64 residentBytes() const;
+    Stats stats() const;
+
+private slots:
+    void onBoundsChanged(const QRectF &bounds, bool valid);
+
+private:
+    void ensureWidget();
+    QWidget *createWidget();
+    void watchBounds();
+    void releaseWidget();
+    void applyConfig();
+    void noteBounds(const QRectF &bounds);
+    QRectF envelope() const;
+    void resetEnvelope();
+    void scheduleFit();
+    void applyFit();
+    void demote();
+    void promote();
+    void defer();
+    void instantiate();
+    QPixmap captureFrame();
+    void capturePoster();
+    QString posterKey() const;
+    void onCursorNear(const QPoint &cursor);
+    void sampleHitMask();
+    QImage readHitCells(const QSize &cells);
+    void setInputTransparent(bool transparent);
+
+    QWidget *m_owner;
+    const StickerConfig *m_config;
+    Callbacks m_callbacks;
+    QWidget *m_widget;                  // Live2DWidget
+    QSize m_renderSize;
+    QSize m_boundsSourceSize;
+    QRectF m_boundsPx;
+    QPoint m_boundsOffset;
+    bool m_hasBounds;
+    QList<QPair<qint64, QRectF>> m_envelopeSlots;   // 按时间片记录的包围盒并集
+    QElapsedTimer m_envelopeClock;
+    QElapsedTimer m_lastFit;
+    QTimer m_fitTimer;
+    StickerLive2DThrottle m_throttle;
+    QTimer m_activityTimer;
+    bool m_demoted;
+    bool m_pending;
+    Live2DConfig m_appliedConfig;
+    bool m_configApplied;
+    qint64 m_textureBytes;
+    QPixmap m_snapshot;
+    bool m_hitTesting;
+    QElapsedTimer m_hitClock;
+    QImage m_hitMask;                   // 每格一像素的 Alpha8 命中位图
+    bool m_inputTransparent;
+    Stats m_stats;
+};
+
+#endif // STICKERLIVE2DHOST_H
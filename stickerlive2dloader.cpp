@@ -0,0 +1,148 @@
+#include "stickerlive2dloader.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QStandardPaths>
+
+namespace {
+const int kSettleDelayMs = 1500;
+const int kStaggerMs = 250;
+const char kPosterDir[] = "posters";
+const char kPosterKeyText[] = "poster-key";
+}
+
+StickerLive2DLoader *StickerLive2DLoader::instance()
+{
+    static StickerLive2DLoader *s_instance = new StickerLive2DLoader(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerLive2DLoader::StickerLive2DLoader(QObject *parent)
+    : QObject(parent)
+    , m_startupDepth(0)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &StickerLive2DLoader::onTick);
+}
+
+void StickerLive2DLoader::beginStartup()
+{
+    ++m_startupDepth;
+    m_timer.stop();
+}
+
+void StickerLive2DLoader::endStartup()
+{
+    if (m_startupDepth == 0 || --m_startupDepth > 0) {
+        return;
+    }
+    if (!m_queue.isEmpty()) {
+        qDebug() << "启动完成，" << kSettleDelayMs << "ms 后错峰创建 Live2D 贴纸:" << m_queue.size();
+        m_timer.start(kSettleDelayMs);
+    }
+}
+
+bool StickerLive2DLoader::isDeferring() const
+{
+    return m_startupDepth > 0;
+}
+
+void StickerLive2DLoader::enqueue(const QObject *client, InstantiateCallback callback)
+{
+    if (!client || !callback) {
+        return;
+    }
+    if (!m_callbacks.contains(client)) {
+        m_queue.append(client);
+    }
+    m_callbacks.insert(client, std::move(callback));
+    if (m_startupDepth == 0 && !m_timer.isActive()) {
+        m_timer.start(kStaggerMs);
+    }
+}
+
+void StickerLive2DLoader::instantiateNow(const QObject *client)
+{
+    auto it = m_callbacks.find(client);
+    if (it == m_callbacks.end()) {
+        return;
+    }
+    const InstantiateCallback callback = it.value();
+    m_callbacks.erase(it);
+    m_queue.removeAll(client);
+    callback();
+}
+
+void StickerLive2DLoader::cancel(const QObject *client)
+{
+    m_callbacks.remove(client);
+    m_queue.removeAll(client);
+}
+
+int StickerLive2DLoader::pendingCount() const
+{
+    return m_queue.size();
+}
+
+// 每次只创建一个，避免多个模型同时加载卡住界面
+void StickerLive2DLoader::onTick()
+{
+    if (m_startupDepth > 0 || m_queue.isEmpty()) {
+        return;
+    }
+    instantiateNow(m_queue.first());
+    if (!m_queue.isEmpty()) {
+        m_timer.start(kStaggerMs);
+    }
+}
+
+QString StickerLive2DLoader::posterPath(const QString &stickerId)
+{
+    const QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    return cacheDir.filePath(QString("%1/%2.png").arg(kPosterDir, stickerId));
+}
+
+QPixmap StickerLive2DLoader::loadPoster(const QString &stickerId)
+{
+    if (stickerId.isEmpty()) {
+        return QPixmap();
+    }
+    return QPixmap(posterPath(stickerId));
+}
+
+void StickerLive2DLoader::savePoster(const QString &stickerId, const QPixmap &poster, const QString &key)
+{
+    if (stickerId.isEmpty() || poster.isNull()) {
+        return;
+    }
+    const QString path = posterPath(stickerId);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QImage image = poster.toImage();
+    image.setText(QLatin1String(kPosterKeyText), key);
+    if (!image.save(path, "PNG")) {
+        qDebug() << "保存 Live2D 海报帧失败:" << path;
+    }
+}
+
+void StickerLive2DLoader::removePoster(const QString &stickerId)
+{
+    if (!stickerId.isEmpty()) {
+        QFile::remove(posterPath(stickerId));
+    }
+}
+
+QString StickerLive2DLoader::posterKey(const QString &stickerId)
+{
+    if (stickerId.isEmpty()) {
+        return QString();
+    }
+    QImageReader reader(posterPath(stickerId), "PNG");
+    if (!reader.canRead()) {
+        return QString();
+    }
+    return reader.text(QLatin1String(kPosterKeyText));
+}
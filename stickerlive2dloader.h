@@ -0,0 +1,54 @@
+#ifndef STICKERLIVE2DLOADER_H
+#define STICKERLIVE2DLOADER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+// Live2D 延迟创建：启动加载配置期间新建的 Live2D 贴纸先显示上次运行留下的海报帧，
+// 启动稳定后逐个错峰创建渲染窗口；悬停/点击的贴纸立即创建
+class StickerLive2DLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    using InstantiateCallback = std::function<void()>;
+
+    static StickerLive2DLoader *instance();
+
+    // 可嵌套，最外层结束后等待一段时间再开始错峰创建
+    void beginStartup();
+    void endStartup();
+    bool isDeferring() const;
+
+    void enqueue(const QObject *client, InstantiateCallback callback);
+    void instantiateNow(const QObject *client);
+    void cancel(const QObject *client);
+    int pendingCount() const;
+
+    // 海报帧按贴纸 ID 存放在缓存目录；key 记录抓取时的模型与尺寸，写在 PNG 文本块里
+    static QPixmap loadPoster(const QString &stickerId);
+    static void savePoster(const QString &stickerId, const QPixmap &poster, const QString &key);
+    static void removePoster(const QString &stickerId);
+    // 只读文件头，不解码像素；没有海报时返回空串
+    static QString posterKey(const QString &stickerId);
+
+private slots:
+    void onTick();
+
+private:
+    explicit StickerLive2DLoader(QObject *parent = nullptr);
+
+    static QString posterPath(const QString &stickerId);
+
+    QList<const QObject*> m_queue;
+    QHash<const QObject*, InstantiateCallback> m_callbacks;
+    QTimer m_timer;
+    int m_startupDepth;
+};
+
+#endif // STICKERLIVE2DLOADER_H
@@ -0,0 +1,308 @@
+#include "stickerlive2dmanifest.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtMath>
+
+namespace {
+const int kManifestVersion = 1;
+const char kModelSuffix[] = ".model3.json";
+const char kManifestSuffix[] = ".manifest.json";
+// moc3：64 字节文件头，其后是各段偏移表，第二项为画布信息
+const int kMocHeaderSize = 64;
+const int kMocCanvasOffsetIndex = 1;
+const float kMaxCanvasSide = 32768.0f;
+
+QStringList toStringList(const QJsonArray &array)
+{
+    QStringList list;
+    for (const QJsonValue &value : array) {
+        list.append(value.toString());
+    }
+    return list;
+}
+
+QJsonArray toJsonArray(const QStringList &list)
+{
+    QJsonArray array;
+    for (const QString &value : list) {
+        array.append(value);
+    }
+    return array;
+}
+
+qint64 fileModified(const QFileInfo &info)
+{
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+// 只读文件头和画布信息，读不到或数值异常时返回空尺寸
+QSize readMocCanvas(const QString &mocPath)
+{
+    QFile file(mocPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QSize();
+    }
+    const QByteArray header = file.read(kMocHeaderSize + (kMocCanvasOffsetIndex + 1) * 4);
+    if (header.size() < kMocHeaderSize + (kMocCanvasOffsetIndex + 1) * 4 || !header.startsWith("MOC3")) {
+        return QSize();
+    }
+
+    QDataStream headerStream(header);
+    headerStream.setByteOrder(header.at(5) != 0 ? QDataStream::BigEndian : QDataStream::LittleEndian);
+    headerStream.skipRawData(kMocHeaderSize + kMocCanvasOffsetIndex * 4);
+    quint32 canvasOffset = 0;
+    headerStream >> canvasOffset;
+    if (canvasOffset < quint32(kMocHeaderSize) || !file.seek(canvasOffset)) {
+        return QSize();
+    }
+
+    QDataStream canvasStream(&file);
+    canvasStream.setByteOrder(headerStream.byteOrder());
+    canvasStream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    float pixelsPerUnit = 0;
+    float originX = 0;
+    float originY = 0;
+    float width = 0;
+    float height = 0;
+    canvasStream >> pixelsPerUnit >> originX >> originY >> width >> height;
+    if (canvasStream.status() != QDataStream::Ok
+        || !(width > 0 && width <= kMaxCanvasSide)
+        || !(height > 0 && height <= kMaxCanvasSide)) {
+        return QSize();
+    }
+    return QSize(qCeil(width), qCeil(height));
+}
+}
+
+bool StickerLive2DManifest::isComplete() const
+{
+    return !mocFile.isEmpty() && !textures.isEmpty() && missingFiles.isEmpty();
+}
+
+qint64 StickerLive2DManifest::textureBytes() const
+{
+    qint64 bytes = 0;
+    for (const Texture &texture : textures) {
+        bytes += qint64(texture.size.width()) * texture.size.height() * 4;
+    }
+    return bytes;
+}
+
+QSize StickerLive2DManifest::fitBaseSize(const QSize &box) const
+{
+    if (canvasSize.isEmpty() || box.isEmpty()) {
+        return box;
+    }
+    return canvasSize.scaled(box, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+}
+
+QJsonObject StickerLive2DManifest::toJson() const
+{
+    QJsonObject obj;
+    obj["version"] = kManifestVersion;
+    obj["model"] = modelFile;
+    obj["sourceModified"] = double(sourceModified);
+    obj["moc"] = mocFile;
+    if (!canvasSize.isEmpty()) {
+        QJsonObject canvas;
+        canvas["width"] = canvasSize.width();
+        canvas["height"] = canvasSize.height();
+        obj["canvas"] = canvas;
+    }
+    QJsonArray textureArray;
+    for (const Texture &texture : textures) {
+        QJsonObject item;
+        item["file"] = texture.file;
+        item["width"] = texture.size.width();
+        item["height"] = texture.size.height();
+        item["bytes"] = double(texture.bytes);
+        textureArray.append(item);
+    }
+    obj["textures"] = textureArray;
+    obj["motions"] = toJsonArray(motions);
+    obj["expressions"] = toJsonArray(expressions);
+    obj["otherFiles"] = toJsonArray(otherFiles);
+    obj["missingFiles"] = toJsonArray(missingFiles);
+    obj["totalBytes"] = double(totalBytes);
+    return obj;
+}
+
+void StickerLive2DManifest::fromJson(const QJsonObject &json)
+{
+    modelFile = json["model"].toString();
+    sourceModified = qint64(json["sourceModified"].toDouble());
+    mocFile = json["moc"].toString();
+    const QJsonObject canvas = json["canvas"].toObject();
+    canvasSize = QSize(canvas["width"].toInt(), canvas["height"].toInt());
+    textures.clear();
+    for (const QJsonValue &value : json["textures"].toArray()) {
+        const QJsonObject item = value.toObject();
+        Texture texture;
+        texture.file = item["file"].toString();
+        texture.size = QSize(item["width"].toInt(), item["height"].toInt());
+        texture.bytes = qint64(item["bytes"].toDouble());
+        textures.append(texture);
+    }
+    motions = toStringList(json["motions"].toArray());
+    expressions = toStringList(json["expressions"].toArray());
+    otherFiles = toStringList(json["otherFiles"].toArray());
+    missingFiles = toStringList(json["missingFiles"].toArray());
+    totalBytes = qint64(json["totalBytes"].toDouble());
+}
+
+QString StickerLive2DManifest::manifestPath(const QString &modelJsonPath)
+{
+    QString path = modelJsonPath;
+    if (path.endsWith(kModelSuffix, Qt::CaseInsensitive)) {
+        path.chop(int(qstrlen(kModelSuffix)));
+    }
+    return path + kManifestSuffix;
+}
+
+bool StickerLive2DManifest::build(const QString &modelJsonPath, StickerLive2DManifest &out, QString *error)
+{
+    const QFileInfo modelInfo(modelJsonPath);
+    QFile modelFile(modelJsonPath);
+    if (!modelFile.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("无法读取模型文件: %1").arg(modelJsonPath);
+        }
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(modelFile.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        if (error) {
+            *error = QString("模型文件格式错误: %1 (%2)").arg(modelJsonPath, parseError.errorString());
+        }
+        return false;
+    }
+
+    StickerLive2DManifest manifest;
+    manifest.modelFile = modelInfo.fileName();
+    manifest.sourceModified = fileModified(modelInfo);
+    manifest.totalBytes = modelInfo.size();
+
+    const QDir modelDir = modelInfo.absoluteDir();
+    auto addFile = [&manifest, &modelDir](const QString &relativePath) {
+        const QFileInfo info(modelDir.filePath(relativePath));
+        if (info.isFile()) {
+            manifest.totalBytes += info.size();
+            return true;
+        }
+        manifest.missingFiles.append(relativePath);
+        return false;
+    };
+
+    const QJsonObject references = document.object()["FileReferences"].toObject();
+    manifest.mocFile = references["Moc"].toString();
+    if (manifest.mocFile.isEmpty()) {
+        manifest.missingFiles.append("Moc");
+    } else if (addFile(manifest.mocFile)) {
+        manifest.canvasSize = readMocCanvas(modelDir.filePath(manifest.mocFile));
+    }
+
+    // 纹理只读文件头取尺寸，不解码
+    for (const QJsonValue &value : references["Textures"].toArray()) {
+        Texture texture;
+        texture.file = value.toString();
+        const QString path = modelDir.filePath(texture.file);
+        if (addFile(texture.file)) {
+            texture.bytes = QFileInfo(path).size();
+            texture.size = QImageReader(path).size();
+        }
+        manifest.textures.append(texture);
+    }
+
+    const QJsonObject motionGroups = references["Motions"].toObject();
+    for (auto group = motionGroups.constBegin(); group != motionGroups.constEnd(); ++group) {
+        for (const QJsonValue &value : group.value().toArray()) {
+            const QJsonObject motion = value.toObject();
+            const QString file = motion["File"].toString();
+            if (!file.isEmpty() && !manifest.motions.contains(file)) {
+                manifest.motions.append(file);
+                addFile(file);
+            }
+            const QString sound = motion["Sound"].toString();
+            if (!sound.isEmpty() && !manifest.otherFiles.contains(sound)) {
+                manifest.otherFiles.append(sound);
+                addFile(sound);
+            }
+        }
+    }
+
+    for (const QJsonValue &value : references["Expressions"].toArray()) {
+        const QString file = value.toObject()["File"].toString();
+        if (!file.isEmpty() && !manifest.expressions.contains(file)) {
+            manifest.expressions.append(file);
+            addFile(file);
+        }
+    }
+
+    const char *singleFiles[] = { "Physics", "Pose", "DisplayInfo", "UserData" };
+    for (const char *key : singleFiles) {
+        const QString file = references[key].toString();
+        if (!file.isEmpty()) {
+            manifest.otherFiles.append(file);
+            addFile(file);
+        }
+    }
+
+    out = manifest;
+    return true;
+}
+
+bool StickerLive2DManifest::read(const QString &modelJsonPath, StickerLive2DManifest &out)
+{
+    const QFileInfo modelInfo(modelJsonPath);
+    QFile manifestFile(manifestPath(modelJsonPath));
+    if (!modelInfo.isFile() || !manifestFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject json = QJsonDocument::fromJson(manifestFile.readAll()).object();
+    if (json["version"].toInt() != kManifestVersion
+        || qint64(json["sourceModified"].toDouble()) != fileModified(modelInfo)) {
+        return false;
+    }
+    out.fromJson(json);
+    return true;
+}
+
+bool StickerLive2DManifest::ensure(const QString &modelJsonPath, StickerLive2DManifest &out, QString *error)
+{
+    if (read(modelJsonPath, out)) {
+        return true;
+    }
+    if (!build(modelJsonPath, out, error)) {
+        return false;
+    }
+    const QString path = manifestPath(modelJsonPath);
+    QFile manifestFile(path);
+    if (manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        manifestFile.write(QJsonDocument(out.toJson()).toJson(QJsonDocument::Indented));
+    } else {
+        qDebug() << "写入 Live2D 模型清单失败:" << path;
+    }
+    return true;
+}
+
+bool StickerLive2DManifest::inspect(const QString &modelJsonPath, StickerLive2DManifest &out)
+{
+    return read(modelJsonPath, out) || build(modelJsonPath, out);
+}
+
+QSize StickerLive2DManifest::defaultBaseSize(const QString &modelJsonPath, const QSize &box)
+{
+    StickerLive2DManifest manifest;
+    if (modelJsonPath.isEmpty() || !inspect(modelJsonPath, manifest)) {
+        return box;
+    }
+    return manifest.fitBaseSize(box);
+}
@@ -0,0 +1,51 @@
+#ifndef STICKERLIVE2DMANIFEST_H
+#define STICKERLIVE2DMANIFEST_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+// Live2D 模型清单：导入时解析一次 model3.json，与模型放在同一目录，
+// 记录纹理及尺寸、动作/表情文件、总字节数和画布尺寸。
+// 基础尺寸默认值、文件完整性检查和显存估算都从清单读取，不必等到创建渲染窗口
+struct StickerLive2DManifest {
+    struct Texture {
+        QString file;        // 相对模型目录
+        QSize size;
+        qint64 bytes = 0;
+    };
+
+    QString modelFile;
+    qint64 sourceModified = 0;   // model3.json 修改时间，不一致时重建
+    QString mocFile;
+    QSize canvasSize;            // 取自 moc3 画布信息，读不到时为空
+    QList<Texture> textures;
+    QStringList motions;
+    QStringList expressions;
+    QStringList otherFiles;      // 物理、姿势、显示信息等
+    QStringList missingFiles;
+    qint64 totalBytes = 0;
+
+    bool isComplete() const;
+    // 纹理上传后的显存估算（RGBA8）
+    qint64 textureBytes() const;
+    // 按画布宽高比放进 box，没有画布信息时返回 box
+    QSize fitBaseSize(const QSize &box) const;
+
+    QJsonObject toJson() const;
+    void fromJson(const QJsonObject &json);
+
+    static QString manifestPath(const QString &modelJsonPath);
+    static bool build(const QString &modelJsonPath, StickerLive2DManifest &out, QString *error = nullptr);
+    // 只读取与 model3.json 修改时间一致的清单
+    static bool read(const QString &modelJsonPath, StickerLive2DManifest &out);
+    // 读取清单，缺失或过期时重新解析并保存（导入到资源目录的模型）
+    static bool ensure(const QString &modelJsonPath, StickerLive2DManifest &out, QString *error = nullptr);
+    // 读取清单，缺失或过期时临时解析，不写文件（尚未导入的模型）
+    static bool inspect(const QString &modelJsonPath, StickerLive2DManifest &out);
+    static QSize defaultBaseSize(const QString &modelJsonPath, const QSize &box);
+};
+
+#endif // STICKERLIVE2DMANIFEST_H
@@ -0,0 +1,147 @@
+#include "stickerlive2dmodelcache.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QWidget>
+#include "stickerlive2dthrottle.h"
+
+namespace {
+const int kMaxParked = 4;
+const int kParkedLifetimeMs = 60000;
+const int kExpireCheckMs = 5000;
+}
+
+StickerLive2DModelCache *StickerLive2DModelCache::instance()
+{
+    static StickerLive2DModelCache *s_instance = new StickerLive2DModelCache(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerLive2DModelCache::StickerLive2DModelCache(QObject *parent)
+    : QObject(parent)
+    , m_hits(0)
+    , m_misses(0)
+    , m_closing(false)
+{
+    m_expireTimer.setInterval(kExpireCheckMs);
+    connect(&m_expireTimer, &QTimer::timeout, this, &StickerLive2DModelCache::onExpire);
+    // 退出前销毁暂存的渲染窗口，避免在 OpenGL 上下文销毁后才析构
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, [this]() {
+            m_closing = true;
+            clear();
+        });
+    }
+}
+
+QString StickerLive2DModelCache::keyFor(const Live2DConfig &config)
+{
+    const QFileInfo modelInfo(config.modelJsonPath);
+    if (!modelInfo.exists()) {
+        return QString();
+    }
+    return QString("%1|%2|%3|%4")
+        .arg(modelInfo.absoluteFilePath())
+        .arg(modelInfo.lastModified().toMSecsSinceEpoch())
+        .arg(config.runtimeRoot)
+        .arg(config.shaderProfile);
+}
+
+StickerLive2DModelCache::Parked StickerLive2DModelCache::take(const Live2DConfig &config, QWidget *parent)
+{
+    const QString key = keyFor(config);
+    if (!key.isEmpty()) {
+        // 优先取最近暂存的，纹理更可能仍在显存中
+        for (int i = m_entries.size() - 1; i >= 0; --i) {
+            if (m_entries.at(i).key != key) {
+                continue;
+            }
+            const Entry entry = m_entries.takeAt(i);
+            entry.throttle->attach(nullptr);
+            delete entry.throttle;
+            entry.parked.widget->setParent(parent);
+            ++m_hits;
+            if (m_entries.isEmpty()) {
+                m_expireTimer.stop();
+            }
+            qDebug() << "Live2D 模型缓存命中:" << config.modelJsonPath;
+            return entry.parked;
+        }
+    }
+    ++m_misses;
+    return Parked();
+}
+
+void StickerLive2DModelCache::park(const Parked &parked)
+{
+    if (!parked.widget) {
+        return;
+    }
+    Entry entry;
+    entry.key = keyFor(parked.config);
+    entry.parked = parked;
+    if (entry.key.isEmpty() || m_closing) {
+        parked.widget->hide();
+        parked.widget->deleteLater();
+        return;
+    }
+
+    parked.widget->hide();
+    parked.widget->setParent(nullptr);
+    entry.throttle = new StickerLive2DThrottle(this);
+    entry.throttle->attach(parked.widget);
+    entry.throttle->setSuspended(true);
+    entry.age.start();
+    m_entries.append(entry);
+
+    while (m_entries.size() > kMaxParked) {
+        destroyEntry(m_entries.takeFirst());
+    }
+    if (!m_expireTimer.isActive()) {
+        m_expireTimer.start();
+    }
+}
+
+void StickerLive2DModelCache::clear()
+{
+    while (!m_entries.isEmpty()) {
+        destroyEntry(m_entries.takeFirst());
+    }
+    m_expireTimer.stop();
+}
+
+int StickerLive2DModelCache::parkedCount() const
+{
+    return m_entries.size();
+}
+
+int StickerLive2DModelCache::hitCount() const
+{
+    return m_hits;
+}
+
+int StickerLive2DModelCache::missCount() const
+{
+    return m_misses;
+}
+
+void StickerLive2DModelCache::onExpire()
+{
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+        if (m_entries.at(i).age.elapsed() >= kParkedLifetimeMs) {
+            destroyEntry(m_entries.takeAt(i));
+        }
+    }
+    if (m_entries.isEmpty()) {
+        m_expireTimer.stop();
+    }
+}
+
+void StickerLive2DModelCache::destroyEntry(const Entry &entry)
+{
+    delete entry.throttle;
+    if (entry.parked.widget) {
+        entry.parked.widget->deleteLater();
+    }
+}
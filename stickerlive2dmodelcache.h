@@ -0,0 +1,67 @@
+#ifndef STICKERLIVE2DMODELCACHE_H
+#define STICKERLIVE2DMODELCACHE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QRectF>
+#include <QString>
+#include <QTimer>
+#include "stickerdata.h"
+
+class QWidget;
+class StickerLive2DThrottle;
+
+// Live2D 模型缓存：模型数据、纹理和动作由外部模块的 Live2DWidget 持有，
+// 这里缓存“已加载好某个模型的空闲渲染窗口”，按 model3.json 路径与修改时间（及运行时/着色器）索引。
+// 贴纸重建、销毁后再创建同一模型时直接取回，不再重新解析；
+// 配合 AA_ShareOpenGLContexts，跨贴纸窗口转移时纹理仍然有效
+class StickerLive2DModelCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Parked {
+        QWidget *widget = nullptr;         // 外部模块的 Live2DWidget
+        Live2DConfig config;       // 该窗口最后应用的配置
+        QRectF bounds;             // 最后一次上报的可见包围盒
+        bool boundsValid = false;
+    };
+
+    static StickerLive2DModelCache *instance();
+
+    static QString keyFor(const Live2DConfig &config);
+
+    // 取出后挂到 parent 下并恢复运行；未命中时 widget 为空
+    Parked take(const Live2DConfig &config, QWidget *parent);
+    // 接管所有权：隐藏、挂起后暂存，超时或超出数量时销毁
+    void park(const Parked &parked);
+    void clear();
+
+    int parkedCount() const;
+    int hitCount() const;
+    int missCount() const;
+
+private slots:
+    void onExpire();
+
+private:
+    explicit StickerLive2DModelCache(QObject *parent = nullptr);
+
+    struct Entry {
+        QString key;
+        Parked parked;
+        StickerLive2DThrottle *throttle = nullptr;
+        QElapsedTimer age;
+    };
+
+    void destroyEntry(const Entry &entry);
+
+    QList<Entry> m_entries;   // 队尾为最近暂存
+    QTimer m_expireTimer;
+    int m_hits;
+    int m_misses;
+    bool m_closing;
+};
+
+#endif // STICKERLIVE2DMODELCACHE_H
@@ -0,0 +1,148 @@
+#include "stickerlive2dthrottle.h"
+#include <QDebug>
+#include <QEvent>
+#include <QWidget>
+
+namespace {
+const int kInteractionHoldMs = 3000;
+const int kDefaultIdleFps = 15;
+}
+
+StickerLive2DThrottle::StickerLive2DThrottle(QObject *parent)
+    : QObject(parent)
+    , m_suspended(false)
+    , m_idleIntervalMs(1000 / kDefaultIdleFps)
+{
+    m_deferredPaint.setSingleShot(true);
+    connect(&m_deferredPaint, &QTimer::timeout, this, &StickerLive2DThrottle::onDeferredPaint);
+}
+
+void StickerLive2DThrottle::attach(QWidget *target)
+{
+    if (m_target == target) {
+        return;
+    }
+    if (m_target) {
+        m_target->removeEventFilter(this);
+        if (m_suspended) {
+            resumeTimers();
+        }
+    }
+    m_pausedTimers.clear();
+    m_deferredPaint.stop();
+    m_lastPaint.invalidate();
+    m_target = target;
+    if (m_target) {
+        m_target->installEventFilter(this);
+        if (m_suspended) {
+            pauseTimers();
+        }
+    }
+}
+
+void StickerLive2DThrottle::setSuspended(bool suspended)
+{
+    if (m_suspended == suspended) {
+        return;
+    }
+    m_suspended = suspended;
+    if (!m_target) {
+        return;
+    }
+    if (m_suspended) {
+        m_deferredPaint.stop();
+        pauseTimers();
+        qDebug() << "Live2D 渲染挂起";
+    } else {
+        resumeTimers();
+        m_lastPaint.invalidate();
+        m_target->update();
+        qDebug() << "Live2D 渲染恢复";
+    }
+}
+
+bool StickerLive2DThrottle::isSuspended() const
+{
+    return m_suspended;
+}
+
+void StickerLive2DThrottle::noteInteraction()
+{
+    const bool wasIdle = isIdle();
+    m_lastInteraction.restart();
+    if (wasIdle && m_deferredPaint.isActive()) {
+        // 交互开始时立即补上被限流推迟的一帧
+        m_deferredPaint.stop();
+        onDeferredPaint();
+    }
+}
+
+void StickerLive2DThrottle::setIdleFrameRate(int fps)
+{
+    m_idleIntervalMs = fps > 0 ? 1000 / fps : 0;
+}
+
+bool StickerLive2DThrottle::isIdle() const
+{
+    return !m_lastInteraction.isValid() || m_lastInteraction.elapsed() >= kInteractionHoldMs;
+}
+
+bool StickerLive2DThrottle::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != m_target) {
+        return QObject::eventFilter(watched, event);
+    }
+
+    switch (event->type()) {
+    case QEvent::Timer:
+        // 挂起时丢弃模型驱动用的计时器事件
+        return m_suspended;
+    case QEvent::Paint:
+        if (m_suspended) {
+            return true;
+        }
+        if (m_idleIntervalMs > 0 && isIdle() && m_lastPaint.isValid()) {
+            const qint64 remaining = m_idleIntervalMs - m_lastPaint.elapsed();
+            if (remaining > 0) {
+                // 丢掉这一帧，到点后补一次，保证最后一帧总会画出来
+                if (!m_deferredPaint.isActive()) {
+                    m_deferredPaint.start(int(remaining));
+                }
+                return true;
+            }
+        }
+        m_lastPaint.restart();
+        return false;
+    default:
+        return false;
+    }
+}
+
+// 挂起时停掉渲染窗口名下仍在运行的定时器，恢复时按原间隔重启
+void StickerLive2DThrottle::pauseTimers()
+{
+    const QList<QTimer*> timers = m_target->findChildren<QTimer*>();
+    for (QTimer *timer : timers) {
+        if (timer->isActive()) {
+            timer->stop();
+            m_pausedTimers.append(timer);
+        }
+    }
+}
+
+void StickerLive2DThrottle::resumeTimers()
+{
+    for (const QPointer<QTimer> &timer : m_pausedTimers) {
+        if (timer) {
+            timer->start();
+        }
+    }
+    m_pausedTimers.clear();
+}
+
+void StickerLive2DThrottle::onDeferredPaint()
+{
+    if (m_target && !m_suspended) {
+        m_target->update();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef STICKERLIVE2DTHROTTLE_H
+#define STICKERLIVE2DTHROTTLE_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class QWidget;
+
+// Live2D 渲染节流：Live2DWidget 由外部模块提供，没有暂停接口，
+// 这里以事件过滤器挂在渲染窗口上——挂起时拦下绘制与计时器事件并停掉其子定时器，
+// 无人交互时按空闲帧率放行绘制
+class StickerLive2DThrottle : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StickerLive2DThrottle(QObject *parent = nullptr);
+
+    // 切换渲染窗口时先恢复旧窗口，传 nullptr 解除
+    void attach(QWidget *target);
+
+    void setSuspended(bool suspended);
+    bool isSuspended() const;
+
+    // 最近一次交互后一段时间内不限帧率
+    void noteInteraction();
+    void setIdleFrameRate(int fps);
+    bool isIdle() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void pauseTimers();
+    void resumeTimers();
+    void onDeferredPaint();
+
+    QPointer<QWidget> m_target;
+    bool m_suspended;
+    int m_idleIntervalMs;
+    QElapsedTimer m_lastInteraction;
+    QElapsedTimer m_lastPaint;
+    QTimer m_deferredPaint;
+    QList<QPointer<QTimer>> m_pausedTimers;
+};
+
+#endif // STICKERLIVE2DTHROTTLE_H
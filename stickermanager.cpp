@@ -1,10 +1,14 @@
-#include "StickerManager.h"
+#include "stickermanager.h"
 #include <QApplication>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QMutexLocker>
 #include <QThread>
 #include <QUuid>
+#include "stickercompositor.h"
+#include "stickerlive2dbudget.h"
+#include "stickerlive2dloader.h"
+#include "stickermemorybudget.h"
 
 namespace {
 bool isOnThread(const QObject *obj)
@@ -155,6 +159,9 @@ void StickerManager::deleteSticker(const QString &stickerId)
 
     m_followController.removeTemplate(stickerId);
     m_runtime.destroyInstancesForTemplate(stickerId);
+    if (oldConfig.contentType == StickerContentType::Live2D) {
+        StickerLive2DLoader::removePoster(oldConfig.id);
+    }
 
     emit stickerDeleted(oldConfig.id);
     emit stickerConfigsUpdated(getAllConfigs());
@@ -259,7 +266,11 @@ bool StickerManager::loadConfigInternal()
 {
     QList<StickerConfig> configs;
     bool hasData = false;
-    m_repository.load(configs, hasData);
+    m_repository.load(configs, hasData, &m_runtimeSettings);
+    StickerMemoryBudget::instance().setBudgetBytes(qint64(m_runtimeSettings.memoryBudgetMb) * 1024 * 1024);
+    StickerLive2DBudget::instance().setMaxAnimated(m_runtimeSettings.maxAnimatedLive2D);
+    StickerCompositor::instance()->setEnabled(m_runtimeSettings.compositeDesktopStickers);
+    StickerCompositor::instance()->setRasterSurfacesEnabled(m_runtimeSettings.rasterSurfaces);
 
     if (!hasData || configs.isEmpty()) {
         m_runtime.clear();
@@ -274,6 +285,8 @@ bool StickerManager::loadConfigInternal()
 
     m_runtime.clear();
 
+    // 多个 Live2D 模型不再阻塞启动：先显示海报帧，启动完成后错峰创建
+    StickerLive2DLoader::instance()->beginStartup();
     QList<StickerConfig> actualConfigs;
     actualConfigs.reserve(configs.size());
     for (StickerConfig config : configs) {
@@ -292,6 +305,7 @@ bool StickerManager::loadConfigInternal()
     }
 
     m_followController.setTemplates(actualConfigs);
+    StickerLive2DLoader::instance()->endStartup();
     emit configLoaded(actualConfigs);
     emit stickerConfigsUpdated(actualConfigs);
     qDebug() << "配置加载完成";
@@ -310,7 +324,7 @@ bool StickerManager::saveConfigInternal()
         return m_repository.clear();
     }
 
-    if (!m_repository.save(configs)) {
+    if (!m_repository.save(configs, m_runtimeSettings)) {
         return false;
     }
 
@@ -333,6 +347,11 @@ StickerConfig StickerManager::prepareConfigForStorage(const StickerConfig &confi
         if (!imported.isEmpty()) {
             updated.live2d.modelJsonPath = imported;
         }
+    } else if (updated.contentType == StickerContentType::Video) {
+        QString imported = m_assetStore.importVideo(updated.video.path, &error);
+        if (!imported.isEmpty()) {
+            updated.video.path = imported;
+        }
     }
 
     if (!error.isEmpty()) {
@@ -356,6 +375,16 @@ StickerWidget* StickerManager::getStickerWidget(const QString &stickerId) const
     return m_runtime.widget(stickerId);
 }
 
+QHash<QString, qint64> StickerManager::residentBytesReport() const
+{
+    return m_runtime.residentBytes();
+}
+
+QHash<QString, StickerWidget::PaintStats> StickerManager::paintStatsReport() const
+{
+    return m_runtime.paintStats();
+}
+
 void StickerManager::onInstanceConfigChanged(const QString &instanceId,
                                              const StickerConfig &config,
                                              bool syncToTemplate)
@@ -413,6 +442,28 @@ void StickerManager::onAutoSaveTimer()
 {
     saveConfig();
     qDebug() << "自动保存配置完成";
+    qDebug() << "贴纸常驻内存:" << StickerMemoryBudget::instance().totalResidentBytes()
+             << "预算:" << StickerMemoryBudget::instance().budgetBytes();
+
+    const QHash<QString, StickerWidget::PaintStats> stats = paintStatsReport();
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const StickerWidget::PaintStats &stat = it.value();
+        if (stat.paintCount == 0 && stat.skippedCount == 0 && stat.boundsUpdates == 0) {
+            continue;
+        }
+        qDebug() << "贴纸绘制:" << it.key() << "次数" << stat.paintCount << "跳过" << stat.skippedCount
+                 << "平均" << (stat.paintCount ? stat.totalPaintUs / qint64(stat.paintCount) : 0) << "us";
+        if (stat.boundsUpdates > 0) {
+            qDebug() << "Live2D 包围盒:" << it.key() << "信号" << stat.boundsUpdates
+                     << "调整" << stat.boundsFits << "省去" << stat.resizesAvoided;
+        }
+    }
+
+    const WindowRecognitionService::MetadataStats windowStats = WindowRecognitionService::metadataStats();
+    if (windowStats.classHits + windowStats.classMisses + windowStats.processHits + windowStats.processMisses > 0) {
+        qDebug() << "窗口元数据缓存: 类名命中" << windowStats.classHits << "未命中" << windowStats.classMisses
+                 << "进程名命中" << windowStats.processHits << "未命中" << windowStats.processMisses;
+    }
 }
 
 void StickerManager::onConfigsRequested()
@@ -5,7 +5,8 @@
 #include <QMutex>
 #include <QTimer>
 #include <QList>
-#include "StickerData.h"
+#include <QHash>
+#include "stickerdata.h"
 #include "stickerfollowcontroller.h"
 #include "stickerassetstore.h"
 #include "stickerrepository.h"
@@ -38,6 +39,8 @@ public:
     // 获取信息
     QList<StickerConfig> getAllConfigs() const;
     StickerWidget* getStickerWidget(const QString &stickerId) const;
+    QHash<QString, qint64> residentBytesReport() const;
+    QHash<QString, StickerWidget::PaintStats> paintStatsReport() const;
 
 public slots:
     void createSticker();
@@ -77,6 +80,7 @@ private:
     StickerRuntime m_runtime;
     StickerFollowController m_followController;
     QList<StickerConfig> m_configs;
+    StickerRuntimeSettings m_runtimeSettings;
     mutable QMutex m_mutex;
 
     QTimer *m_autoSaveTimer;
@@ -0,0 +1,117 @@
+#include "stickermemorybudget.h"
+#include <QDebug>
+
+namespace {
+const qint64 kDefaultBudgetBytes = qint64(256) * 1024 * 1024;
+
+qint64 clientBytes(const StickerMemoryBudget::Callbacks &callbacks)
+{
+    return callbacks.residentBytes ? callbacks.residentBytes() : 0;
+}
+}
+
+StickerMemoryBudget &StickerMemoryBudget::instance()
+{
+    static StickerMemoryBudget s_instance;
+    return s_instance;
+}
+
+StickerMemoryBudget::StickerMemoryBudget()
+    : m_budgetBytes(kDefaultBudgetBytes)
+    , m_enforcing(false)
+{
+}
+
+void StickerMemoryBudget::setBudgetBytes(qint64 bytes)
+{
+    m_budgetBytes = qMax<qint64>(0, bytes);
+    enforce();
+}
+
+qint64 StickerMemoryBudget::budgetBytes() const
+{
+    return m_budgetBytes;
+}
+
+void StickerMemoryBudget::registerClient(const void *client, Callbacks callbacks)
+{
+    if (!client) {
+        return;
+    }
+    m_clients.insert(client, std::move(callbacks));
+}
+
+void StickerMemoryBudget::unregisterClient(const void *client)
+{
+    m_clients.remove(client);
+    m_hiddenLru.removeAll(client);
+}
+
+void StickerMemoryBudget::markHidden(const void *client)
+{
+    if (!m_clients.contains(client) || m_hiddenLru.contains(client)) {
+        return;
+    }
+    m_hiddenLru.append(client);
+    enforce();
+}
+
+void StickerMemoryBudget::markVisible(const void *client)
+{
+    if (m_hiddenLru.removeAll(client) == 0) {
+        return;
+    }
+    enforce();
+}
+
+void StickerMemoryBudget::enforce()
+{
+    // 回收回调可能间接触发可见性变化，避免重入
+    if (m_enforcing || m_hiddenLru.isEmpty()) {
+        return;
+    }
+    m_enforcing = true;
+
+    qint64 total = totalResidentBytes();
+    int index = 0;
+    while (total > m_budgetBytes && index < m_hiddenLru.size()) {
+        const void *client = m_hiddenLru.at(index++);
+        auto it = m_clients.constFind(client);
+        if (it == m_clients.constEnd()) {
+            continue;
+        }
+        const qint64 before = clientBytes(it.value());
+        if (before <= 0 || !it.value().evict) {
+            continue;
+        }
+        it.value().evict();
+        const qint64 freed = before - clientBytes(it.value());
+        total -= freed;
+        qDebug() << "内存预算回收贴纸:" << (it.value().stickerId ? it.value().stickerId() : QString())
+                 << "释放字节:" << freed;
+    }
+
+    m_enforcing = false;
+}
+
+qint64 StickerMemoryBudget::totalResidentBytes() const
+{
+    qint64 total = 0;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        total += clientBytes(it.value());
+    }
+    return total;
+}
+
+QList<StickerMemoryBudget::Entry> StickerMemoryBudget::report() const
+{
+    QList<Entry> entries;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        Entry entry;
+        entry.stickerId = it.value().stickerId ? it.value().stickerId() : QString();
+        entry.residentBytes = clientBytes(it.value());
+        entry.hidden = m_hiddenLru.contains(it.key());
+        entries.append(entry);
+    }
+    return entries;
+}
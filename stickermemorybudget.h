@@ -0,0 +1,50 @@
+#ifndef STICKERMEMORYBUDGET_H
+#define STICKERMEMORYBUDGET_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <functional>
+
+// 全局贴纸内存预算：常驻字节超出预算时，按 LRU 回收隐藏贴纸的栅格/遮罩/Live2D 资源
+class StickerMemoryBudget
+{
+public:
+    struct Callbacks {
+        std::function<QString()> stickerId;
+        std::function<qint64()> residentBytes;
+        std::function<void()> evict;
+    };
+
+    struct Entry {
+        QString stickerId;
+        qint64 residentBytes = 0;
+        bool hidden = false;
+    };
+
+    static StickerMemoryBudget &instance();
+
+    void setBudgetBytes(qint64 bytes);
+    qint64 budgetBytes() const;
+
+    void registerClient(const void *client, Callbacks callbacks);
+    void unregisterClient(const void *client);
+
+    // 隐藏时进入 LRU 队尾，显示时移出；两者都会触发预算检查
+    void markHidden(const void *client);
+    void markVisible(const void *client);
+    void enforce();
+
+    qint64 totalResidentBytes() const;
+    QList<Entry> report() const;
+
+private:
+    StickerMemoryBudget();
+
+    QHash<const void*, Callbacks> m_clients;
+    QList<const void*> m_hiddenLru;
+    qint64 m_budgetBytes;
+    bool m_enforcing;
+};
+
+#endif // STICKERMEMORYBUDGET_H
@@ -0,0 +1,139 @@
+#include "stickerocclusiontracker.h"
+#include <QCoreApplication>
+#include <QList>
+
+namespace {
+const int kOcclusionCheckMs = 250;
+}
+
+StickerOcclusionTracker *StickerOcclusionTracker::instance()
+{
+    static StickerOcclusionTracker *s_instance = new StickerOcclusionTracker(QCoreApplication::instance());
+    return s_instance;
+}
+
+StickerOcclusionTracker::StickerOcclusionTracker(QObject *parent)
+    : QObject(parent)
+    , m_events(WindowEventSource::createNative(this))
+{
+    m_timer.setInterval(kOcclusionCheckMs);
+    connect(&m_timer, &QTimer::timeout, this, &StickerOcclusionTracker::onTick);
+    // 不支持窗口事件的平台只靠缓存过期
+    if (m_events) {
+        connect(m_events, &WindowEventSource::windowChanged, this, &StickerOcclusionTracker::onWindowChanged);
+    }
+}
+
+void StickerOcclusionTracker::registerClient(const void *client, Callbacks callbacks)
+{
+    if (!client) {
+        return;
+    }
+    Client entry;
+    entry.callbacks = std::move(callbacks);
+    m_clients.insert(client, entry);
+}
+
+void StickerOcclusionTracker::unregisterClient(const void *client)
+{
+    if (m_clients.remove(client) > 0) {
+        updateTimer();
+    }
+}
+
+bool StickerOcclusionTracker::isOccluded(const void *client)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end()) {
+        return false;
+    }
+    const WindowHandle handle = it->callbacks.nativeHandle ? it->callbacks.nativeHandle() : 0;
+    if (handle == 0) {
+        return false;
+    }
+    // 缓存过期或窗口刚重建时整批重算，其他贴纸在本拍内直接取结果
+    if (!m_clock.isValid() || m_clock.elapsed() >= kOcclusionCheckMs || handle != it->handle) {
+        refresh();
+        it = m_clients.find(client);
+    }
+    return it->occluded;
+}
+
+void StickerOcclusionTracker::setDeferred(const void *client, bool deferred)
+{
+    auto it = m_clients.find(client);
+    if (it == m_clients.end() || it->deferred == deferred) {
+        return;
+    }
+    it->deferred = deferred;
+    updateTimer();
+}
+
+void StickerOcclusionTracker::invalidate()
+{
+    m_clock.invalidate();
+}
+
+void StickerOcclusionTracker::onTick()
+{
+    refresh();
+    // 回调里可能取消推迟或注销，先取出本拍要通知的
+    QList<std::function<void()>> rechecks;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it->deferred && it->callbacks.recheck) {
+            rechecks.append(it->callbacks.recheck);
+        }
+    }
+    for (const auto &recheck : rechecks) {
+        recheck();
+    }
+}
+
+// 移动只会报告关注的窗口，这里不关注任何窗口：自身贴纸拖动、跟随时不作废，靠缓存过期
+void StickerOcclusionTracker::onWindowChanged(WindowHandle handle, WindowEventSource::Event event)
+{
+    Q_UNUSED(handle)
+    if (event != WindowEventSource::Event::Moved) {
+        invalidate();
+    }
+}
+
+void StickerOcclusionTracker::refresh()
+{
+    QList<WindowHandle> handles;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        it->handle = it->callbacks.nativeHandle ? it->callbacks.nativeHandle() : 0;
+        if (it->handle != 0) {
+            handles.append(it->handle);
+        }
+    }
+    const QSet<WindowHandle> occluded = WindowRecognitionService::occludedWindows(handles);
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        it->occluded = it->handle != 0 && occluded.contains(it->handle);
+    }
+    m_clock.restart();
+}
+
+bool StickerOcclusionTracker::anyDeferred() const
+{
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it->deferred) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 没有推迟的贴纸时既不复查也不挂接全局窗口事件，查询只靠缓存过期
+void StickerOcclusionTracker::updateTimer()
+{
+    const bool deferred = anyDeferred();
+    if (deferred && !m_timer.isActive()) {
+        m_timer.start();
+    } else if (!deferred) {
+        m_timer.stop();
+    }
+    if (m_events) {
+        m_events->setWatchedWindows(QSet<WindowHandle>(), deferred);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef STICKEROCCLUSIONTRACKER_H
+#define STICKEROCCLUSIONTRACKER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include "windoweventsource.h"
+#include "windowrecognitionservice.h"
+
+// 全局遮挡检测：所有独立窗口贴纸共用一次 Z 序遍历，结果按拍缓存；
+// 有贴纸因遮挡推迟了重绘时才定时复查并挂接窗口事件（显隐、最小化、前台切换时作废缓存），
+// 复查一拍只遍历一次
+class StickerOcclusionTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Callbacks {
+        // 没有独立原生窗口（合成、未创建）时返回 0，不参与检测
+        std::function<WindowHandle()> nativeHandle;
+        // 推迟重绘的贴纸在每拍复查后收到通知
+        std::function<void()> recheck;
+    };
+
+    static StickerOcclusionTracker *instance();
+
+    void registerClient(const void *client, Callbacks callbacks);
+    void unregisterClient(const void *client);
+
+    bool isOccluded(const void *client);
+    // 标记推迟了重绘，等待遮挡解除后补画
+    void setDeferred(const void *client, bool deferred);
+    // 丢弃缓存，下次查询重新遍历
+    void invalidate();
+
+private slots:
+    void onTick();
+    void onWindowChanged(WindowHandle handle, WindowEventSource::Event event);
+
+private:
+    explicit StickerOcclusionTracker(QObject *parent = nullptr);
+
+    struct Client {
+        Callbacks callbacks;
+        WindowHandle handle = 0;
+        bool occluded = false;
+        bool deferred = false;
+    };
+
+    void refresh();
+    bool anyDeferred() const;
+    void updateTimer();
+
+    QHash<const void*, Client> m_clients;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    WindowEventSource *m_events;
+};
+
+#endif // STICKEROCCLUSIONTRACKER_H
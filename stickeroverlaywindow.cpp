@@ -0,0 +1,240 @@
+#include "stickeroverlaywindow.h"
+#include <QContextMenuEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScreen>
+#include <QWheelEvent>
+#include "stickerwidget.h"
+
+StickerOverlayWindow::StickerOverlayWindow(QScreen *screen, StickerCompositor::Layer layer)
+    : QWidget(nullptr)
+    , m_screen(screen)
+    , m_layer(layer)
+{
+    Qt::WindowFlags flags = Qt::FramelessWindowHint | Qt::Tool;
+    flags |= layer == StickerCompositor::Layer::TopClickThrough
+        ? Qt::WindowStaysOnTopHint
+        : Qt::WindowStaysOnBottomHint;
+    setWindowFlags(flags);
+    setAttribute(Qt::WA_TranslucentBackground, true);
+    setAttribute(Qt::WA_ShowWithoutActivating, true);
+    setAttribute(Qt::WA_TransparentForMouseEvents, !isInteractive());
+    setFocusPolicy(Qt::NoFocus);
+    setMouseTracking(isInteractive());
+    setGeometry(screen->geometry());
+
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(0);
+    connect(&m_syncTimer, &QTimer::timeout, this, &StickerOverlayWindow::sync);
+    connect(screen, &QScreen::geometryChanged, this, [this](const QRect &geometry) {
+        setGeometry(geometry);
+        scheduleSync();
+    });
+}
+
+QScreen *StickerOverlayWindow::targetScreen() const
+{
+    return m_screen;
+}
+
+StickerCompositor::Layer StickerOverlayWindow::layer() const
+{
+    return m_layer;
+}
+
+bool StickerOverlayWindow::isInteractive() const
+{
+    return m_layer == StickerCompositor::Layer::DesktopInteractive;
+}
+
+void StickerOverlayWindow::scheduleSync()
+{
+    if (!m_syncTimer.isActive()) {
+        m_syncTimer.start();
+    }
+}
+
+bool StickerOverlayWindow::hasShownStickers() const
+{
+    const QRect screenRect = geometry();
+    const QList<StickerWidget*> stickers = StickerCompositor::instance()->stickers(m_layer);
+    for (StickerWidget *sticker : stickers) {
+        if (sticker->isShownOnScreen() && sticker->geometry().intersects(screenRect)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 没有可见贴纸时隐藏整层；可交互层用各贴纸 Alpha 命中区域的并集作遮罩，
+// 透明像素处的点击落到下面的窗口
+void StickerOverlayWindow::sync()
+{
+    QRegion region;
+    if (isInteractive()) {
+        const QList<StickerWidget*> stickers = StickerCompositor::instance()->stickers(m_layer);
+        for (StickerWidget *sticker : stickers) {
+            if (sticker->isShownOnScreen()) {
+                region += sticker->hitRegion().translated(sticker->pos() - pos());
+            }
+        }
+        region &= rect();
+    }
+
+    const bool shouldShow = isInteractive() ? !region.isEmpty() : hasShownStickers();
+    if (!shouldShow) {
+        if (isVisible()) {
+            hide();
+        }
+        return;
+    }
+
+    if (isInteractive()) {
+        setMask(region);
+    }
+    if (!isVisible()) {
+        show();
+    }
+}
+
+void StickerOverlayWindow::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect exposed = event->rect();
+    const QList<StickerWidget*> stickers = StickerCompositor::instance()->stickers(m_layer);
+    for (StickerWidget *sticker : stickers) {
+        if (!sticker->isShownOnScreen()) {
+            continue;
+        }
+        const QRect target = sticker->geometry().translated(-pos());
+        const QRect dirty = target & exposed;
+        if (dirty.isEmpty()) {
+            continue;
+        }
+        painter.save();
+        painter.setClipRect(dirty);
+        painter.translate(target.topLeft());
+        painter.setOpacity(sticker->windowOpacity());
+        sticker->paintContent(painter, dirty.translated(-target.topLeft()));
+        painter.restore();
+    }
+}
+
+StickerWidget *StickerOverlayWindow::targetAt(const QPoint &globalPos) const
+{
+    if (m_grabbed) {
+        return m_grabbed;
+    }
+    return StickerCompositor::instance()->stickerAt(m_layer, globalPos);
+}
+
+// 按贴纸自身坐标重建事件后交给贴纸处理，拖动/编辑/触发器逻辑保持不变
+void StickerOverlayWindow::forwardMouseEvent(QMouseEvent *event)
+{
+    const QPoint globalPos = event->globalPos();
+    StickerWidget *sticker = targetAt(globalPos);
+    if (event->type() == QEvent::MouseMove && !m_grabbed) {
+        updateHover(sticker, globalPos);
+    }
+    if (!sticker) {
+        event->ignore();
+        return;
+    }
+
+    if (event->type() == QEvent::MouseButtonPress) {
+        m_grabbed = sticker;
+    }
+
+    const QPointF localPos = event->screenPos() - QPointF(sticker->pos());
+    QMouseEvent forwarded(event->type(), localPos, localPos, event->screenPos(),
+                          event->button(), event->buttons(), event->modifiers());
+    sticker->dispatchForwardedEvent(&forwarded);
+    setCursor(sticker->cursor());
+
+    if (event->type() == QEvent::MouseButtonRelease && event->buttons() == Qt::NoButton) {
+        m_grabbed.clear();
+        updateHover(StickerCompositor::instance()->stickerAt(m_layer, globalPos), globalPos);
+    }
+    event->setAccepted(forwarded.isAccepted());
+}
+
+void StickerOverlayWindow::updateHover(StickerWidget *sticker, const QPoint &globalPos)
+{
+    if (m_hovered == sticker) {
+        return;
+    }
+    if (m_hovered) {
+        QEvent leave(QEvent::Leave);
+        m_hovered->dispatchForwardedEvent(&leave);
+    }
+    m_hovered = sticker;
+    if (m_hovered) {
+        const QPointF localPos = QPointF(globalPos - m_hovered->pos());
+        QEnterEvent enter(localPos, localPos, QPointF(globalPos));
+        m_hovered->dispatchForwardedEvent(&enter);
+        setCursor(m_hovered->cursor());
+    } else {
+        unsetCursor();
+    }
+}
+
+void StickerOverlayWindow::mousePressEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void StickerOverlayWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void StickerOverlayWindow::mouseReleaseEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void StickerOverlayWindow::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void StickerOverlayWindow::wheelEvent(QWheelEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const QPointF globalPosF = event->globalPosition();
+#else
+    const QPointF globalPosF = event->globalPosF();
+#endif
+    StickerWidget *sticker = targetAt(globalPosF.toPoint());
+    if (!sticker) {
+        event->ignore();
+        return;
+    }
+    const QPointF localPos = globalPosF - QPointF(sticker->pos());
+    QWheelEvent forwarded(localPos, globalPosF, event->pixelDelta(), event->angleDelta(),
+                          event->buttons(), event->modifiers(), event->phase(), event->inverted());
+    sticker->dispatchForwardedEvent(&forwarded);
+    event->setAccepted(forwarded.isAccepted());
+}
+
+void StickerOverlayWindow::contextMenuEvent(QContextMenuEvent *event)
+{
+    StickerWidget *sticker = targetAt(event->globalPos());
+    if (!sticker) {
+        event->ignore();
+        return;
+    }
+    QContextMenuEvent forwarded(event->reason(), event->globalPos() - sticker->pos(),
+                                event->globalPos(), event->modifiers());
+    sticker->dispatchForwardedEvent(&forwarded);
+    event->setAccepted(forwarded.isAccepted());
+}
+
+void StickerOverlayWindow::leaveEvent(QEvent *event)
+{
+    Q_UNUSED(event)
+    if (!m_grabbed) {
+        updateHover(nullptr, QPoint());
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef STICKEROVERLAYWINDOW_H
+#define STICKEROVERLAYWINDOW_H
+
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+#include "stickercompositor.h"
+
+class QScreen;
+
+// 单屏单层的透明叠加窗口：绘制所属层的合成贴纸，并把鼠标事件转发给命中的贴纸
+class StickerOverlayWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    StickerOverlayWindow(QScreen *screen, StickerCompositor::Layer layer);
+
+    QScreen *targetScreen() const;
+    StickerCompositor::Layer layer() const;
+    bool isInteractive() const;
+
+    // 合并同一事件循环内的多次显隐/命中区域变化
+    void scheduleSync();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    bool hasShownStickers() const;
+    void sync();
+    StickerWidget *targetAt(const QPoint &globalPos) const;
+    void forwardMouseEvent(QMouseEvent *event);
+    void updateHover(StickerWidget *sticker, const QPoint &globalPos);
+
+    QScreen *m_screen;
+    StickerCompositor::Layer m_layer;
+    QPointer<StickerWidget> m_grabbed;
+    QPointer<StickerWidget> m_hovered;
+    QTimer m_syncTimer;
+};
+
+#endif // STICKEROVERLAYWINDOW_H
@@ -0,0 +1,193 @@
+#include "stickerpresenter.h"
+#include "stickercompositor.h"
+#include "stickerocclusiontracker.h"
+#include "stickerrastersurface.h"
+#include "stickerwidget.h"
+
+StickerPresenter::StickerPresenter(StickerWidget *owner)
+    : m_owner(owner)
+    , m_presentation(Presentation::Widget)
+    , m_surface(nullptr)
+    , m_repaintDeferred(false)
+    , m_offscreenDeferred(false)
+    , m_skippedCount(0)
+{
+    StickerOcclusionTracker::Callbacks occlusionCallbacks;
+    occlusionCallbacks.nativeHandle = [this]() { return occlusionHandle(); };
+    occlusionCallbacks.recheck = [this]() { onRecheck(); };
+    StickerOcclusionTracker::instance()->registerClient(this, std::move(occlusionCallbacks));
+}
+
+StickerPresenter::~StickerPresenter()
+{
+    StickerOcclusionTracker::instance()->unregisterClient(this);
+    delete m_surface;
+    m_surface = nullptr;
+}
+
+void StickerPresenter::setCallbacks(Callbacks callbacks)
+{
+    m_callbacks = std::move(callbacks);
+}
+
+StickerPresenter::Presentation StickerPresenter::presentation() const
+{
+    return m_presentation;
+}
+
+bool StickerPresenter::isComposited() const
+{
+    return m_presentation == Presentation::Composited;
+}
+
+StickerRasterSurface *StickerPresenter::surface() const
+{
+    return m_surface;
+}
+
+bool StickerPresenter::setPresentation(Presentation presentation, bool shown)
+{
+    if (m_presentation == presentation) {
+        if (m_surface) {
+            m_surface->syncWindowState();
+        }
+        return false;
+    }
+
+    m_presentation = presentation;
+    if (presentation == Presentation::RasterSurface) {
+        m_surface = new StickerRasterSurface(m_owner);
+        m_surface->setVisible(shown);
+    }
+    m_owner->QWidget::setVisible(presentation == Presentation::Widget && shown);
+    if (presentation != Presentation::RasterSurface && m_surface) {
+        delete m_surface;
+        m_surface = nullptr;
+    }
+    return true;
+}
+
+bool StickerPresenter::isShownOnScreen() const
+{
+    if (m_presentation != Presentation::Widget) {
+        return m_callbacks.wantsVisible && m_callbacks.wantsVisible();
+    }
+    return m_owner->isVisible();
+}
+
+WindowHandle StickerPresenter::occlusionHandle() const
+{
+    // 叠加层由合成器统一裁剪，只判断独立窗口
+    if (m_presentation == Presentation::Composited) {
+        return 0;
+    }
+    if (m_surface) {
+        return m_surface->handle() ? WindowHandle(m_surface->winId()) : 0;
+    }
+    return m_owner->testAttribute(Qt::WA_WState_Created) ? WindowHandle(m_owner->winId()) : 0;
+}
+
+// 合成模式下转成叠加层上的脏区域（全局坐标），否则走对应窗口的 update
+void StickerPresenter::requestRepaint(const QRegion &region)
+{
+    if (region.isEmpty()) {
+        return;
+    }
+    if (isShownOnScreen() && isPaintSuppressed()) {
+        ++m_skippedCount;
+        defer();
+        return;
+    }
+
+    switch (m_presentation) {
+    case Presentation::Composited:
+        for (const QRect &rect : region) {
+            StickerCompositor::instance()->markDirty(m_owner, rect.translated(m_owner->pos()));
+        }
+        break;
+    case Presentation::RasterSurface:
+        m_surface->update(region);
+        break;
+    case Presentation::Widget:
+        m_owner->update(region);
+        break;
+    }
+}
+
+bool StickerPresenter::isPaintSuppressed()
+{
+    if (isOffscreen()) {
+        return true;
+    }
+    if (m_presentation == Presentation::Composited) {
+        return false;
+    }
+    return StickerOcclusionTracker::instance()->isOccluded(this);
+}
+
+void StickerPresenter::deferUntilUncovered()
+{
+    defer();
+}
+
+void StickerPresenter::geometryChanged()
+{
+    if (m_offscreenDeferred && isShownOnScreen() && !isOffscreen()) {
+        m_offscreenDeferred = false;
+        resume();
+    }
+}
+
+quint64 StickerPresenter::skippedCount() const
+{
+    return m_skippedCount;
+}
+
+bool StickerPresenter::isOffscreen() const
+{
+    const QRect visible = m_callbacks.visibleRect ? m_callbacks.visibleRect() : m_owner->rect();
+    return visible.isEmpty();
+}
+
+// 离屏只等移动/屏幕变化，不让遮挡检测为它定时复查
+void StickerPresenter::defer()
+{
+    if (isOffscreen()) {
+        m_offscreenDeferred = true;
+        setDeferred(false);
+    } else {
+        setDeferred(true);
+    }
+}
+
+void StickerPresenter::setDeferred(bool deferred)
+{
+    if (m_repaintDeferred == deferred) {
+        return;
+    }
+    m_repaintDeferred = deferred;
+    StickerOcclusionTracker::instance()->setDeferred(this, deferred);
+}
+
+void StickerPresenter::onRecheck()
+{
+    if (!isShownOnScreen()) {
+        // 重新显示时会整窗重绘
+        setDeferred(false);
+        return;
+    }
+    if (isOffscreen()) {
+        defer();
+    } else if (!isPaintSuppressed()) {
+        setDeferred(false);
+        resume();
+    }
+}
+
+void StickerPresenter::resume()
+{
+    if (m_callbacks.uncovered) {
+        m_callbacks.uncovered();
+    }
+    requestRepaint(QRegion(m_owner->rect()));
+}
@@ -0,0 +1,68 @@
+#ifndef STICKERPRESENTER_H
+#define STICKERPRESENTER_H
+
+#include <QRect>
+#include <QRegion>
+#include <functional>
+#include "windowrecognitionservice.h"
+
+class StickerRasterSurface;
+class StickerWidget;
+
+// 贴纸的显示方式与重绘调度：完整 QWidget 窗口、轻量 QRasterWindow，或由 StickerCompositor 合成到叠加层；
+// 后两种情况下贴纸自身的 QWidget 不创建原生窗口。离屏或被完全遮挡时重绘只记下：
+// 被遮挡的由全局遮挡检测复查后补画，离屏的等移动或屏幕变化后补画，贴纸本身不持有定时器
+class StickerPresenter
+{
+public:
+    enum class Presentation {
+        Widget,
+        RasterSurface,
+        Composited
+    };
+
+    struct Callbacks {
+        std::function<bool()> wantsVisible;     // 配置可见且未被运行时隐藏
+        std::function<QRect()> visibleRect;     // 屏幕内的部分（贴纸坐标），为空即离屏
+        std::function<void()> uncovered;        // 推迟期间遮挡解除，补画之前调用
+    };
+
+    explicit StickerPresenter(StickerWidget *owner);
+    ~StickerPresenter();
+
+    void setCallbacks(Callbacks callbacks);
+
+    Presentation presentation() const;
+    bool isComposited() const;
+    StickerRasterSurface *surface() const;
+    // 先建好新的显示目标再拆旧的，避免中途闪烁；未变化时只同步轻量窗口状态并返回 false
+    bool setPresentation(Presentation presentation, bool shown);
+    bool isShownOnScreen() const;
+    // 独立原生窗口的句柄；合成或尚未创建时为 0，不会触发创建
+    WindowHandle occlusionHandle() const;
+
+    void requestRepaint(const QRegion &region);
+    bool isPaintSuppressed();
+    // 贴纸移动或屏幕布局变化后调用，离屏期间推迟的重绘在回到屏幕内时补上
+    void geometryChanged();
+    // 不经过重绘请求的内容（视频解码）暂停后，同样等遮挡解除时通知
+    void deferUntilUncovered();
+    quint64 skippedCount() const;
+
+private:
+    bool isOffscreen() const;
+    void defer();
+    void setDeferred(bool deferred);
+    void onRecheck();
+    void resume();
+
+    StickerWidget *m_owner;
+    Callbacks m_callbacks;
+    Presentation m_presentation;
+    StickerRasterSurface *m_surface;
+    bool m_repaintDeferred;         // 被遮挡推迟，遮挡检测定时复查
+    bool m_offscreenDeferred;       // 离屏推迟，不占用复查定时器
+    quint64 m_skippedCount;
+};
+
+#endif // STICKERPRESENTER_H
@@ -0,0 +1,77 @@
+#include "stickerrastersurface.h"
+#include <QContextMenuEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QSurfaceFormat>
+#include "stickerwidget.h"
+
+StickerRasterSurface::StickerRasterSurface(StickerWidget *sticker)
+    : QRasterWindow(nullptr)
+    , m_sticker(sticker)
+{
+    // 带 Alpha 的无边框窗口在 Windows 上走分层窗口，与 WA_TranslucentBackground 效果一致
+    QSurfaceFormat surfaceFormat = format();
+    surfaceFormat.setAlphaBufferSize(8);
+    setFormat(surfaceFormat);
+    syncWindowState();
+}
+
+void StickerRasterSurface::syncWindowState()
+{
+    Qt::WindowFlags flags = m_sticker->windowFlags();
+    if (m_sticker->testAttribute(Qt::WA_TransparentForMouseEvents)) {
+        flags |= Qt::WindowTransparentForInput;
+    }
+    flags |= Qt::WindowDoesNotAcceptFocus;
+    if (this->flags() != flags) {
+        setFlags(flags);
+    }
+    if (geometry() != m_sticker->geometry()) {
+        setGeometry(m_sticker->geometry());
+    }
+    setOpacity(m_sticker->windowOpacity());
+}
+
+void StickerRasterSurface::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(event->rect(), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(event->rect());
+    m_sticker->paintContent(painter, event->rect());
+}
+
+// 窗口与贴纸几何一致，输入事件可直接交给贴纸处理
+bool StickerRasterSurface::event(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::Enter:
+    case QEvent::Leave:
+    case QEvent::ContextMenu: {
+        const bool handled = m_sticker->dispatchForwardedEvent(event);
+        setCursor(m_sticker->cursor());
+#ifndef Q_OS_WIN
+        // 非 Windows 平台不会为 QWindow 生成右键菜单事件，按下右键时补发
+        if (event->type() == QEvent::MouseButtonPress) {
+            QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+            if (mouseEvent->button() == Qt::RightButton) {
+                QContextMenuEvent menuEvent(QContextMenuEvent::Mouse, mouseEvent->pos(),
+                                            mouseEvent->globalPos(), mouseEvent->modifiers());
+                m_sticker->dispatchForwardedEvent(&menuEvent);
+            }
+        }
+#endif
+        return handled;
+    }
+    default:
+        break;
+    }
+    return QRasterWindow::event(event);
+}
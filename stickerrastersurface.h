@@ -0,0 +1,28 @@
+#ifndef STICKERRASTERSURFACE_H
+#define STICKERRASTERSURFACE_H
+
+#include <QRasterWindow>
+
+class StickerWidget;
+
+// 非编辑状态下图片贴纸的轻量原生窗口：只有 QWindow + QBackingStore，
+// 绘制和输入都转交给贴纸，贴纸自身的 QWidget 不再创建原生窗口
+class StickerRasterSurface : public QRasterWindow
+{
+    Q_OBJECT
+
+public:
+    explicit StickerRasterSurface(StickerWidget *sticker);
+
+    // 从贴纸同步窗口标志、几何、不透明度
+    void syncWindowState();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    StickerWidget *m_sticker;
+};
+
+#endif // STICKERRASTERSURFACE_H
@@ -0,0 +1,562 @@
+#include "stickerrenderbenchmark.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QRadialGradient>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include "stickercompositor.h"
+#include "stickereffectstage.h"
+#include "stickerfollowcontroller.h"
+#include "stickergeometrybatch.h"
+#include "stickerimage.h"
+#include "stickerrenderer.h"
+#include "stickerruntime.h"
+#include "stickertransformlayout.h"
+#include "stickerwidget.h"
+#include "windoweventsource.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#include <unistd.h>
+#endif
+
+namespace {
+const int kFollowEventTimeoutMs = 1000;
+
+qint64 elapsedUs(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1000;
+}
+
+qint64 percentile(QVector<qint64> samples, double ratio)
+{
+    if (samples.isEmpty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const int index = qBound(0, int(ratio * (samples.size() - 1) + 0.5), samples.size() - 1);
+    return samples.at(index);
+}
+
+QString optionValue(const QStringList &arguments, const QString &name)
+{
+    const QString prefix = name + "=";
+    for (const QString &argument : arguments) {
+        if (argument.startsWith(prefix)) {
+            return argument.mid(prefix.size());
+        }
+    }
+    return QString();
+}
+
+// 进程当前常驻内存；取不到时返回 0
+qint64 processResidentBytes()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+QImage targetImage(const QSize &logicalSize, qreal devicePixelRatio)
+{
+    QImage image(logicalSize * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+    return image;
+}
+
+// 跟随目标：屏幕外、全透明且不抢焦点的工具窗口，对窗口识别而言可见
+WindowHandle createFollowTarget(const QRect &rect)
+{
+#ifdef Q_OS_WIN
+    HWND hwnd = CreateWindowExW(WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE | WS_EX_LAYERED, L"STATIC", L"",
+                                WS_POPUP, rect.x(), rect.y(), rect.width(), rect.height(),
+                                nullptr, nullptr, GetModuleHandleW(nullptr), nullptr);
+    if (hwnd) {
+        SetLayeredWindowAttributes(hwnd, 0, 0, LWA_ALPHA);
+        ShowWindow(hwnd, SW_SHOWNOACTIVATE);
+    }
+    return WindowHandle(hwnd);
+#else
+    Q_UNUSED(rect)
+    return 0;
+#endif
+}
+
+void destroyFollowTarget(WindowHandle handle)
+{
+#ifdef Q_OS_WIN
+    if (handle) {
+        DestroyWindow(reinterpret_cast<HWND>(handle));
+    }
+#else
+    Q_UNUSED(handle)
+#endif
+}
+}
+
+// 参数形如 --count=40 --iterations=5 --dpr=2 --image=path
+StickerRenderBenchmark::Options StickerRenderBenchmark::parseArguments(const QStringList &arguments)
+{
+    Options options;
+    bool ok = false;
+    const int count = optionValue(arguments, "--count").toInt(&ok);
+    if (ok && count > 0) {
+        options.stickerCount = count;
+    }
+    const int iterations = optionValue(arguments, "--iterations").toInt(&ok);
+    if (ok && iterations > 0) {
+        options.iterations = iterations;
+    }
+    const double dpr = optionValue(arguments, "--dpr").toDouble(&ok);
+    if (ok && dpr > 0) {
+        options.devicePixelRatio = qBound(0.5, dpr, 4.0);
+    }
+    options.imagePath = optionValue(arguments, "--image");
+    return options;
+}
+
+int StickerRenderBenchmark::run(const Options &options)
+{
+    QTemporaryDir tempDir;
+    QStringList imagePaths;
+    if (!options.imagePath.isEmpty()) {
+        imagePaths.append(options.imagePath);
+    } else {
+        if (!tempDir.isValid()) {
+            QTextStream(stderr) << "无法创建临时目录\n";
+            return 1;
+        }
+        imagePaths = createSyntheticImages(tempDir.path());
+    }
+
+    const QList<StickerConfig> configs = buildLayout(options, imagePaths);
+    QList<Stage> stages;
+    QList<Footprint> footprints;
+    runStages(options, configs, stages);
+    runWidgets(options, configs, stages);
+    runPresentations(options, configs, stages, footprints);
+    const bool batchOk = runGeometryBatch(options, configs, stages);
+    const bool followOk = runFollowEvents(options, configs, stages);
+    printReport(options, stages, footprints);
+    return batchOk && followOk ? 0 : 1;
+}
+
+// 不同尺寸的带 Alpha 渐变圆，覆盖缩放到上限与不缩放两种解码路径
+QStringList StickerRenderBenchmark::createSyntheticImages(const QString &directory)
+{
+    QStringList paths;
+    const int sizes[] = { 256, 512, 1024, 2048 };
+    for (int size : sizes) {
+        QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        QRadialGradient gradient(QPointF(size / 2.0, size / 2.0), size / 2.0);
+        gradient.setColorAt(0.0, QColor(255, 180, 60, 255));
+        gradient.setColorAt(0.7, QColor(60, 140, 255, 200));
+        gradient.setColorAt(1.0, QColor(60, 140, 255, 0));
+        painter.setBrush(gradient);
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(QRectF(size * 0.05, size * 0.1, size * 0.9, size * 0.8));
+        painter.end();
+
+        const QString path = QDir(directory).filePath(QString("sticker_%1.png").arg(size));
+        if (image.save(path)) {
+            paths.append(path);
+        }
+    }
+    return paths;
+}
+
+QList<StickerConfig> StickerRenderBenchmark::buildLayout(const Options &options, const QStringList &imagePaths)
+{
+    QList<StickerConfig> configs;
+    for (int i = 0; i < options.stickerCount; ++i) {
+        StickerConfig config;
+        config.id = QString("benchmark_%1").arg(i);
+        config.name = config.id;
+        config.imagePath = imagePaths.isEmpty() ? QString() : imagePaths.at(i % imagePaths.size());
+        config.position = QPoint((i % 8) * 220, (i / 8) * 220);
+        config.size = QSize(200, 200);
+        config.transform.rotation = (i * 17) % 360;
+        config.transform.scaleX = 0.5 + (i % 5) * 0.25;
+        config.transform.scaleY = config.transform.scaleX;
+        if (i % 4 == 3) {
+            config.transform.shearX = 0.2;
+        }
+        // 每三个贴纸开一组效果，覆盖效果阶段
+        if (i % 3 == 1) {
+            config.effects.outlineEnabled = true;
+            config.effects.outlineWidth = 4;
+        } else if (i % 3 == 2) {
+            config.effects.shadowEnabled = true;
+            config.effects.shadowBlurRadius = 12;
+            config.effects.shadowOffset = QPoint(4, 6);
+        }
+        configs.append(config);
+    }
+    return configs;
+}
+
+// 逐阶段单独计时，直接使用渲染管线各组件
+void StickerRenderBenchmark::runStages(const Options &options, const QList<StickerConfig> &configs,
+                                       QList<Stage> &stages)
+{
+    Stage decode { "decode", {} };
+    Stage layoutStage { "layout", {} };
+    Stage effectsStage { "effects", {} };
+    Stage mask { "mask", {} };
+    Stage paint { "paint", {} };
+    const qreal dpr = options.devicePixelRatio;
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const StickerConfig &config : configs) {
+            StickerImage image(600);
+            QElapsedTimer timer;
+            timer.start();
+            if (config.imagePath.isEmpty() || !image.loadFromPath(config.imagePath)) {
+                image.createDefault();
+            }
+            decode.samplesUs.append(elapsedUs(timer));
+
+            StickerEffectStage effects(&image);
+            effects.setEffects(config.effects);
+            StickerRenderer renderer(&effects);
+
+            StickerTransformLayoutResult layout;
+            timer.restart();
+            const bool laidOut = renderer.calculateLayout(config, layout);
+            layoutStage.samplesUs.append(elapsedUs(timer));
+            if (!laidOut || layout.windowSize.isEmpty()) {
+                continue;
+            }
+
+            timer.restart();
+            effects.pixmap(dpr);
+            effectsStage.samplesUs.append(elapsedUs(timer));
+
+            timer.restart();
+            renderer.buildMask(config, layout.windowSize, dpr);
+            mask.samplesUs.append(elapsedUs(timer));
+
+            QImage target = targetImage(layout.windowSize, dpr);
+            QPainter painter(&target);
+            timer.restart();
+            renderer.paint(painter, config, layout.windowSize);
+            paint.samplesUs.append(elapsedUs(timer));
+        }
+    }
+
+    stages << decode << layoutStage << effectsStage << mask << paint;
+}
+
+// 通过 StickerRuntime 创建真实的 StickerWidget，测量创建与整窗绘制
+void StickerRenderBenchmark::runWidgets(const Options &options, const QList<StickerConfig> &configs,
+                                        QList<Stage> &stages)
+{
+    Stage create { "widget-create", {} };
+    Stage widgetPaint { "widget-paint", {} };
+    const qreal dpr = options.devicePixelRatio;
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        StickerRuntime runtime;
+        QList<StickerWidget*> widgets;
+        for (const StickerConfig &config : configs) {
+            QElapsedTimer timer;
+            timer.start();
+            StickerInstance *instance = runtime.createOrUpdatePrimary(config);
+            create.samplesUs.append(elapsedUs(timer));
+            if (instance && instance->widget) {
+                widgets.append(instance->widget);
+            }
+        }
+
+        for (StickerWidget *widget : widgets) {
+            QImage target = targetImage(widget->size(), dpr);
+            QPainter painter(&target);
+            QElapsedTimer timer;
+            timer.start();
+            widget->paintContent(painter, widget->rect());
+            widgetPaint.samplesUs.append(elapsedUs(timer));
+        }
+        runtime.clear();
+        // 实例用 deleteLater 销毁，没有事件循环时手动投递
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    stages << create << widgetPaint;
+}
+
+// 同一批贴纸分别用完整 QWidget 窗口与 QRasterWindow 轻量窗口显示：
+// 计时每张贴纸的创建（含原生窗口），处理完首次绘制后记录进程常驻内存增量，取各轮平均
+void StickerRenderBenchmark::runPresentations(const Options &options, const QList<StickerConfig> &configs,
+                                              QList<Stage> &stages, QList<Footprint> &footprints)
+{
+    StickerCompositor *compositor = StickerCompositor::instance();
+    const bool rasterSurfaces = compositor->rasterSurfacesEnabled();
+    const bool composited = compositor->isEnabled();
+    compositor->setEnabled(false);
+
+    const struct {
+        const char *name;
+        bool rasterSurfaces;
+    } modes[] = { { "widget", false }, { "raster-surface", true } };
+
+    for (const auto &mode : modes) {
+        Stage create { QString("present-%1-create").arg(mode.name), {} };
+        Footprint footprint;
+        footprint.name = mode.name;
+        footprint.stickers = configs.size();
+        compositor->setRasterSurfacesEnabled(mode.rasterSurfaces);
+
+        for (int iteration = 0; iteration < options.iterations; ++iteration) {
+            QCoreApplication::processEvents();
+            const qint64 before = processResidentBytes();
+            StickerRuntime runtime;
+            for (const StickerConfig &config : configs) {
+                QElapsedTimer timer;
+                timer.start();
+                runtime.createOrUpdatePrimary(config);
+                create.samplesUs.append(elapsedUs(timer));
+            }
+            // 窗口缓冲在首次绘制时分配
+            QCoreApplication::processEvents();
+            footprint.processBytes += processResidentBytes() - before;
+            for (StickerInstance *instance : runtime.instances()) {
+                if (instance->widget) {
+                    footprint.estimatedBytes += instance->widget->residentBytes();
+                }
+            }
+            runtime.clear();
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        }
+
+        if (options.iterations > 0) {
+            footprint.processBytes /= options.iterations;
+            footprint.estimatedBytes /= options.iterations;
+        }
+        stages << create;
+        footprints << footprint;
+    }
+
+    compositor->setRasterSurfacesEnabled(rasterSurfaces);
+    compositor->setEnabled(composited);
+}
+
+// 模拟跟随刷新：一次批量内移动全部贴纸，记录后端应只收到一批且每个原生窗口一条
+bool StickerRenderBenchmark::runGeometryBatch(const Options &options, const QList<StickerConfig> &configs,
+                                              QList<Stage> &stages)
+{
+    Stage batchStage { "geometry-batch", {} };
+    bool ok = true;
+
+    StickerRuntime runtime;
+    StickerGeometryBatch::RecordingBackend recorder;
+    runtime.geometryBatch()->setBackend(&recorder);
+    for (const StickerConfig &config : configs) {
+        runtime.createOrUpdatePrimary(config);
+    }
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        int expected = 0;
+        QList<StickerConfig> moved;
+        for (StickerInstance *instance : runtime.instances()) {
+            if (!instance->widget) {
+                continue;
+            }
+            if (instance->widget->presentation() != StickerWidget::Presentation::Composited
+                && instance->widget->isShownOnScreen()) {
+                ++expected;
+            }
+            StickerConfig config = instance->widget->getConfig();
+            config.position += QPoint(7, 5);
+            moved.append(config);
+        }
+
+        recorder.reset();
+        QElapsedTimer timer;
+        timer.start();
+        runtime.beginGeometryBatch();
+        for (const StickerConfig &config : moved) {
+            runtime.createOrUpdatePrimary(config);
+        }
+        runtime.commitGeometryBatch();
+        batchStage.samplesUs.append(elapsedUs(timer));
+
+        const QList<int> sizes = recorder.batchSizes();
+        if (sizes.size() != 1 || sizes.first() != expected) {
+            QTextStream(stderr) << "批量几何提交数量不符: 期望 1 批 " << expected
+                                << " 条, 实际 " << sizes.size() << " 批 "
+                                << (sizes.isEmpty() ? 0 : sizes.first()) << " 条\n";
+            ok = false;
+        }
+        for (const StickerConfig &config : moved) {
+            StickerWidget *widget = runtime.widget(config.id);
+            if (widget && widget->pos() != config.position) {
+                QTextStream(stderr) << "批量提交后位置未同步: " << config.id << "\n";
+                ok = false;
+            }
+        }
+    }
+
+    runtime.clear();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    stages << batchStage;
+    return ok;
+}
+
+// 两个模板各跟随一个目标窗口，脚本化事件源只向其中一个投递移动：应只局部刷新该模板、不重新枚举、
+// 不改动关注范围；解除另一个模板的目标后关注范围收缩一次，其移动不再报告
+bool StickerRenderBenchmark::runFollowEvents(const Options &options, const QList<StickerConfig> &configs,
+                                             QList<Stage> &stages)
+{
+    const WindowHandle targets[2] = {
+        createFollowTarget(QRect(-4000, -4000, 320, 240)),
+        createFollowTarget(QRect(-3600, -4000, 320, 240))
+    };
+    if (!targets[0] || !targets[1] || configs.size() < 2) {
+        destroyFollowTarget(targets[0]);
+        destroyFollowTarget(targets[1]);
+        QTextStream(stderr) << "跳过跟随事件阶段: 当前平台没有可跟随的窗口\n";
+        return true;
+    }
+
+    Stage eventStage { "follow-event", {} };
+    bool ok = true;
+
+    StickerRuntime runtime;
+    StickerGeometryBatch::RecordingBackend recorder;
+    runtime.geometryBatch()->setBackend(&recorder);
+    WindowEventSource::ScriptedSource source;
+    StickerFollowController controller(&runtime);
+    controller.setEventSource(&source);
+
+    QList<StickerConfig> templates;
+    for (int i = 0; i < 2; ++i) {
+        StickerConfig config = configs.at(i);
+        config.follow.enabled = true;
+        config.follow.batchMode = false;
+        config.follow.pollIntervalMs = 16;
+        runtime.createOrUpdatePrimary(config);
+        templates.append(config);
+    }
+    controller.setTemplates(templates);
+    for (int i = 0; i < 2; ++i) {
+        if (!controller.lockToTargetWindow(templates.at(i).id, targets[i])) {
+            QTextStream(stderr) << "无法锁定跟随目标: " << templates.at(i).id << "\n";
+            ok = false;
+        }
+    }
+    if (source.watchedWindows() != (QSet<WindowHandle>() << targets[0] << targets[1])) {
+        QTextStream(stderr) << "事件源关注范围不符: 期望 2 个目标窗口, 实际 "
+                            << source.watchedWindows().size() << " 个\n";
+        ok = false;
+    }
+
+    for (int iteration = 0; ok && iteration < options.iterations; ++iteration) {
+        source.reset();
+        controller.resetRefreshStats();
+        QElapsedTimer timer;
+        timer.start();
+        if (!source.post(targets[0], WindowEventSource::Event::Moved)) {
+            QTextStream(stderr) << "跟随目标的移动事件未被报告\n";
+            ok = false;
+            break;
+        }
+        // 事件先合并，定时器到期后才刷新
+        while (controller.refreshStats().partialRefreshes == 0 && timer.elapsed() < kFollowEventTimeoutMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+        eventStage.samplesUs.append(elapsedUs(timer));
+
+        const StickerFollowController::RefreshStats stats = controller.refreshStats();
+        if (stats.partialRefreshes != 1 || stats.fullRefreshes != 0 || stats.enumerations != 0
+            || stats.templateRefreshes.size() != 1
+            || stats.templateRefreshes.value(templates.at(0).id) != 1) {
+            QTextStream(stderr) << "移动事件刷新范围不符: 局部 " << stats.partialRefreshes
+                                << " 次, 整体 " << stats.fullRefreshes
+                                << " 次, 枚举 " << stats.enumerations
+                                << " 次, 刷新模板 " << stats.templateRefreshes.size() << " 个\n";
+            ok = false;
+        }
+        if (source.watchUpdates() != 0) {
+            QTextStream(stderr) << "移动事件不应改动事件源关注范围\n";
+            ok = false;
+        }
+    }
+
+    source.reset();
+    controller.clearTarget(templates.at(1).id);
+    if (source.watchUpdates() != 1 || source.watchedWindows() != (QSet<WindowHandle>() << targets[0])) {
+        QTextStream(stderr) << "解除目标后关注范围不符: 更新 " << source.watchUpdates() << " 次\n";
+        ok = false;
+    }
+    if (source.post(targets[1], WindowEventSource::Event::Moved)) {
+        QTextStream(stderr) << "解除目标后仍报告其移动事件\n";
+        ok = false;
+    }
+
+    controller.clear();
+    runtime.clear();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    destroyFollowTarget(targets[0]);
+    destroyFollowTarget(targets[1]);
+    stages << eventStage;
+    return ok;
+}
+
+void StickerRenderBenchmark::printReport(const Options &options, const QList<Stage> &stages,
+                                         const QList<Footprint> &footprints)
+{
+    QTextStream out(stdout);
+    out << "# render-benchmark stickers=" << options.stickerCount
+        << " iterations=" << options.iterations
+        << " dpr=" << options.devicePixelRatio << "\n";
+    out << "stage,samples,total_us,mean_us,p50_us,p95_us,max_us\n";
+    for (const Stage &stage : stages) {
+        qint64 total = 0;
+        for (qint64 sample : stage.samplesUs) {
+            total += sample;
+        }
+        const int count = stage.samplesUs.size();
+        out << stage.name << ","
+            << count << ","
+            << total << ","
+            << (count ? total / count : 0) << ","
+            << percentile(stage.samplesUs, 0.5) << ","
+            << percentile(stage.samplesUs, 0.95) << ","
+            << percentile(stage.samplesUs, 1.0) << "\n";
+    }
+    out << "presentation,stickers,process_kb,process_kb_per_sticker,estimated_kb_per_sticker\n";
+    for (const Footprint &footprint : footprints) {
+        const int count = qMax(1, footprint.stickers);
+        out << footprint.name << ","
+            << footprint.stickers << ","
+            << footprint.processBytes / 1024 << ","
+            << footprint.processBytes / 1024 / count << ","
+            << footprint.estimatedBytes / 1024 / count << "\n";
+    }
+    out.flush();
+}
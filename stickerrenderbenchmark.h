@@ -0,0 +1,52 @@
+#ifndef STICKERRENDERBENCHMARK_H
+#define STICKERRENDERBENCHMARK_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "stickerdata.h"
+
+// 无桌面环境的渲染基准：QT_QPA_PLATFORM=offscreen 下运行独立目标 benchmark/StickerRenderBenchmark，
+// 按合成布局创建贴纸，逐阶段（解码/布局/效果/遮罩/绘制）计时后输出到标准输出；
+// 显示方式阶段分别以完整窗口和轻量窗口创建全部贴纸，对比创建耗时与进程内存增量；批量几何阶段用记录后端核对每批条目数，跟随事件阶段用脚本化事件源核对刷新范围，不符时返回非零
+class StickerRenderBenchmark
+{
+public:
+    struct Options {
+        int stickerCount = 40;
+        int iterations = 5;
+        qreal devicePixelRatio = 1.0;
+        QString imagePath;      // 为空时生成合成图片
+    };
+
+    static Options parseArguments(const QStringList &arguments);
+    static int run(const Options &options);
+
+private:
+    struct Stage {
+        QString name;
+        QVector<qint64> samplesUs;
+    };
+
+    // 一种显示方式下全部贴纸创建并绘制后的内存：进程常驻增量与贴纸自身估算
+    struct Footprint {
+        QString name;
+        int stickers = 0;
+        qint64 processBytes = 0;
+        qint64 estimatedBytes = 0;
+    };
+
+    static QStringList createSyntheticImages(const QString &directory);
+    static QList<StickerConfig> buildLayout(const Options &options, const QStringList &imagePaths);
+    static void runStages(const Options &options, const QList<StickerConfig> &configs, QList<Stage> &stages);
+    static void runWidgets(const Options &options, const QList<StickerConfig> &configs, QList<Stage> &stages);
+    static void runPresentations(const Options &options, const QList<StickerConfig> &configs,
+                                 QList<Stage> &stages, QList<Footprint> &footprints);
+    static bool runGeometryBatch(const Options &options, const QList<StickerConfig> &configs, QList<Stage> &stages);
+    static bool runFollowEvents(const Options &options, const QList<StickerConfig> &configs, QList<Stage> &stages);
+    static void printReport(const Options &options, const QList<Stage> &stages,
+                            const QList<Footprint> &footprints);
+};
+
+#endif // STICKERRENDERBENCHMARK_H
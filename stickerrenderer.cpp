@@ -1,22 +1,55 @@
 #include "stickerrenderer.h"
-#include "stickerimage.h"
+#include "stickereffectstage.h"
+#include "stickertiledimage.h"
 #include <QImage>
+#include <QPaintDevice>
 #include <QPainter>
 #include <QtGlobal>
+#include <QtMath>
 
-StickerRenderer::StickerRenderer(const StickerImage *image)
-    : m_image(image)
+namespace {
+// 遮罩按周期均匀采样的相位数，包含各动作的关键帧时刻
+const int kMotionMaskSamples = 32;
+}
+
+StickerRenderer::StickerRenderer(const StickerEffectStage *source)
+    : m_source(source)
+    , m_tiled(nullptr)
+    , m_lowFidelity(false)
+    , m_motionSourceKey(0)
+    , m_motionMaskSourceKey(0)
+    , m_motionMaskAlpha(false)
+{
+}
+
+void StickerRenderer::setSource(const StickerEffectStage *source)
 {
+    m_source = source;
 }
 
-void StickerRenderer::setImage(const StickerImage *image)
+void StickerRenderer::setTiledSource(const StickerTiledImage *tiled)
 {
-    m_image = image;
+    m_tiled = tiled;
+}
+
+bool StickerRenderer::isTiled() const
+{
+    return m_tiled && !m_tiled->isNull();
+}
+
+void StickerRenderer::setLowFidelity(bool lowFidelity)
+{
+    m_lowFidelity = lowFidelity;
+}
+
+bool StickerRenderer::isLowFidelity() const
+{
+    return m_lowFidelity;
 }
 
 bool StickerRenderer::isReady() const
 {
-    return m_image && !m_image->isNull();
+    return isTiled() || (m_source && !m_source->isNull());
 }
 
 bool StickerRenderer::calculateLayout(const StickerConfig &config, StickerTransformLayoutResult &out) const
@@ -24,10 +57,11 @@ bool StickerRenderer::calculateLayout(const StickerConfig &config, StickerTransf
     if (!isReady()) {
         return false;
     }
-    return StickerTransformLayout::calculate(config, m_image->baseSize(), out);
+    return StickerTransformLayout::calculate(config, sourceBaseSize(), out);
 }
 
-bool StickerRenderer::paint(QPainter &painter, const StickerConfig &config, const QSize &targetSize) const
+bool StickerRenderer::paint(QPainter &painter, const StickerConfig &config, const QSize &targetSize,
+                            const QRect &visibleRect, const QRect &exposedRect) const
 {
     if (!isReady()) {
         return false;
@@ -38,17 +72,169 @@ bool StickerRenderer::paint(QPainter &painter, const StickerConfig &config, cons
         return false;
     }
 
+    if (isTiled()) {
+        const QRect fullRect(QPoint(0, 0), targetSize);
+        QTransform renderTransform = StickerTransformLayout::buildRenderTransform(layout, targetSize);
+        painter.save();
+        painter.setRenderHint(QPainter::Antialiasing,
+                              !m_lowFidelity && renderTransform.type() > QTransform::TxScale);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, !m_lowFidelity);
+        painter.setTransform(renderTransform, true);
+        m_tiled->paint(painter, layout.baseRect,
+                       visibleRect.isValid() ? visibleRect : fullRect,
+                       exposedRect.isValid() ? exposedRect : fullRect);
+        painter.restore();
+        return true;
+    }
+
+    // 按目标设备的像素比取栅格，高 DPI 屏幕不再放大低分辨率位图
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
     QTransform renderTransform = StickerTransformLayout::buildRenderTransform(layout, targetSize);
     painter.save();
+    // 只有旋转/斜切时边缘才需要抗锯齿，轴对齐缩放直接贴图；低保真时全部关闭
+    painter.setRenderHint(QPainter::Antialiasing,
+                          !m_lowFidelity && renderTransform.type() > QTransform::TxScale);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, !m_lowFidelity);
     painter.setTransform(renderTransform, true);
-    painter.drawPixmap(layout.baseRect, m_image->pixmap(), m_image->sourceRect());
+    painter.drawPixmap(layout.baseRect, m_source->pixmap(dpr), m_source->sourceRect(dpr));
     painter.restore();
     return true;
 }
 
-QBitmap StickerRenderer::buildMask(const StickerConfig &config, const QSize &targetSize) const
+bool StickerRenderer::paintMotion(QPainter &painter, const StickerConfig &config, const QSize &targetSize,
+                                  const StickerMotionFrame &frame) const
 {
-    if (!isReady()) {
+    if (!isReady() || isTiled()) {
+        return false;
+    }
+
+    StickerTransformLayoutResult layout;
+    if (!calculateLayout(config, layout)) {
+        return false;
+    }
+
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
+    const QPixmap source = m_source->pixmap(dpr);
+    // 源图（视频帧/效果结果）、静态变换或像素比变化时才重建
+    if (m_motionRaster.isNull()
+        || m_motionSourceKey != source.cacheKey()
+        || m_motionTransform != layout.localTransform
+        || !qFuzzyCompare(m_motionRaster.devicePixelRatio(), dpr)) {
+        QPixmap raster(qMax(1, qCeil(layout.bounds.width() * dpr)),
+                       qMax(1, qCeil(layout.bounds.height() * dpr)));
+        raster.setDevicePixelRatio(dpr);
+        raster.fill(Qt::transparent);
+        QPainter rasterPainter(&raster);
+        rasterPainter.setRenderHint(QPainter::Antialiasing,
+                                    layout.localTransform.type() > QTransform::TxScale);
+        rasterPainter.setRenderHint(QPainter::SmoothPixmapTransform);
+        rasterPainter.translate(-layout.bounds.topLeft());
+        rasterPainter.setTransform(layout.localTransform, true);
+        rasterPainter.drawPixmap(layout.baseRect, source, m_source->sourceRect(dpr));
+        rasterPainter.end();
+
+        m_motionRaster = raster;
+        m_motionRasterOrigin = layout.bounds.topLeft();
+        m_motionTransform = layout.localTransform;
+        m_motionSourceKey = source.cacheKey();
+    }
+
+    // 动作变换绕内容中心，再把整个周期的外接范围居中到窗口
+    const QPointF delta = QPointF(targetSize.width() / 2.0, targetSize.height() / 2.0)
+        - layout.envelope.center();
+    const QTransform motionTransform = frame.toTransform()
+        * QTransform::fromTranslate(delta.x(), delta.y());
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform,
+                          !m_lowFidelity && motionTransform.type() > QTransform::TxTranslate);
+    painter.setTransform(motionTransform, true);
+    painter.drawPixmap(m_motionRasterOrigin, m_motionRaster);
+    painter.restore();
+    return true;
+}
+
+void StickerRenderer::releaseMotionRaster()
+{
+    m_motionRaster = QPixmap();
+    m_motionSourceKey = 0;
+    m_motionMask = QRegion();
+    m_motionMaskSourceKey = 0;
+}
+
+QRegion StickerRenderer::motionMask(const StickerConfig &config, const QSize &targetSize, bool alphaMask) const
+{
+    const StickerMotion &motion = config.transform.motion;
+    if (!isReady() || isTiled() || !motion.isActive() || targetSize.isEmpty()) {
+        return QRegion();
+    }
+
+    StickerTransformLayoutResult layout;
+    if (!calculateLayout(config, layout)) {
+        return QRegion();
+    }
+
+    // 多边形与源图像素无关，视频逐帧换源图时不必重建
+    const QPixmap source = alphaMask ? m_source->pixmap(1.0) : QPixmap();
+    if (m_motionMaskSourceKey == source.cacheKey()
+        && m_motionMaskTransform == layout.localTransform
+        && m_motionMaskMotion == motion
+        && m_motionMaskSize == targetSize
+        && m_motionMaskAlpha == alphaMask) {
+        return m_motionMask;
+    }
+
+    // 与 paintMotion 相同：静态变换后叠加动作变换，再把周期外接范围居中到窗口
+    const QPointF delta = QPointF(targetSize.width() / 2.0, targetSize.height() / 2.0)
+        - layout.envelope.center();
+    const QTransform center = QTransform::fromTranslate(delta.x(), delta.y());
+
+    QRegion region;
+    if (alphaMask) {
+        QPixmap maskSource(targetSize);
+        maskSource.fill(Qt::transparent);
+        QPainter maskPainter(&maskSource);
+        maskPainter.setRenderHint(QPainter::SmoothPixmapTransform);
+        for (int i = 0; i < kMotionMaskSamples; ++i) {
+            const StickerMotionFrame frame = motion.sample(double(i) / kMotionMaskSamples);
+            maskPainter.setTransform(layout.localTransform * frame.toTransform() * center);
+            maskPainter.drawPixmap(layout.baseRect, source, m_source->sourceRect(1.0));
+        }
+        maskPainter.end();
+        region = QRegion(createMaskFromPixmap(maskSource));
+    } else {
+        const QPolygonF base(layout.baseRect);
+        for (int i = 0; i < kMotionMaskSamples; ++i) {
+            const StickerMotionFrame frame = motion.sample(double(i) / kMotionMaskSamples);
+            region |= QRegion((layout.localTransform * frame.toTransform() * center).map(base).toPolygon());
+        }
+    }
+
+    m_motionMask = region;
+    m_motionMaskSourceKey = source.cacheKey();
+    m_motionMaskTransform = layout.localTransform;
+    m_motionMaskMotion = motion;
+    m_motionMaskSize = targetSize;
+    m_motionMaskAlpha = alphaMask;
+    return region;
+}
+
+bool StickerRenderer::paintSnapshot(QPainter &painter, const QPixmap &snapshot, const QRect &targetRect) const
+{
+    if (snapshot.isNull() || targetRect.isEmpty()) {
+        return false;
+    }
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, !m_lowFidelity);
+    painter.drawPixmap(targetRect, snapshot);
+    painter.restore();
+    return true;
+}
+
+QBitmap StickerRenderer::buildMask(const StickerConfig &config, const QSize &targetSize,
+                                   qreal devicePixelRatio) const
+{
+    // 分块贴纸不逐像素取遮罩，由调用方使用 contentPolygon
+    if (!isReady() || isTiled()) {
         return QBitmap();
     }
 
@@ -64,12 +250,32 @@ QBitmap StickerRenderer::buildMask(const StickerConfig &config, const QSize &tar
     QPainter maskPainter(&maskSource);
     maskPainter.setRenderHint(QPainter::Antialiasing);
     maskPainter.setTransform(renderTransform, true);
-    maskPainter.drawPixmap(layout.baseRect, m_image->pixmap(), m_image->sourceRect());
+    maskPainter.drawPixmap(layout.baseRect, m_source->pixmap(devicePixelRatio),
+                           m_source->sourceRect(devicePixelRatio));
     maskPainter.end();
 
     return createMaskFromPixmap(maskSource);
 }
 
+QPolygon StickerRenderer::contentPolygon(const StickerConfig &config, const QSize &targetSize) const
+{
+    StickerTransformLayoutResult layout;
+    if (!calculateLayout(config, layout)) {
+        return QPolygon();
+    }
+
+    QTransform renderTransform = StickerTransformLayout::buildRenderTransform(layout, targetSize);
+    return renderTransform.map(QPolygonF(layout.baseRect)).toPolygon();
+}
+
+QSize StickerRenderer::sourceBaseSize() const
+{
+    if (isTiled()) {
+        return m_tiled->logicalSize();
+    }
+    return m_source ? m_source->baseSize() : QSize();
+}
+
 QBitmap StickerRenderer::createMaskFromPixmap(const QPixmap &pixmap) const
 {
     if (pixmap.isNull()) {
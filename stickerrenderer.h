@@ -2,28 +2,67 @@
 #define STICKERRENDERER_H
 
 #include <QBitmap>
+#include <QPixmap>
+#include <QPolygon>
+#include <QRect>
+#include <QRegion>
 #include <QSize>
 #include "stickertransformlayout.h"
 
 class QPainter;
-class StickerImage;
+class StickerEffectStage;
+class StickerTiledImage;
 
 class StickerRenderer
 {
 public:
-    explicit StickerRenderer(const StickerImage *image = nullptr);
+    explicit StickerRenderer(const StickerEffectStage *source = nullptr);
 
-    void setImage(const StickerImage *image);
+    void setSource(const StickerEffectStage *source);
+    // 设置后优先绘制分块图像（不经过效果阶段）
+    void setTiledSource(const StickerTiledImage *tiled);
+    bool isTiled() const;
     bool isReady() const;
 
+    // 手势/预览进行中用快速变换绘制，结束后恢复平滑
+    void setLowFidelity(bool lowFidelity);
+    bool isLowFidelity() const;
+
     bool calculateLayout(const StickerConfig &config, StickerTransformLayoutResult &out) const;
-    bool paint(QPainter &painter, const StickerConfig &config, const QSize &targetSize) const;
-    QBitmap buildMask(const StickerConfig &config, const QSize &targetSize) const;
+    bool paint(QPainter &painter, const StickerConfig &config, const QSize &targetSize,
+               const QRect &visibleRect = QRect(), const QRect &exposedRect = QRect()) const;
+    // 关键帧动作：静态变换后的栅格缓存一次，逐帧只做平移/旋转/缩放贴图
+    bool paintMotion(QPainter &painter, const StickerConfig &config, const QSize &targetSize,
+                     const StickerMotionFrame &frame) const;
+    void releaseMotionRaster();
+    // 关键帧动作整个周期扫过区域的遮罩：逐相位采样内容 Alpha（alphaMask 为 false 时只取内容多边形）取并集，
+    // 源图、静态变换、动作参数或窗口尺寸不变时直接复用
+    QRegion motionMask(const StickerConfig &config, const QSize &targetSize, bool alphaMask) const;
+    // 降级的 Live2D 贴纸：把渲染窗口抓下的快照贴到原渲染区域
+    bool paintSnapshot(QPainter &painter, const QPixmap &snapshot, const QRect &targetRect) const;
+    QBitmap buildMask(const StickerConfig &config, const QSize &targetSize,
+                      qreal devicePixelRatio = 1.0) const;
+    // 内容矩形变换后的外接多边形，用作分块贴纸等不逐像素取遮罩的窗口形状
+    QPolygon contentPolygon(const StickerConfig &config, const QSize &targetSize) const;
 
 private:
     QBitmap createMaskFromPixmap(const QPixmap &pixmap) const;
 
-    const StickerImage *m_image;
+    QSize sourceBaseSize() const;
+
+    const StickerEffectStage *m_source;
+    const StickerTiledImage *m_tiled;
+    bool m_lowFidelity;
+    mutable QPixmap m_motionRaster;
+    mutable QPointF m_motionRasterOrigin;
+    mutable QTransform m_motionTransform;
+    mutable qint64 m_motionSourceKey;
+    mutable QRegion m_motionMask;
+    mutable qint64 m_motionMaskSourceKey;
+    mutable QTransform m_motionMaskTransform;
+    mutable StickerMotion m_motionMaskMotion;
+    mutable QSize m_motionMaskSize;
+    mutable bool m_motionMaskAlpha;
 };
 
 #endif // STICKERRENDERER_H
@@ -1,4 +1,4 @@
-#include "StickerRepository.h"
+#include "stickerrepository.h"
 #include <QDir>
 #include <QFile>
 #include <QJsonDocument>
@@ -24,7 +24,8 @@ QString StickerRepository::configFilePath() const
     return m_defaultConfigFile;
 }
 
-bool StickerRepository::load(QList<StickerConfig> &outConfigs, bool &hasData) const
+bool StickerRepository::load(QList<StickerConfig> &outConfigs, bool &hasData,
+                             StickerRuntimeSettings *outSettings) const
 {
     outConfigs.clear();
     hasData = false;
@@ -44,6 +45,10 @@ bool StickerRepository::load(QList<StickerConfig> &outConfigs, bool &hasData) co
     }
 
     QJsonObject root = doc.object();
+    if (outSettings) {
+        outSettings->fromJson(root["runtime"].toObject());
+    }
+
     if (root.contains("stickers") && root["stickers"].isArray()) {
         QJsonArray stickersArray = root["stickers"].toArray();
         for (const QJsonValue &value : stickersArray) {
@@ -69,10 +74,12 @@ bool StickerRepository::load(QList<StickerConfig> &outConfigs, bool &hasData) co
     return true;
 }
 
-bool StickerRepository::save(const QList<StickerConfig> &configs) const
+bool StickerRepository::save(const QList<StickerConfig> &configs,
+                             const StickerRuntimeSettings &settings) const
 {
     QJsonObject root;
     root["version"] = "3.0";
+    root["runtime"] = settings.toJson();
     QJsonArray stickersArray;
     for (const StickerConfig &config : configs) {
         stickersArray.append(config.toJson());
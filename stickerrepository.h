@@ -3,15 +3,17 @@
 
 #include <QString>
 #include <QList>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 class StickerRepository
 {
 public:
     StickerRepository();
 
-    bool load(QList<StickerConfig> &outConfigs, bool &hasData) const;
-    bool save(const QList<StickerConfig> &configs) const;
+    bool load(QList<StickerConfig> &outConfigs, bool &hasData,
+              StickerRuntimeSettings *outSettings = nullptr) const;
+    bool save(const QList<StickerConfig> &configs,
+              const StickerRuntimeSettings &settings = StickerRuntimeSettings()) const;
     bool clear() const;
 
     QString configFilePath() const;
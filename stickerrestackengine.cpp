@@ -0,0 +1,246 @@
+#include "stickerrestackengine.h"
+#include <QDebug>
+#include <QSet>
+#include <QVector>
+#include <algorithm>
+#include "stickerwidget.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+const int kDesktopBand = 0;
+const int kTopBand = 1;
+
+QSet<WindowHandle> handleSet(const QList<WindowHandle> &handles)
+{
+    QSet<WindowHandle> set;
+    for (WindowHandle handle : handles) {
+        set.insert(handle);
+    }
+    return set;
+}
+
+#ifdef Q_OS_WIN
+bool isTopMost(HWND hwnd)
+{
+    return (GetWindowLongPtrW(hwnd, GWL_EXSTYLE) & WS_EX_TOPMOST) != 0;
+}
+
+void placeWindow(HWND hwnd, HWND insertAfter)
+{
+    SetWindowPos(hwnd, insertAfter, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+}
+
+// 紧贴 anchor 之上：插到 anchor 上方那个窗口之后
+void placeAbove(HWND hwnd, HWND anchor)
+{
+    HWND above = GetWindow(anchor, GW_HWNDPREV);
+    if (above == hwnd) {
+        return;
+    }
+    const bool anchorTop = isTopMost(anchor);
+    if (!above || isTopMost(above) != anchorTop) {
+        placeWindow(hwnd, anchorTop ? HWND_TOPMOST : HWND_TOP);
+    } else {
+        placeWindow(hwnd, above);
+    }
+}
+#endif
+}
+
+QList<WindowHandle> StickerRestackEngine::planInsertions(const QList<WindowHandle> &current,
+                                                         const QList<WindowHandle> &desired)
+{
+    QHash<WindowHandle, int> desiredIndex;
+    for (int i = 0; i < desired.size(); ++i) {
+        desiredIndex.insert(desired.at(i), i);
+    }
+
+    // 当前次序映射成期望下标序列，求最长递增子序列（耐心排序 + 回溯）
+    QVector<int> sequence;
+    for (WindowHandle handle : current) {
+        auto it = desiredIndex.constFind(handle);
+        if (it != desiredIndex.constEnd()) {
+            sequence.append(it.value());
+        }
+    }
+    QVector<int> tailIndex;
+    QVector<int> tailValue;
+    QVector<int> previous(sequence.size(), -1);
+    for (int i = 0; i < sequence.size(); ++i) {
+        const int value = sequence.at(i);
+        const int length = int(std::lower_bound(tailValue.begin(), tailValue.end(), value) - tailValue.begin());
+        if (length > 0) {
+            previous[i] = tailIndex.at(length - 1);
+        }
+        if (length == tailValue.size()) {
+            tailValue.append(value);
+            tailIndex.append(i);
+        } else {
+            tailValue[length] = value;
+            tailIndex[length] = i;
+        }
+    }
+
+    QSet<int> fixed;
+    for (int i = tailIndex.isEmpty() ? -1 : tailIndex.last(); i >= 0; i = previous.at(i)) {
+        fixed.insert(sequence.at(i));
+    }
+
+    QList<WindowHandle> moves;
+    for (int i = 0; i < desired.size(); ++i) {
+        if (!fixed.contains(i)) {
+            moves.append(desired.at(i));
+        }
+    }
+    return moves;
+}
+
+StickerRestackEngine::RaiseLowerPlan StickerRestackEngine::planRaiseLower(const QList<WindowHandle> &current,
+                                                                         const QList<WindowHandle> &desired)
+{
+    const QSet<WindowHandle> wanted = handleSet(desired);
+    QList<WindowHandle> filtered;
+    for (WindowHandle handle : current) {
+        if (wanted.contains(handle)) {
+            filtered.append(handle);
+        }
+    }
+
+    // 期望次序的最长前缀/后缀若是当前次序的子序列，就可以原地不动
+    int prefix = 0;
+    for (WindowHandle handle : filtered) {
+        if (prefix < desired.size() && handle == desired.at(prefix)) {
+            ++prefix;
+        }
+    }
+    int suffix = 0;
+    for (int i = filtered.size() - 1; i >= 0; --i) {
+        if (suffix < desired.size() && filtered.at(i) == desired.at(desired.size() - 1 - suffix)) {
+            ++suffix;
+        }
+    }
+
+    RaiseLowerPlan plan;
+    if (desired.size() - prefix <= desired.size() - suffix) {
+        plan.raises = desired.mid(prefix);
+    } else {
+        for (int i = desired.size() - suffix - 1; i >= 0; --i) {
+            plan.lowers.append(desired.at(i));
+        }
+    }
+    return plan;
+}
+
+int StickerRestackEngine::restack(const QList<StickerWidget*> &stickers)
+{
+    QList<StickerWidget*> desktop;
+    QList<StickerWidget*> top;
+    for (StickerWidget *sticker : stickers) {
+        if (!sticker || !sticker->isRestackable()) {
+            continue;
+        }
+        (sticker->isStackedOnDesktop() ? desktop : top).append(sticker);
+    }
+    return restackBand(kDesktopBand, desktop) + restackBand(kTopBand, top);
+}
+
+int StickerRestackEngine::restackBand(int band, const QList<StickerWidget*> &stickers)
+{
+    if (stickers.size() < 2) {
+        m_lastOrder.remove(band);
+        return 0;
+    }
+
+    QHash<WindowHandle, StickerWidget*> byHandle;
+    QList<WindowHandle> handles;
+    for (StickerWidget *sticker : stickers) {
+        const WindowHandle handle = sticker->nativeHandle();
+        if (handle != 0) {
+            byHandle.insert(handle, sticker);
+            handles.append(handle);
+        }
+    }
+
+    // zOrder 相同的贴纸保持当前相对次序，只有显式的次序差异才会引起移动
+    const QList<WindowHandle> current = currentOrder(band, handles);
+    QList<WindowHandle> desired = current;
+    std::stable_sort(desired.begin(), desired.end(), [&byHandle](WindowHandle a, WindowHandle b) {
+        return byHandle.value(a)->stackOrder() < byHandle.value(b)->stackOrder();
+    });
+
+    int operations = 0;
+#ifdef Q_OS_WIN
+    const QList<WindowHandle> moves = planInsertions(current, desired);
+    if (moves.isEmpty()) {
+        return 0;
+    }
+    const QSet<WindowHandle> moving = handleSet(moves);
+    HWND lowestFixed = nullptr;
+    for (WindowHandle handle : desired) {
+        if (!moving.contains(handle)) {
+            lowestFixed = reinterpret_cast<HWND>(handle);
+            break;
+        }
+    }
+    // 自下而上逐个放到期望的前一个窗口之上，最底的放到最低的不动窗口之下
+    for (WindowHandle handle : moves) {
+        HWND hwnd = reinterpret_cast<HWND>(handle);
+        const int index = desired.indexOf(handle);
+        if (index > 0) {
+            placeAbove(hwnd, reinterpret_cast<HWND>(desired.at(index - 1)));
+        } else if (lowestFixed) {
+            placeWindow(hwnd, lowestFixed);
+        }
+        ++operations;
+    }
+#else
+    const RaiseLowerPlan plan = planRaiseLower(current, desired);
+    for (WindowHandle handle : plan.raises) {
+        byHandle.value(handle)->raiseWindow();
+        ++operations;
+    }
+    for (WindowHandle handle : plan.lowers) {
+        byHandle.value(handle)->lowerWindow();
+        ++operations;
+    }
+    m_lastOrder.insert(band, desired);
+#endif
+
+    if (operations > 0) {
+        qDebug() << "贴纸层叠调整" << (band == kDesktopBand ? "桌面层" : "置顶层")
+                 << "窗口数" << handles.size() << "移动" << operations;
+    }
+    return operations;
+}
+
+QList<WindowHandle> StickerRestackEngine::currentOrder(int band, const QList<WindowHandle> &handles) const
+{
+    const QSet<WindowHandle> wanted = handleSet(handles);
+    QList<WindowHandle> order;
+#ifdef Q_OS_WIN
+    Q_UNUSED(band)
+    // 从最上层向下遍历一次顶层窗口，转换成自底向上
+    for (HWND hwnd = GetTopWindow(nullptr); hwnd; hwnd = GetWindow(hwnd, GW_HWNDNEXT)) {
+        const WindowHandle handle = WindowHandle(hwnd);
+        if (wanted.contains(handle)) {
+            order.prepend(handle);
+        }
+    }
+#else
+    // 沿用上次排好的次序，新出现的窗口视为在最上方
+    for (WindowHandle handle : m_lastOrder.value(band)) {
+        if (wanted.contains(handle)) {
+            order.append(handle);
+        }
+    }
+    for (WindowHandle handle : handles) {
+        if (!order.contains(handle)) {
+            order.append(handle);
+        }
+    }
+#endif
+    return order;
+}
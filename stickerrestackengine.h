@@ -0,0 +1,39 @@
+#ifndef STICKERRESTACKENGINE_H
+#define STICKERRESTACKENGINE_H
+
+#include <QHash>
+#include <QList>
+#include "windowrecognitionservice.h"
+
+class StickerWidget;
+
+// 贴纸层叠：同一层带（桌面置底/普通置顶）内按 StickerConfig::zOrder 排列原生窗口，
+// 与当前次序比较后只移动必须移动的窗口，而不是逐个重新置顶
+class StickerRestackEngine
+{
+public:
+    // 以下次序均为自底向上。
+    // 任意插入：保留当前次序中最长的有序子序列，返回其余窗口（按期望次序自下而上）
+    static QList<WindowHandle> planInsertions(const QList<WindowHandle> &current,
+                                              const QList<WindowHandle> &desired);
+
+    // 只能整体置顶/置底时：保留最长有序前缀后依次置顶，或保留最长有序后缀后依次置底，取较少者
+    struct RaiseLowerPlan {
+        QList<WindowHandle> raises;   // 按顺序置顶
+        QList<WindowHandle> lowers;   // 按顺序置底
+    };
+    static RaiseLowerPlan planRaiseLower(const QList<WindowHandle> &current,
+                                         const QList<WindowHandle> &desired);
+
+    // 返回实际执行的窗口操作数
+    int restack(const QList<StickerWidget*> &stickers);
+
+private:
+    int restackBand(int band, const QList<StickerWidget*> &stickers);
+    QList<WindowHandle> currentOrder(int band, const QList<WindowHandle> &handles) const;
+
+    // 非 Windows 平台无法查询窗口次序，记录上次排好的结果
+    QHash<int, QList<WindowHandle>> m_lastOrder;
+};
+
+#endif // STICKERRESTACKENGINE_H
@@ -1,8 +1,24 @@
-#include "StickerRuntime.h"
+#include "stickerruntime.h"
+#include <QDebug>
+#include <QElapsedTimer>
+
+namespace {
+// 只有层带或次序相关的字段变化才需要重新层叠；展示方式与编辑模式另由 stackingChanged 通知
+bool affectsStacking(const StickerConfig &previous, const StickerConfig &config)
+{
+    return previous.zOrder != config.zOrder
+        || previous.isDesktopMode != config.isDesktopMode
+        || previous.visible != config.visible
+        || previous.follow.enabled != config.follow.enabled;
+}
+}
 
 StickerRuntime::StickerRuntime(QObject *parent)
     : QObject(parent)
 {
+    m_restackTimer.setSingleShot(true);
+    m_restackTimer.setInterval(0);
+    connect(&m_restackTimer, &QTimer::timeout, this, &StickerRuntime::restack);
 }
 
 StickerRuntime::~StickerRuntime()
@@ -96,6 +112,60 @@ QList<StickerInstance*> StickerRuntime::instancesForTemplate(const QString &temp
     return result;
 }
 
+QHash<QString, qint64> StickerRuntime::residentBytes() const
+{
+    QHash<QString, qint64> result;
+    for (auto it = m_instances.constBegin(); it != m_instances.constEnd(); ++it) {
+        StickerInstance *instance = it.value();
+        result.insert(it.key(), (instance && instance->widget) ? instance->widget->residentBytes() : 0);
+    }
+    return result;
+}
+
+void StickerRuntime::beginGeometryBatch()
+{
+    m_geometryBatch.begin();
+}
+
+void StickerRuntime::commitGeometryBatch()
+{
+    m_geometryBatch.commit();
+}
+
+StickerGeometryBatch *StickerRuntime::geometryBatch()
+{
+    return &m_geometryBatch;
+}
+
+void StickerRuntime::scheduleRestack()
+{
+    if (!m_restackTimer.isActive()) {
+        m_restackTimer.start();
+    }
+}
+
+void StickerRuntime::restack()
+{
+    QList<StickerWidget*> widgets;
+    for (StickerInstance *instance : m_instances) {
+        if (instance && instance->widget) {
+            widgets.append(instance->widget);
+        }
+    }
+    m_restackEngine.restack(widgets);
+}
+
+QHash<QString, StickerWidget::PaintStats> StickerRuntime::paintStats() const
+{
+    QHash<QString, StickerWidget::PaintStats> result;
+    for (auto it = m_instances.constBegin(); it != m_instances.constEnd(); ++it) {
+        StickerInstance *instance = it.value();
+        result.insert(it.key(), (instance && instance->widget) ? instance->widget->paintStats()
+                                                                : StickerWidget::PaintStats());
+    }
+    return result;
+}
+
 StickerInstance *StickerRuntime::ensureInstance(const StickerConfig &config,
                                                 const QString &instanceId,
                                                 const QString &templateId,
@@ -108,14 +178,26 @@ StickerInstance *StickerRuntime::ensureInstance(const StickerConfig &config,
         instance->templateId = templateId;
         instance->syncToTemplate = syncToTemplate;
         instance->config = config;
+        // 记录各显示方式的创建耗时与窗口缓冲，用于对比轻量窗口与 QWidget 窗口
+        QElapsedTimer timer;
+        timer.start();
         instance->widget = new StickerWidget(config);
+        instance->widget->setGeometryBatch(&m_geometryBatch);
         instance->widget->show();
+        qDebug() << "创建贴纸实例" << instanceId
+                 << "显示方式" << int(instance->widget->presentation())
+                 << "耗时" << timer.nsecsElapsed() / 1000 << "us"
+                 << "常驻约" << instance->widget->residentBytes() / 1024 << "KB";
         connectInstanceSignals(instance);
         m_instances.insert(instanceId, instance);
         instance->config = instance->widget->getConfig();
+        scheduleRestack();
         return instance;
     }
 
+    if (affectsStacking(instance->config, config)) {
+        scheduleRestack();
+    }
     instance->templateId = templateId;
     instance->syncToTemplate = syncToTemplate;
     instance->config = config;
@@ -141,10 +223,17 @@ void StickerRuntime::connectInstanceSignals(StickerInstance *instance)
                 if (!current) {
                     return;
                 }
+                // 拖动时每一步都会发出，只在右键切换模式等改变层带时才重新层叠
+                if (affectsStacking(current->config, config)) {
+                    scheduleRestack();
+                }
                 current->config = config;
                 emit instanceConfigChanged(instanceId, config, current->syncToTemplate);
             }, Qt::UniqueConnection);
 
+    connect(widget, &StickerWidget::stackingChanged, this, &StickerRuntime::scheduleRestack,
+            Qt::UniqueConnection);
+
     connect(widget, &StickerWidget::deleteRequested, this,
             [this, instanceId](const QString &) {
                 StickerInstance *current = m_instances.value(instanceId, nullptr);
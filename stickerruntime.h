@@ -5,8 +5,11 @@
 #include <QHash>
 #include <QList>
 #include <QString>
+#include <QTimer>
+#include "stickergeometrybatch.h"
 #include "stickerinstance.h"
-#include "StickerWidget.h"
+#include "stickerrestackengine.h"
+#include "stickerwidget.h"
 
 class StickerRuntime : public QObject
 {
@@ -29,6 +32,20 @@ public:
     QList<StickerInstance*> instances() const;
     QList<StickerInstance*> instancesForTemplate(const QString &templateId) const;
 
+    // 各实例当前常驻的栅格/遮罩/Live2D 估算字节数
+    QHash<QString, qint64> residentBytes() const;
+
+    // 批量几何：一次刷新内各实例的移动与层级调整集中提交，可嵌套
+    void beginGeometryBatch();
+    void commitGeometryBatch();
+    StickerGeometryBatch *geometryBatch();
+
+    // 层叠次序/模式/可见性变化后合并到下一轮事件循环统一重排
+    void scheduleRestack();
+
+    // 各实例的绘制次数/跳过次数/耗时
+    QHash<QString, StickerWidget::PaintStats> paintStats() const;
+
 signals:
     void instanceConfigChanged(const QString &instanceId,
                                const StickerConfig &config,
@@ -42,8 +59,12 @@ private:
                                     const QString &templateId,
                                     bool syncToTemplate);
     void connectInstanceSignals(StickerInstance *instance);
+    void restack();
 
     QHash<QString, StickerInstance*> m_instances;
+    StickerGeometryBatch m_geometryBatch;
+    StickerRestackEngine m_restackEngine;
+    QTimer m_restackTimer;
 };
 
 #endif // STICKERRUNTIME_H
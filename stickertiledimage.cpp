@@ -0,0 +1,340 @@
+#include "stickertiledimage.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageIOHandler>
+#include <QImageReader>
+#include <QList>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QStandardPaths>
+#include <QtGlobal>
+#include <QtMath>
+
+namespace {
+const int kTileSize = 512;
+const char kPyramidDir[] = "tiles";
+const char kPyramidDoneFile[] = "complete";
+// 分块文件只在本机缓存，压缩率让位于读写速度
+const int kPyramidPngQuality = 90;
+
+int levelExtent(int extent, int level)
+{
+    return qMax(1, (extent + (1 << level) - 1) >> level);
+}
+
+int tileCount(int extent)
+{
+    return (extent + kTileSize - 1) / kTileSize;
+}
+
+qint64 imageBytes(const QImage &image)
+{
+    return qint64(image.bytesPerLine()) * image.height();
+}
+}
+
+StickerTiledImage::StickerTiledImage(int cacheKb)
+    : m_maxLevel(0)
+    , m_clipSupported(false)
+    , m_generation(0)
+    , m_tiles(cacheKb)
+{
+}
+
+bool StickerTiledImage::load(const QString &imagePath, const QSize &maxLogicalSize)
+{
+    clear();
+
+    QImageReader reader(imagePath);
+    const QSize size = reader.size();
+    if (!size.isValid() || size.isEmpty()) {
+        qDebug() << "分块贴纸无法读取图像尺寸:" << imagePath << reader.errorString();
+        return false;
+    }
+
+    m_path = imagePath;
+    m_imageSize = size;
+    m_clipSupported = reader.supportsOption(QImageIOHandler::ClipRect);
+    m_logicalSize = size;
+    if (maxLogicalSize.isValid()
+        && (size.width() > maxLogicalSize.width() || size.height() > maxLogicalSize.height())) {
+        m_logicalSize = size.scaled(maxLogicalSize, Qt::KeepAspectRatio);
+    }
+
+    // 最粗级别缩到单个分块以内
+    m_maxLevel = 0;
+    while (levelExtent(qMax(size.width(), size.height()), m_maxLevel) > kTileSize) {
+        ++m_maxLevel;
+    }
+
+    // 不支持局部读取时不做整级解码回退，而是一次性切出分块金字塔并落盘复用
+    if (!m_clipSupported) {
+        const QString directory = pyramidDirectory(imagePath);
+        if (!QFile::exists(QDir(directory).filePath(kPyramidDoneFile)) && !buildPyramid(directory)) {
+            qDebug() << "分块金字塔生成失败，不使用分块模式:" << imagePath;
+            clear();
+            return false;
+        }
+        m_pyramidDir = directory;
+    }
+
+    ++m_generation;
+    qDebug() << "分块贴纸加载:" << imagePath << "原始尺寸:" << size
+             << "级别数:" << (m_maxLevel + 1) << "局部解码:" << m_clipSupported;
+    return true;
+}
+
+void StickerTiledImage::clear()
+{
+    m_path.clear();
+    m_imageSize = QSize();
+    m_logicalSize = QSize();
+    m_maxLevel = 0;
+    m_clipSupported = false;
+    m_pyramidDir.clear();
+    releaseTiles();
+}
+
+bool StickerTiledImage::isNull() const
+{
+    return m_imageSize.isEmpty();
+}
+
+QSize StickerTiledImage::imageSize() const
+{
+    return m_imageSize;
+}
+
+QSize StickerTiledImage::logicalSize() const
+{
+    return m_logicalSize;
+}
+
+quint64 StickerTiledImage::generation() const
+{
+    return m_generation;
+}
+
+void StickerTiledImage::paint(QPainter &painter, const QRectF &target,
+                              const QRect &visibleRect, const QRect &exposedRect) const
+{
+    if (isNull() || target.isEmpty() || visibleRect.isEmpty()) {
+        return;
+    }
+
+    // 源像素 -> 设备逻辑坐标
+    QTransform sourceToTarget;
+    sourceToTarget.translate(target.x(), target.y());
+    sourceToTarget.scale(target.width() / m_imageSize.width(), target.height() / m_imageSize.height());
+    const QTransform sourceToDevice = sourceToTarget * painter.combinedTransform();
+    bool invertible = false;
+    const QTransform deviceToSource = sourceToDevice.inverted(&invertible);
+    if (!invertible) {
+        return;
+    }
+
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
+    const qreal density = qSqrt(qAbs(sourceToDevice.determinant())) * dpr;
+    const int level = levelForScale(density);
+    const int step = 1 << level;
+    const int columns = tileCount(levelExtent(m_imageSize.width(), level));
+    const int rows = tileCount(levelExtent(m_imageSize.height(), level));
+
+    const QRect imageRect(QPoint(0, 0), m_imageSize);
+    const QRect visibleSource = deviceToSource.mapRect(QRectF(visibleRect)).toAlignedRect() & imageRect;
+    const QRect exposedSource = deviceToSource.mapRect(QRectF(exposedRect & visibleRect)).toAlignedRect()
+        & imageRect;
+    if (visibleSource.isEmpty()) {
+        pruneTiles(level, QRect());
+        return;
+    }
+
+    const int tileSpan = kTileSize * step;
+    const QRect keepTiles(QPoint(visibleSource.left() / tileSpan, visibleSource.top() / tileSpan),
+                          QPoint(qMin(columns - 1, visibleSource.right() / tileSpan),
+                                 qMin(rows - 1, visibleSource.bottom() / tileSpan)));
+    pruneTiles(level, keepTiles);
+    if (exposedSource.isEmpty()) {
+        return;
+    }
+
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setTransform(sourceToTarget, true);
+    const int firstColumn = exposedSource.left() / tileSpan;
+    const int lastColumn = qMin(columns - 1, exposedSource.right() / tileSpan);
+    const int firstRow = exposedSource.top() / tileSpan;
+    const int lastRow = qMin(rows - 1, exposedSource.bottom() / tileSpan);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const quint64 key = tileKey(level, column, row);
+            QImage *tile = m_tiles.object(key);
+            if (!tile) {
+                QImage decoded = decodeTile(level, column, row);
+                if (decoded.isNull()) {
+                    continue;
+                }
+                const int costKb = int(qMax<qint64>(1, imageBytes(decoded) / 1024));
+                tile = new QImage(decoded);
+                if (!m_tiles.insert(key, tile, costKb)) {
+                    // 超出缓存容量时直接绘制后丢弃
+                    painter.drawImage(QRectF(tileSourceRect(level, column, row)), decoded);
+                    continue;
+                }
+            }
+            painter.drawImage(QRectF(tileSourceRect(level, column, row)), *tile);
+        }
+    }
+    painter.restore();
+}
+
+void StickerTiledImage::releaseTiles()
+{
+    m_tiles.clear();
+}
+
+qint64 StickerTiledImage::residentBytes() const
+{
+    return qint64(m_tiles.totalCost()) * 1024;
+}
+
+quint64 StickerTiledImage::tileKey(int level, int column, int row)
+{
+    return (quint64(level) << 48) | (quint64(row) << 24) | quint64(column);
+}
+
+int StickerTiledImage::levelForScale(qreal devicePixelsPerSourcePixel) const
+{
+    // 每个源像素占不到半个设备像素时降一级
+    int level = 0;
+    qreal density = devicePixelsPerSourcePixel;
+    while (level < m_maxLevel && density <= 0.5) {
+        density *= 2.0;
+        ++level;
+    }
+    return level;
+}
+
+// 按路径、大小与修改时间区分，源文件变化后生成新的金字塔
+QString StickerTiledImage::pyramidDirectory(const QString &imagePath)
+{
+    const QFileInfo info(imagePath);
+    const QString identity = QString("%1|%2|%3").arg(info.absoluteFilePath())
+                                 .arg(info.size())
+                                 .arg(info.lastModified().toMSecsSinceEpoch());
+    const QString hash = QString::fromLatin1(
+        QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1).toHex());
+    const QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    return cacheDir.filePath(QString("%1/%2").arg(kPyramidDir, hash));
+}
+
+QString StickerTiledImage::tileFileName(int level, int column, int row)
+{
+    return QString("L%1_%2_%3.png").arg(level).arg(column).arg(row);
+}
+
+// 整幅解码只在这里发生一次：逐级切块写盘，再减半生成下一级，同时只持有一级图像
+bool StickerTiledImage::buildPyramid(const QString &directory) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QDir dir(directory);
+    if (!dir.removeRecursively() && dir.exists()) {
+        return false;
+    }
+    if (!QDir().mkpath(directory)) {
+        return false;
+    }
+
+    QImageReader reader(m_path);
+    QImage level = reader.read();
+    if (level.isNull()) {
+        qDebug() << "分块金字塔解码失败:" << m_path << reader.errorString();
+        return false;
+    }
+    level = level.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    int files = 0;
+    for (int index = 0; index <= m_maxLevel; ++index) {
+        if (index > 0) {
+            level = level.scaled(levelExtent(m_imageSize.width(), index), levelExtent(m_imageSize.height(), index),
+                                 Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        const int columns = tileCount(level.width());
+        const int rows = tileCount(level.height());
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                const QRect rect = QRect(column * kTileSize, row * kTileSize, kTileSize, kTileSize) & level.rect();
+                if (!level.copy(rect).save(dir.filePath(tileFileName(index, column, row)), "PNG",
+                                           kPyramidPngQuality)) {
+                    qDebug() << "分块写入失败:" << dir.filePath(tileFileName(index, column, row));
+                    return false;
+                }
+                ++files;
+            }
+        }
+    }
+
+    QFile done(dir.filePath(kPyramidDoneFile));
+    if (!done.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    done.close();
+    qDebug() << "分块金字塔生成完成:" << m_path << "分块数" << files
+             << "耗时" << timer.elapsed() << "ms";
+    return true;
+}
+
+QRect StickerTiledImage::tileSourceRect(int level, int column, int row) const
+{
+    const int span = kTileSize << level;
+    return QRect(column * span, row * span, span, span) & QRect(QPoint(0, 0), m_imageSize);
+}
+
+QImage StickerTiledImage::decodeTile(int level, int column, int row) const
+{
+    const QRect sourceRect = tileSourceRect(level, column, row);
+    if (sourceRect.isEmpty()) {
+        return QImage();
+    }
+    const QSize levelTileSize(levelExtent(sourceRect.width(), level), levelExtent(sourceRect.height(), level));
+
+    if (m_clipSupported) {
+        QImageReader reader(m_path);
+        reader.setClipRect(sourceRect);
+        reader.setScaledSize(levelTileSize);
+        QImage tile = reader.read();
+        if (tile.isNull()) {
+            qDebug() << "分块解码失败:" << m_path << sourceRect << reader.errorString();
+            return QImage();
+        }
+        return tile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    // 格式不支持 ClipRect 时读预先切好的分块文件
+    const QString tilePath = QDir(m_pyramidDir).filePath(tileFileName(level, column, row));
+    QImage tile(tilePath);
+    if (tile.isNull()) {
+        qDebug() << "分块文件读取失败:" << tilePath;
+        return QImage();
+    }
+    return tile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+void StickerTiledImage::pruneTiles(int level, const QRect &keepTiles) const
+{
+    const QList<quint64> keys = m_tiles.keys();
+    for (quint64 key : keys) {
+        const int keyLevel = int(key >> 48);
+        const int row = int((key >> 24) & 0xFFFFFF);
+        const int column = int(key & 0xFFFFFF);
+        if (keyLevel != level || !keepTiles.contains(column, row)) {
+            m_tiles.remove(key);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef STICKERTILEDIMAGE_H
+#define STICKERTILEDIMAGE_H
+
+#include <QCache>
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+class QPainter;
+
+// 高分辨率分块贴纸：不受 600px 上限约束，只按当前缩放级别解码可见分块，
+// 分块经 QImageReader::setClipRect 局部读取，缓存只保留当前级别、屏幕内的分块。
+// PNG 等不支持局部读取的格式在首次加载时切成磁盘上的分块金字塔，之后只读单个分块文件
+class StickerTiledImage
+{
+public:
+    explicit StickerTiledImage(int cacheKb = 48 * 1024);
+
+    bool load(const QString &imagePath, const QSize &maxLogicalSize);
+    void clear();
+
+    bool isNull() const;
+    QSize imageSize() const;
+    QSize logicalSize() const;
+    quint64 generation() const;
+
+    // 以 painter 当前变换把整幅图绘制到 target（逻辑坐标）；
+    // visibleRect 为窗口在屏幕内的部分，exposedRect 为本次需要重绘的部分（均为设备逻辑坐标）
+    void paint(QPainter &painter, const QRectF &target,
+               const QRect &visibleRect, const QRect &exposedRect) const;
+
+    void releaseTiles();
+    qint64 residentBytes() const;
+
+private:
+    static quint64 tileKey(int level, int column, int row);
+    static QString pyramidDirectory(const QString &imagePath);
+    static QString tileFileName(int level, int column, int row);
+    bool buildPyramid(const QString &directory) const;
+    int levelForScale(qreal devicePixelsPerSourcePixel) const;
+    QRect tileSourceRect(int level, int column, int row) const;
+    QImage decodeTile(int level, int column, int row) const;
+    void pruneTiles(int level, const QRect &keepTiles) const;
+
+    QString m_path;
+    QSize m_imageSize;
+    QSize m_logicalSize;
+    int m_maxLevel;
+    bool m_clipSupported;
+    QString m_pyramidDir;
+    quint64 m_generation;
+    mutable QCache<quint64, QImage> m_tiles;
+};
+
+#endif // STICKERTILEDIMAGE_H
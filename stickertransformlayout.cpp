@@ -15,9 +15,12 @@ bool StickerTransformLayout::calculate(const StickerConfig &config,
     out.localTransform = config.transform.toTransform();
 
     out.bounds = out.localTransform.mapRect(out.baseRect);
+    // Live2D 由模型自身驱动动作，不叠加关键帧
+    out.envelope = config.contentType == StickerContentType::Live2D
+        ? out.bounds : config.transform.motion.envelope(out.bounds);
     out.windowSize = QSize(
-        qMax(1, int(qCeil(out.bounds.width()))),
-        qMax(1, int(qCeil(out.bounds.height())))
+        qMax(1, int(qCeil(out.envelope.width()))),
+        qMax(1, int(qCeil(out.envelope.height())))
     );
 
     return true;
@@ -27,7 +30,7 @@ QTransform StickerTransformLayout::buildRenderTransform(const StickerTransformLa
                                                         const QSize &targetSize)
 {
     QPointF targetCenter(targetSize.width() / 2.0, targetSize.height() / 2.0);
-    QPointF boundsCenter = layout.bounds.center();
+    QPointF boundsCenter = layout.envelope.isValid() ? layout.envelope.center() : layout.bounds.center();
     QPointF delta = targetCenter - boundsCenter;
 
     QTransform render = layout.localTransform;
@@ -5,11 +5,13 @@
 #include <QSize>
 #include <QTransform>
 #include <QPixmap>
-#include "StickerData.h"
+#include "stickerdata.h"
 
 struct StickerTransformLayoutResult {
     QRectF baseRect;
     QRectF bounds;
+    // 带动作时为整个周期的外接范围，否则与 bounds 相同
+    QRectF envelope;
     QSize windowSize;
     QTransform localTransform;
 };
@@ -0,0 +1,246 @@
+#include "stickervideosource.h"
+#include <QAbstractVideoBuffer>
+#include <QAbstractVideoSurface>
+#include <QDebug>
+#include <QMediaPlayer>
+#include <QMutexLocker>
+#include <QUrl>
+#include <QVideoSurfaceFormat>
+#include <functional>
+
+namespace {
+const int kMaxQueuedFrames = 3;
+
+class StickerVideoSurface : public QAbstractVideoSurface
+{
+public:
+    StickerVideoSurface(std::function<void(const QVideoFrame &)> sink, QObject *parent)
+        : QAbstractVideoSurface(parent)
+        , m_sink(std::move(sink))
+    {
+    }
+
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+        QAbstractVideoBuffer::HandleType type) const override
+    {
+        if (type != QAbstractVideoBuffer::NoHandle) {
+            return QList<QVideoFrame::PixelFormat>();
+        }
+        QList<QVideoFrame::PixelFormat> formats;
+        formats << QVideoFrame::Format_ARGB32
+                << QVideoFrame::Format_ARGB32_Premultiplied
+                << QVideoFrame::Format_RGB32
+                << QVideoFrame::Format_RGB24
+                << QVideoFrame::Format_RGB565;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        // YUV 帧由工作线程转换，避免后端在 GUI 线程做色彩转换
+        formats << QVideoFrame::Format_YUV420P
+                << QVideoFrame::Format_NV12
+                << QVideoFrame::Format_YUYV;
+#endif
+        return formats;
+    }
+
+    bool present(const QVideoFrame &frame) override
+    {
+        if (m_sink) {
+            m_sink(frame);
+        }
+        return true;
+    }
+
+private:
+    std::function<void(const QVideoFrame &)> m_sink;
+};
+
+QImage convertFrame(QVideoFrame frame, const QSize &targetSize)
+{
+    QImage image;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    image = frame.image();
+#else
+    if (!frame.map(QAbstractVideoBuffer::ReadOnly)) {
+        return QImage();
+    }
+    const QImage::Format format = QVideoFrame::imageFormatFromPixelFormat(frame.pixelFormat());
+    if (format != QImage::Format_Invalid) {
+        image = QImage(frame.bits(), frame.width(), frame.height(), frame.bytesPerLine(), format).copy();
+    }
+    frame.unmap();
+#endif
+    if (image.isNull()) {
+        return QImage();
+    }
+    if (targetSize.isValid()
+        && (image.width() > targetSize.width() || image.height() > targetSize.height())) {
+        image = image.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+}
+
+StickerVideoSource::StickerVideoSource(QObject *parent)
+    : QObject(parent)
+    , m_player(new QMediaPlayer(this))
+    , m_surface(nullptr)
+    , m_decoder(new QObject())
+    , m_active(false)
+    , m_targetSize(600, 600)
+    , m_pendingFrames(0)
+    , m_droppedFrames(0)
+{
+    m_surface = new StickerVideoSurface([this](const QVideoFrame &frame) { submitFrame(frame); }, this);
+    m_player->setVideoOutput(m_surface);
+
+    m_decoder->moveToThread(&m_decodeThread);
+    connect(&m_decodeThread, &QThread::finished, m_decoder, &QObject::deleteLater);
+    m_decodeThread.setObjectName("StickerVideoDecode");
+    m_decodeThread.start();
+
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::EndOfMedia && m_config.loop) {
+            m_player->setPosition(0);
+            updatePlayback();
+        }
+    });
+    connect(m_player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this,
+            [this](QMediaPlayer::Error) {
+                qDebug() << "视频贴纸播放错误:" << m_config.path << m_player->errorString();
+            });
+}
+
+StickerVideoSource::~StickerVideoSource()
+{
+    m_player->stop();
+    m_player->setVideoOutput(static_cast<QAbstractVideoSurface*>(nullptr));
+    m_decodeThread.quit();
+    m_decodeThread.wait();
+}
+
+void StickerVideoSource::open(const StickerVideoConfig &config)
+{
+    if (isOpen() && m_config == config) {
+        return;
+    }
+
+    const bool mediaChanged = !isOpen() || m_config.path != config.path;
+    m_config = config;
+    m_player->setMuted(m_config.muted);
+    if (mediaChanged) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_frames.clear();
+        }
+        m_player->setMedia(QUrl::fromLocalFile(m_config.path));
+        qDebug() << "打开视频贴纸:" << m_config.path;
+    }
+    updatePlayback();
+}
+
+void StickerVideoSource::close()
+{
+    m_player->stop();
+    m_player->setMedia(QMediaContent());
+    m_config = StickerVideoConfig();
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+}
+
+bool StickerVideoSource::isOpen() const
+{
+    return !m_config.path.isEmpty();
+}
+
+void StickerVideoSource::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+    m_active = active;
+    if (!m_active) {
+        QMutexLocker locker(&m_mutex);
+        m_frames.clear();
+    }
+    updatePlayback();
+}
+
+bool StickerVideoSource::isActive() const
+{
+    return m_active;
+}
+
+void StickerVideoSource::setTargetSize(const QSize &size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_targetSize = size;
+}
+
+bool StickerVideoSource::takeFrame(QImage &frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_frames.isEmpty()) {
+        return false;
+    }
+    // 只取最新一帧，积压的旧帧计为丢帧
+    m_droppedFrames += m_frames.size() - 1;
+    frame = m_frames.last();
+    m_frames.clear();
+    return true;
+}
+
+qint64 StickerVideoSource::droppedFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_droppedFrames;
+}
+
+void StickerVideoSource::submitFrame(const QVideoFrame &frame)
+{
+    if (!m_active || !frame.isValid()) {
+        return;
+    }
+    if (m_pendingFrames.loadAcquire() >= kMaxQueuedFrames) {
+        QMutexLocker locker(&m_mutex);
+        ++m_droppedFrames;
+        return;
+    }
+
+    QSize targetSize;
+    {
+        QMutexLocker locker(&m_mutex);
+        targetSize = m_targetSize;
+    }
+    m_pendingFrames.ref();
+    QMetaObject::invokeMethod(m_decoder, [this, frame, targetSize]() {
+        const QImage image = convertFrame(frame, targetSize);
+        if (!image.isNull()) {
+            enqueueFrame(image);
+        }
+        m_pendingFrames.deref();
+    }, Qt::QueuedConnection);
+}
+
+void StickerVideoSource::enqueueFrame(const QImage &frame)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_frames.size() >= kMaxQueuedFrames) {
+            m_frames.dequeue();
+            ++m_droppedFrames;
+        }
+        m_frames.enqueue(frame);
+    }
+    QMetaObject::invokeMethod(this, [this]() { emit frameReady(); }, Qt::QueuedConnection);
+}
+
+void StickerVideoSource::updatePlayback()
+{
+    if (!isOpen()) {
+        return;
+    }
+    if (m_active) {
+        m_player->play();
+    } else {
+        m_player->pause();
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef STICKERVIDEOSOURCE_H
+#define STICKERVIDEOSOURCE_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QSize>
+#include <QThread>
+#include <QVideoFrame>
+#include "stickerdata.h"
+
+class QMediaPlayer;
+class QAbstractVideoSurface;
+
+// 视频贴纸帧源：QMediaPlayer 输出的帧交给工作线程转换/缩放，
+// 结果放入最多 3 帧的队列，GUI 线程只取最新一帧绘制，积压帧直接丢弃
+class StickerVideoSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StickerVideoSource(QObject *parent = nullptr);
+    ~StickerVideoSource();
+
+    void open(const StickerVideoConfig &config);
+    void close();
+    bool isOpen() const;
+
+    // 贴纸隐藏、跟随目标最小化时暂停播放
+    void setActive(bool active);
+    bool isActive() const;
+
+    // 工作线程把帧缩放到不超过该物理尺寸
+    void setTargetSize(const QSize &size);
+
+    bool takeFrame(QImage &frame);
+    qint64 droppedFrames() const;
+
+signals:
+    void frameReady();
+
+private:
+    void submitFrame(const QVideoFrame &frame);
+    void enqueueFrame(const QImage &frame);
+    void updatePlayback();
+
+    QMediaPlayer *m_player;
+    QAbstractVideoSurface *m_surface;
+    QThread m_decodeThread;
+    QObject *m_decoder;
+    StickerVideoConfig m_config;
+    bool m_active;
+
+    mutable QMutex m_mutex;
+    QQueue<QImage> m_frames;
+    QSize m_targetSize;
+    QAtomicInt m_pendingFrames;
+    qint64 m_droppedFrames;
+};
+
+#endif // STICKERVIDEOSOURCE_H
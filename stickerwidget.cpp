@@ -1,4 +1,4 @@
-#include "StickerWidget.h"
+#include "stickerwidget.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QWheelEvent>
@@ -6,16 +6,36 @@
 #include <QApplication>
 #include <QScreen>
 #include <QResizeEvent>
+#include <QMoveEvent>
+#include <QPaintEvent>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
 #include <QDebug>
 #include <QtMath>
+#include <cmath>
+#include <QWindow>
+#include <QElapsedTimer>
+#include "stickercompositor.h"
+#include "stickercontextmenucontroller.h"
+#include "stickereventcontroller.h"
+#include "stickerframeclock.h"
+#include "stickergeometrybatch.h"
+#include "stickerlive2dhost.h"
+#include "stickerlive2dmanifest.h"
+#include "stickerpresenter.h"
+#include "stickerrastersurface.h"
+#include "stickermemorybudget.h"
 #include "stickertransformlayout.h"
-#include "live2dwidget.h"
+#include "stickervideosource.h"
 
 namespace {
+const int kBorderWidth = 4;
+const int kSettleMs = 150;
+const int kPulseFrameMs = 50;
+const int kMotionFrameMs = 33;
+
 bool fuzzyEqual(double a, double b)
 {
     return qFuzzyCompare(a + 1.0, b + 1.0);
@@ -27,7 +47,8 @@ bool transformEqual(const StickerTransform &a, const StickerTransform &b)
         && fuzzyEqual(a.scaleY, b.scaleY)
         && fuzzyEqual(a.rotation, b.rotation)
         && fuzzyEqual(a.shearX, b.shearX)
-        && fuzzyEqual(a.shearY, b.shearY);
+        && fuzzyEqual(a.shearY, b.shearY)
+        && a.motion == b.motion;
 }
 
 bool followEqual(const StickerFollowConfig &a, const StickerFollowConfig &b)
@@ -81,7 +102,9 @@ bool configEqual(const StickerConfig &a, const StickerConfig &b)
         && a.name == b.name
         && a.contentType == b.contentType
         && a.imagePath == b.imagePath
+        && a.tiledImage == b.tiledImage
         && live2dEqual(a.live2d, b.live2d)
+        && a.video == b.video
         && a.position == b.position
         && a.size == b.size
         && a.isDesktopMode == b.isDesktopMode
@@ -89,7 +112,9 @@ bool configEqual(const StickerConfig &a, const StickerConfig &b)
         && fuzzyEqual(a.opacity, b.opacity)
         && a.allowDrag == b.allowDrag
         && a.clickThrough == b.clickThrough
+        && a.zOrder == b.zOrder
         && transformEqual(a.transform, b.transform)
+        && a.effects == b.effects
         && followEqual(a.follow, b.follow)
         && eventsEqual(a.events, b.events);
 }
@@ -99,21 +124,34 @@ StickerWidget::StickerWidget(const StickerConfig &config, QWidget *parent)
     : QWidget(parent)
     , m_config(config)
     , m_image(600)
-    , m_renderer(&m_image)
+    , m_effects(&m_image)
+    , m_tiledImage()
+    , m_renderer(&m_effects)
     , m_interactionController()
     , m_editController(this, this)
-    , m_menuController(this)
-    , m_eventController(this)
-    , m_live2dWidget(nullptr)
-    , m_live2dRenderSize()
-    , m_live2dBoundsSourceSize()
-    , m_live2dBoundsPx()
-    , m_live2dBoundsOffset(0, 0)
-    , m_hasLive2dBounds(false)
-    , m_autoFitLive2d(true)
+    , m_menuController(nullptr)
+    , m_eventController(nullptr)
+    , m_live2d(nullptr)
+    , m_videoSource(nullptr)
+    , m_tiledPaintedRect()
+    , m_followTargetMinimized(false)
     , m_initialized(false)
     , m_runtimeHidden(false)
+    , m_resourcesEvicted(false)
+    , m_presenter(this)
+    , m_geometryBatch(nullptr)
+    , m_hasPendingPos(false)
+    , m_pendingApplied(false)
+    , m_pendingPos()
+    , m_promotedForEdit(false)
+    , m_hitRegion()
     , m_animationAngle(0)
+    , m_pulseAlpha(-1)
+    , m_motionElapsedMs(0)
+    , m_paintStats()
+    , m_lowFidelity(false)
+    , m_settleTimer(nullptr)
+    , m_opacityAnimation(nullptr)
 {
     // 基础设置
     setAttribute(Qt::WA_TranslucentBackground, true);
@@ -140,46 +178,62 @@ StickerWidget::StickerWidget(const StickerConfig &config, QWidget *parent)
         }
     }
 
-    // 创建动画定时器
-    m_animationTimer = new QTimer(this);
-    connect(m_animationTimer, &QTimer::timeout, this, &StickerWidget::onAnimationTimer);
-    m_animationTimer->start(50); // 20 FPS
-
-    // 设置透明度动画
-    m_opacityAnimation = new QPropertyAnimation(this, "windowOpacity");
-    m_opacityAnimation->setDuration(300);
-    m_opacityAnimation->setEasingCurve(QEasingCurve::OutCubic);
+    // 显示方式与重绘调度；被遮挡时推迟的重绘由全局遮挡检测复查后补画，离屏的在移动或屏幕变化后补画，
+    // 视频同时恢复解码
+    StickerPresenter::Callbacks presenterCallbacks;
+    presenterCallbacks.wantsVisible = [this]() { return !m_runtimeHidden && m_config.visible; };
+    presenterCallbacks.visibleRect = [this]() { return tiledVisibleRect(); };
+    presenterCallbacks.uncovered = [this]() { updateVideoPlayback(); };
+    m_presenter.setCallbacks(std::move(presenterCallbacks));
+    const auto watchScreen = [this](QScreen *screen) {
+        connect(screen, &QScreen::geometryChanged, this, [this]() { m_presenter.geometryChanged(); });
+    };
+    for (QScreen *screen : QApplication::screens()) {
+        watchScreen(screen);
+    }
+    connect(qApp, &QGuiApplication::screenAdded, this, [this, watchScreen](QScreen *screen) {
+        watchScreen(screen);
+        m_presenter.geometryChanged();
+    });
 
-    // 设置上下文菜单
-    setupContextMenu();
+    // 订阅全局帧时钟（默认 20 FPS，关键帧动作时提到约 30 FPS），只有动画中且可见时才会被驱动
+    StickerFrameClock::instance()->subscribe(this, [this](qint64 elapsedMs) {
+        advanceAnimation(elapsedMs);
+    }, kPulseFrameMs);
 
     StickerInteractionController::Callbacks interactionCallbacks;
     interactionCallbacks.widgetRect = [this]() { return rect(); };
     interactionCallbacks.frameGeometry = [this]() { return frameGeometry(); };
-    interactionCallbacks.moveWindow = [this](const QPoint &pos) { move(pos); };
+    interactionCallbacks.moveWindow = [this](const QPoint &pos) { moveWindow(pos); };
+    interactionCallbacks.beginInteractiveChange = [this]() { beginLowFidelity(); };
     interactionCallbacks.updateTransformLayout = [this]() {
         updateTransformedWindowSize(ResizeAnchor::KeepCenter);
     };
     interactionCallbacks.applyMask = [this]() { applyMask(); };
-    interactionCallbacks.requestUpdate = [this]() { update(); };
+    interactionCallbacks.requestUpdate = [this]() { requestRepaint(); };
     interactionCallbacks.notifyConfigChanged = [this]() { emit configChanged(m_config); };
     m_interactionController.setCallbacks(std::move(interactionCallbacks));
 
     connect(&m_editController, &StickerEditController::editModeChanged, this, [this](bool) {
         updateContextMenuState();
-        update();
+        requestBorderRepaint();
+        if (m_live2d) {
+            m_live2d->updateHitTesting();
+        }
     });
-
-    m_eventController.setEvents(&m_config.events);
-
-    // 连接事件处理器信号
-    connect(&m_eventController, &StickerEventController::eventExecuted, [this](const QString &message) {
-        qDebug() << "贴纸事件执行成功:" << message;
+    connect(&m_editController, &StickerEditController::windowFlagsApplied, this, [this]() {
+        if (m_live2d) {
+            m_live2d->resetInputTransparent();
+        }
     });
 
-    connect(&m_eventController, &StickerEventController::eventFailed, [this](const QString &error) {
-        qDebug() << "贴纸事件执行失败:" << error;
-    });
+    StickerMemoryBudget::Callbacks budgetCallbacks;
+    budgetCallbacks.stickerId = [this]() { return m_config.id; };
+    budgetCallbacks.residentBytes = [this]() { return residentBytes(); };
+    budgetCallbacks.evict = [this]() { evictResources(); };
+    StickerMemoryBudget::instance().registerClient(this, std::move(budgetCallbacks));
+
+    StickerCompositor::instance()->registerSticker(this);
 
     // 初始化窗口
     initializeWidget();
@@ -189,9 +243,10 @@ StickerWidget::StickerWidget(const StickerConfig &config, QWidget *parent)
 
 StickerWidget::~StickerWidget()
 {
-    if (m_animationTimer) {
-        m_animationTimer->stop();
-    }
+    releaseLive2DHost();
+    StickerMemoryBudget::instance().unregisterClient(this);
+    StickerCompositor::instance()->unregisterSticker(this);
+    StickerFrameClock::instance()->unsubscribe(this);
     qDebug() << "销毁贴纸:" << m_config.id;
 }
 
@@ -204,13 +259,22 @@ void StickerWidget::initializeWidget()
             configAdjusted = true;
         }
         if (m_config.live2d.baseSize.isEmpty()) {
-            m_config.live2d.baseSize = m_config.size.isEmpty() ? QSize(200, 200) : m_config.size;
+            m_config.live2d.baseSize = StickerLive2DManifest::defaultBaseSize(
+                m_config.live2d.modelJsonPath, m_config.size.isEmpty() ? QSize(200, 200) : m_config.size);
             configAdjusted = true;
         }
-        ensureLive2DWidget();
-        applyLive2DConfig();
+        ensureLive2DHost();
+        m_live2d->start();
+    } else if (m_config.contentType == StickerContentType::Video) {
+        releaseLive2DHost();
+        // 视频帧不经过描边/阴影阶段，首帧到达前先显示默认贴纸
+        m_effects.setEffects(StickerEffectConfig());
+        createDefaultSticker();
+        ensureVideoSource();
     } else {
-        releaseLive2DWidget();
+        releaseLive2DHost();
+        releaseVideoSource();
+        m_effects.setEffects(m_config.effects);
         // 加载贴纸图像
         if (!m_config.imagePath.isEmpty() && QFileInfo::exists(m_config.imagePath)) {
             loadStickerImage(m_config.imagePath);
@@ -237,6 +301,8 @@ void StickerWidget::initializeWidget()
     setVisible(m_config.visible);
 
     m_initialized = true;
+    updateAnimationState();
+    updateCompositing();
 
     if (configAdjusted) {
         emit configChanged(m_config);
@@ -249,106 +315,496 @@ void StickerWidget::loadStickerImage(const QString &imagePath)
 {
     qDebug() << "加载贴纸图像:" << imagePath;
 
+    if (m_config.tiledImage) {
+        QSize maxLogicalSize(600, 600);
+        if (QScreen *screen = QApplication::primaryScreen()) {
+            maxLogicalSize = screen->availableGeometry().size();
+        }
+        if (m_tiledImage.load(imagePath, maxLogicalSize)) {
+            m_image.clear();
+            m_tiledPaintedRect = QRect();
+            m_renderer.setTiledSource(&m_tiledImage);
+            qDebug() << "分块贴纸加载完成，逻辑大小:" << m_tiledImage.logicalSize();
+            return;
+        }
+        qDebug() << "分块加载失败，回退到普通图像";
+    }
+    m_tiledImage.clear();
+    m_renderer.setTiledSource(nullptr);
+
     if (!m_image.loadFromPath(imagePath)) {
         qDebug() << "无法加载图像，使用默认贴纸";
         createDefaultSticker();
         return;
     }
 
-    const QPixmap &pixmap = m_image.pixmap();
-    if (!pixmap.isNull() && pixmap.size() != size()) {
-        setFixedSize(pixmap.size());
-        m_config.size = pixmap.size();
+    const QSize logicalSize = m_image.logicalSize();
+    if (!logicalSize.isEmpty() && logicalSize != size()) {
+        resizeWindow(logicalSize);
+        m_config.size = logicalSize;
     }
 
-    qDebug() << "贴纸图像加载完成，大小:" << pixmap.size();
+    qDebug() << "贴纸图像加载完成，大小:" << logicalSize;
 }
 
 void StickerWidget::createDefaultSticker()
 {
+    m_tiledImage.clear();
+    m_renderer.setTiledSource(nullptr);
     m_image.createDefault();
 
     qDebug() << "默认贴纸创建完成";
 }
 
-void StickerWidget::ensureLive2DWidget()
+// 只有 Live2D 贴纸持有承载对象，跟随目标最小化与遮挡一并视为不需要渲染
+void StickerWidget::ensureLive2DHost()
 {
-    if (!m_live2dWidget) {
-        m_live2dWidget = new Live2DWidget(this);
-        m_live2dWidget->setAttribute(Qt::WA_TranslucentBackground);
-        m_live2dWidget->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-        m_live2dWidget->setAutoFillBackground(false);
-        m_live2dWidget->setFocusPolicy(Qt::NoFocus);
-        connect(m_live2dWidget, &Live2DWidget::visibleBoundsChanged,
-                this, &StickerWidget::onLive2DBoundsChanged, Qt::UniqueConnection);
+    if (m_live2d) {
+        return;
     }
+    StickerLive2DHost::Callbacks callbacks;
+    callbacks.isShown = [this]() { return isShownOnScreen(); };
+    callbacks.isSuppressed = [this]() { return m_followTargetMinimized || isPaintSuppressed(); };
+    callbacks.isEvicted = [this]() { return m_resourcesEvicted; };
+    callbacks.isEditing = [this]() { return m_editController.isEditMode(); };
+    callbacks.requestRepaint = [this]() { requestRepaint(); };
+    callbacks.refit = [this]() { updateTransformedWindowSize(ResizeAnchor::KeepTopLeft); };
+    m_live2d = new StickerLive2DHost(this, &m_config, std::move(callbacks));
+}
 
-    updateLive2DGeometry();
-    m_live2dWidget->show();
-    m_live2dWidget->raise();
+void StickerWidget::releaseLive2DHost()
+{
+    delete m_live2d;
+    m_live2d = nullptr;
 }
 
-void StickerWidget::releaseLive2DWidget()
+void StickerWidget::ensureVideoSource()
 {
-    if (!m_live2dWidget) {
-        return;
-    }
-    m_live2dWidget->hide();
-    disconnect(m_live2dWidget, nullptr, this, nullptr);
-    m_live2dWidget->deleteLater();
-    m_live2dWidget = nullptr;
-    m_live2dRenderSize = QSize();
-    m_live2dBoundsSourceSize = QSize();
-    m_live2dBoundsPx = QRectF();
-    m_live2dBoundsOffset = QPoint(0, 0);
-    m_hasLive2dBounds = false;
+    if (!m_videoSource) {
+        m_videoSource = new StickerVideoSource(this);
+        connect(m_videoSource, &StickerVideoSource::frameReady,
+                this, &StickerWidget::onVideoFrameReady, Qt::UniqueConnection);
+    }
+    const qreal dpr = devicePixelRatioF();
+    m_videoSource->setTargetSize(QSize(qCeil(600 * dpr), qCeil(600 * dpr)));
+    m_videoSource->open(m_config.video);
+    updateVideoPlayback();
 }
 
-void StickerWidget::rebuildLive2DWidget()
+void StickerWidget::releaseVideoSource()
 {
-    if (m_config.contentType != StickerContentType::Live2D) {
+    if (!m_videoSource) {
         return;
     }
-    releaseLive2DWidget();
-    ensureLive2DWidget();
-    applyLive2DConfig();
-    updateTransformedWindowSize(ResizeAnchor::KeepTopLeft);
+    disconnect(m_videoSource, nullptr, this, nullptr);
+    m_videoSource->close();
+    m_videoSource->deleteLater();
+    m_videoSource = nullptr;
 }
 
-void StickerWidget::applyLive2DConfig()
+// 隐藏、跟随目标最小化、离屏或被完全遮挡时暂停解码；遮挡解除由遮挡复查恢复播放
+void StickerWidget::updateVideoPlayback()
 {
-    if (!m_live2dWidget) {
+    if (!m_videoSource) {
         return;
     }
-    m_live2dWidget->applyConfig(m_config.live2d);
+    bool active = isShownOnScreen() && !m_resourcesEvicted && !m_followTargetMinimized;
+    if (active && isPaintSuppressed()) {
+        active = false;
+        m_presenter.deferUntilUncovered();
+    }
+    m_videoSource->setActive(active);
 }
 
-void StickerWidget::updateLive2DGeometry()
+void StickerWidget::onVideoFrameReady()
 {
-    if (!m_live2dWidget) {
+    if (!m_videoSource) {
         return;
     }
-    QSize renderSize = m_live2dRenderSize.isValid() ? m_live2dRenderSize : size();
-    QPoint offset = (m_autoFitLive2d && m_hasLive2dBounds) ? m_live2dBoundsOffset : QPoint(0, 0);
-    QRect rect(QPoint(-offset.x(), -offset.y()), renderSize);
-    m_live2dWidget->setGeometry(rect);
+    QImage frame;
+    if (!m_videoSource->takeFrame(frame)) {
+        return;
+    }
+    // 窗口不可见或未暴露（被遮挡/最小化）时丢帧
+    QWindow *window = m_presenter.surface() ? m_presenter.surface() : windowHandle();
+    if (!isShownOnScreen() || (!isComposited() && window && !window->isExposed())) {
+        return;
+    }
+    if (isPaintSuppressed()) {
+        updateVideoPlayback();
+        return;
+    }
+
+    if (m_image.setFrame(frame, devicePixelRatioF())) {
+        const QSize logicalSize = m_image.logicalSize();
+        if (logicalSize != size()) {
+            resizeWindow(logicalSize);
+            m_config.size = logicalSize;
+        }
+        updateTransformedWindowSize(ResizeAnchor::KeepTopLeft);
+        applyMask();
+    }
+    requestRepaint();
 }
 
 void StickerWidget::applyMask()
 {
-    if (m_config.contentType != StickerContentType::Image) {
-        clearMask();
+    if (m_resourcesEvicted) {
         return;
     }
 
-    QBitmap mask = m_renderer.buildMask(m_config, size());
-    if (!mask.isNull()) {
-        setMask(mask);
+    QRegion region;
+    if (m_config.contentType == StickerContentType::Live2D) {
+        region = QRegion();
+    } else if (hasMotion()) {
+        // 关键帧动作取整个周期扫过区域的并集，只在动作/变换/尺寸变化时重建，逐帧不更新；
+        // 视频与手势进行中同样只取内容多边形
+        region = m_renderer.motionMask(m_config, size(),
+                                       m_config.contentType != StickerContentType::Video && !m_lowFidelity);
+    } else if (m_renderer.isTiled() || m_config.contentType == StickerContentType::Video
+               || m_lowFidelity) {
+        // 分块与视频贴纸用变换后的内容多边形，只在尺寸/变换变化时重建，不随每帧更新；
+        // 手势进行中也先用多边形，停下后再换精确的 Alpha 遮罩
+        const QPolygon polygon = m_renderer.contentPolygon(m_config, size());
+        if (!polygon.isEmpty()) {
+            region = QRegion(polygon);
+        }
     } else {
+        // 复用当前屏幕缩放下的栅格，避免为遮罩额外生成 1x 位图
+        QBitmap mask = m_renderer.buildMask(m_config, size(), devicePixelRatioF());
+        if (!mask.isNull()) {
+            region = QRegion(mask);
+        }
+    }
+
+    m_hitRegion = region;
+    // 合成模式下遮罩只用于叠加层命中测试；轻量窗口把遮罩设在 QWindow 上
+    if (m_presenter.presentation() != Presentation::Widget || region.isEmpty()) {
         clearMask();
+    } else {
+        setMask(region);
+    }
+    if (m_presenter.surface()) {
+        m_presenter.surface()->setMask(region);
+    }
+    if (isComposited()) {
+        StickerCompositor::instance()->hitRegionChanged(this);
+    }
+}
+
+void StickerWidget::moveWindow(const QPoint &pos)
+{
+    const QRect current = windowGeometry();
+    if (pos == current.topLeft() || deferMove(pos)) {
+        return;
+    }
+    m_hasPendingPos = false;
+    m_pendingApplied = false;
+    const QRect oldGeometry = geometry();
+    move(pos);
+    if (m_presenter.surface()) {
+        m_presenter.surface()->setPosition(pos);
+        // 隐藏的 QWidget 不会收到 moveEvent，分块贴纸与离屏推迟的重绘在这里补做可见区域检查
+        if (m_renderer.isTiled() && !m_tiledPaintedRect.contains(tiledVisibleRect())) {
+            requestRepaint();
+        }
+        m_presenter.geometryChanged();
+    } else if (isComposited()) {
+        StickerCompositor::instance()->stickerGeometryChanged(this, oldGeometry);
+        m_presenter.geometryChanged();
+    }
+}
+
+void StickerWidget::resizeWindow(const QSize &size)
+{
+    if (size == this->size()) {
+        return;
+    }
+    const QRect oldGeometry = geometry();
+    setFixedSize(size);
+    if (m_presenter.surface()) {
+        m_presenter.surface()->resize(size);
+    } else if (isComposited()) {
+        StickerCompositor::instance()->stickerGeometryChanged(this, oldGeometry);
     }
 }
 
+void StickerWidget::requestRepaint(const QRect &rect)
+{
+    requestRepaint(QRegion(rect.isNull() ? this->rect() : rect));
+}
+
+// 按显示方式分派；离屏或被完全遮挡时只记下待重绘，由遮挡复查补画
+void StickerWidget::requestRepaint(const QRegion &region)
+{
+    m_presenter.requestRepaint(region);
+}
+
+// 只重绘编辑边框所在的一圈，不动内容
+void StickerWidget::requestBorderRepaint()
+{
+    requestRepaint(borderRegion());
+}
+
+QRegion StickerWidget::borderRegion() const
+{
+    const QRect outer = rect();
+    return QRegion(outer) - QRegion(outer.adjusted(kBorderWidth, kBorderWidth, -kBorderWidth, -kBorderWidth));
+}
+
+bool StickerWidget::isPaintSuppressed()
+{
+    return m_presenter.isPaintSuppressed();
+}
+
+void StickerWidget::beginLowFidelity()
+{
+    if (!m_lowFidelity) {
+        m_lowFidelity = true;
+        m_renderer.setLowFidelity(true);
+    }
+    // 手势/预览停止输入后恢复平滑绘制和精确遮罩
+    if (!m_settleTimer) {
+        m_settleTimer = new QTimer(this);
+        m_settleTimer->setSingleShot(true);
+        m_settleTimer->setInterval(kSettleMs);
+        connect(m_settleTimer, &QTimer::timeout, this, &StickerWidget::onInteractionSettled);
+    }
+    m_settleTimer->start();
+}
+
+void StickerWidget::onInteractionSettled()
+{
+    if (!m_lowFidelity) {
+        return;
+    }
+    m_lowFidelity = false;
+    m_renderer.setLowFidelity(false);
+    applyMask();
+    requestRepaint();
+}
+
+StickerWidget::PaintStats StickerWidget::paintStats() const
+{
+    PaintStats stats = m_paintStats;
+    stats.skippedCount = m_presenter.skippedCount();
+    if (m_live2d) {
+        const StickerLive2DHost::Stats live2dStats = m_live2d->stats();
+        stats.boundsUpdates = live2dStats.boundsUpdates;
+        stats.boundsFits = live2dStats.boundsFits;
+        stats.resizesAvoided = live2dStats.resizesAvoided;
+    }
+    return stats;
+}
+
+void StickerWidget::updateCompositing()
+{
+    StickerCompositor::instance()->refresh(this);
+}
+
+bool StickerWidget::isCompositeEligible() const
+{
+    return m_initialized
+        && m_config.contentType != StickerContentType::Live2D
+        && !m_editController.isEditMode()
+        && !m_promotedForEdit
+        && !m_config.follow.enabled
+        && (m_config.isDesktopMode || m_config.clickThrough);
+}
+
+bool StickerWidget::isRasterSurfaceEligible() const
+{
+    return m_initialized
+        && m_config.contentType == StickerContentType::Image
+        && !m_editController.isEditMode()
+        && !m_promotedForEdit;
+}
+
+bool StickerWidget::isComposited() const
+{
+    return m_presenter.isComposited();
+}
+
+StickerWidget::Presentation StickerWidget::presentation() const
+{
+    return m_presenter.presentation();
+}
+
+void StickerWidget::setPresentation(Presentation presentation)
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (!m_presenter.setPresentation(presentation, !m_runtimeHidden && m_config.visible)) {
+        return;
+    }
+
+    applyMask();
+    updateVisibilityState();
+    requestRepaint();
+
+    static const char *names[] = { "独立窗口", "轻量窗口", "叠加层合成" };
+    qDebug() << "贴纸" << m_config.id << "切换到" << names[int(presentation)]
+             << "耗时" << timer.nsecsElapsed() / 1000 << "us"
+             << "窗口缓冲约" << windowBackingBytes() / 1024 << "KB";
+    emit stackingChanged();
+}
+
+bool StickerWidget::isShownOnScreen() const
+{
+    return m_presenter.isShownOnScreen();
+}
+
+QRegion StickerWidget::hitRegion() const
+{
+    return m_hitRegion.isEmpty() ? QRegion(rect()) : m_hitRegion;
+}
+
+bool StickerWidget::dispatchForwardedEvent(QEvent *event)
+{
+    return QWidget::event(event);
+}
+
+WindowHandle StickerWidget::nativeHandle()
+{
+    if (m_presenter.surface()) {
+        return WindowHandle(m_presenter.surface()->winId());
+    }
+    return WindowHandle(winId());
+}
+
+int StickerWidget::stackOrder() const
+{
+    return m_config.zOrder;
+}
+
+bool StickerWidget::isStackedOnDesktop() const
+{
+    return m_config.isDesktopMode;
+}
+
+bool StickerWidget::isRestackable() const
+{
+    return m_initialized
+        && isShownOnScreen()
+        && m_presenter.presentation() != Presentation::Composited
+        && !m_editController.isEditMode()
+        && !m_config.follow.enabled;
+}
+
+void StickerWidget::raiseWindow()
+{
+    if (m_presenter.surface()) {
+        m_presenter.surface()->raise();
+    } else {
+        raise();
+    }
+}
+
+void StickerWidget::lowerWindow()
+{
+    if (m_presenter.surface()) {
+        m_presenter.surface()->lower();
+    } else {
+        lower();
+    }
+}
+
+void StickerWidget::setGeometryBatch(StickerGeometryBatch *batch)
+{
+    m_geometryBatch = batch;
+}
+
+void StickerWidget::commitBatchedGeometry(bool nativeApplied)
+{
+    if (!m_hasPendingPos) {
+        return;
+    }
+    if (!nativeApplied) {
+        m_hasPendingPos = false;
+        moveWindow(m_pendingPos);
+        return;
+    }
+
+    if (m_presenter.surface()) {
+        // 贴纸自身的 QWidget 没有原生窗口，move 只更新缓存；轻量窗口的 QWindow 几何由系统的位置变化通知同步
+        m_hasPendingPos = false;
+        move(m_pendingPos);
+        if (m_renderer.isTiled() && !m_tiledPaintedRect.contains(tiledVisibleRect())) {
+            requestRepaint();
+        }
+        m_presenter.geometryChanged();
+    } else {
+        // 原生窗口已到位，Qt 处理系统的位置变化通知后更新 geometry() 并发出 moveEvent，
+        // 在那之前 windowGeometry() 仍报告批量提交的位置
+        m_pendingApplied = true;
+    }
+}
+
+QRect StickerWidget::windowGeometry() const
+{
+    return m_hasPendingPos ? QRect(m_pendingPos, size()) : geometry();
+}
+
+bool StickerWidget::deferMove(const QPoint &pos)
+{
+    if (!m_geometryBatch || !m_geometryBatch->isOpen()) {
+        return false;
+    }
+    const WindowHandle handle = batchHandle();
+    if (handle == 0) {
+        return false;
+    }
+    m_hasPendingPos = true;
+    m_pendingApplied = false;
+    m_pendingPos = pos;
+    m_geometryBatch->setPosition(handle, pos, this);
+    return true;
+}
+
+// 只有已创建且可见的原生窗口值得批量；合成模式与尚未显示的窗口直接更新 Qt 状态即可。
+// 批量后端按原生像素下发位置，缩放比不为 1 时交给 Qt 自行换算
+WindowHandle StickerWidget::batchHandle() const
+{
+    if (!qFuzzyCompare(devicePixelRatioF(), 1.0)) {
+        return 0;
+    }
+    if (m_presenter.surface()) {
+        return (m_presenter.surface()->handle() && m_presenter.surface()->isVisible()) ? WindowHandle(m_presenter.surface()->winId()) : 0;
+    }
+    if (m_presenter.presentation() == Presentation::Widget && testAttribute(Qt::WA_WState_Created)
+        && QWidget::isVisible()) {
+        return WindowHandle(effectiveWinId());
+    }
+    return 0;
+}
+
+// 原生窗口后备缓冲的估算字节数，合成模式下由叠加层共享，不计入单个贴纸
+qint64 StickerWidget::windowBackingBytes() const
+{
+    const bool hasWindow = m_presenter.surface()
+        || (m_presenter.presentation() == Presentation::Widget && testAttribute(Qt::WA_WState_Created));
+    if (!hasWindow) {
+        return 0;
+    }
+    const qreal dpr = devicePixelRatioF();
+    return qint64(width() * dpr) * qint64(height() * dpr) * 4;
+}
+
+// 窗口落在各屏幕内的部分（窗口坐标），分块贴纸只解码这部分
+QRect StickerWidget::tiledVisibleRect() const
+{
+    QRect visible;
+    const QList<QScreen*> screens = QApplication::screens();
+    for (QScreen *screen : screens) {
+        if (!screen) {
+            continue;
+        }
+        const QRect screenRect = screen->geometry();
+        visible |= QRect(mapFromGlobal(screenRect.topLeft()), screenRect.size()) & rect();
+    }
+    return visible;
+}
+
 void StickerWidget::updateTransformedWindowSize(ResizeAnchor anchor)
 {
     StickerTransformLayoutResult layout;
@@ -363,9 +819,15 @@ void StickerWidget::updateTransformedWindowSize(ResizeAnchor anchor)
         if (!StickerTransformLayout::calculate(m_config, baseSize, layout)) {
             return;
         }
+    } else if (m_renderer.isTiled()) {
+        baseSize = m_tiledImage.logicalSize();
+        contentRect = QRect(QPoint(0, 0), baseSize);
+        if (!m_renderer.calculateLayout(m_config, layout)) {
+            return;
+        }
     } else {
-        baseSize = m_image.baseSize();
-        contentRect = m_image.contentRect();
+        baseSize = m_effects.baseSize();
+        contentRect = m_effects.contentRect();
         if (!m_renderer.calculateLayout(m_config, layout)) {
             return;
         }
@@ -375,50 +837,17 @@ void StickerWidget::updateTransformedWindowSize(ResizeAnchor anchor)
         return;
     }
 
-    const double kLive2dBoundsMarginRatio = 0.02;
-    const double kLive2dBoundsStableRatio = 0.05;
     QSize renderSize = layout.windowSize;
     QSize targetSize = renderSize;
     QPoint boundsOffset(0, 0);
-    QSize oldRenderSize = m_live2dRenderSize.isValid() ? m_live2dRenderSize : renderSize;
-    QPoint oldBoundsOffset = m_live2dBoundsOffset;
-    if (m_config.contentType == StickerContentType::Live2D) {
-        m_live2dRenderSize = renderSize;
-        if (m_autoFitLive2d && m_hasLive2dBounds && m_live2dBoundsSourceSize == renderSize) {
-            QRectF bounds = m_live2dBoundsPx;
-            if (bounds.isValid()) {
-                const double marginX = bounds.width() * kLive2dBoundsMarginRatio * 0.5;
-                const double marginY = bounds.height() * kLive2dBoundsMarginRatio * 0.5;
-                if (marginX > 0.0 || marginY > 0.0) {
-                    bounds.adjust(-marginX, -marginY, marginX, marginY);
-                }
-            }
-            QRectF limit(QPointF(0, 0), QSizeF(renderSize));
-            QRectF clipped = bounds.intersected(limit);
-            if (clipped.isValid() && clipped.width() >= 1.0 && clipped.height() >= 1.0) {
-                QSize candidateSize(qMax(1, int(qCeil(clipped.width()))),
-                                    qMax(1, int(qCeil(clipped.height()))));
-                QPoint candidateOffset = clipped.topLeft().toPoint();
-                bool applyCandidate = true;
-                if (renderSize == oldRenderSize && size().isValid()) {
-                    int stableDx = qMax(1, int(qRound(renderSize.width() * kLive2dBoundsStableRatio)));
-                    int stableDy = qMax(1, int(qRound(renderSize.height() * kLive2dBoundsStableRatio)));
-                    if (qAbs(candidateSize.width() - size().width()) < stableDx
-                        && qAbs(candidateSize.height() - size().height()) < stableDy
-                        && qAbs(candidateOffset.x() - m_live2dBoundsOffset.x()) < stableDx
-                        && qAbs(candidateOffset.y() - m_live2dBoundsOffset.y()) < stableDy) {
-                        applyCandidate = false;
-                    }
-                }
-                if (applyCandidate) {
-                    targetSize = candidateSize;
-                    boundsOffset = candidateOffset;
-                } else {
-                    targetSize = size();
-                    boundsOffset = m_live2dBoundsOffset;
-                }
-            }
-        }
+    QSize oldRenderSize = renderSize;
+    QPoint oldBoundsOffset(0, 0);
+    if (m_live2d) {
+        const StickerLive2DHost::Fit fit = m_live2d->fitWindow(renderSize, size());
+        targetSize = fit.windowSize;
+        boundsOffset = fit.boundsOffset;
+        oldRenderSize = fit.oldRenderSize;
+        oldBoundsOffset = fit.oldBoundsOffset;
     }
 
     if (m_editController.isEditMode()) {
@@ -441,10 +870,10 @@ void StickerWidget::updateTransformedWindowSize(ResizeAnchor anchor)
                  << "shear" << m_config.transform.shearX << m_config.transform.shearY;
     }
 
-    QPoint oldTopLeft = pos();
-    QPoint oldCenter = geometry().center();
+    QPoint oldTopLeft = windowGeometry().topLeft();
+    QPoint oldCenter = windowGeometry().center();
     QPoint newTopLeft = oldTopLeft;
-    if (m_config.contentType == StickerContentType::Live2D) {
+    if (m_live2d) {
         QPoint oldRenderTopLeft = oldTopLeft - oldBoundsOffset;
         if (anchor == ResizeAnchor::KeepCenter) {
             QPoint oldRenderCenter = oldRenderTopLeft
@@ -462,23 +891,11 @@ void StickerWidget::updateTransformedWindowSize(ResizeAnchor anchor)
         }
     }
 
-    if (m_config.contentType == StickerContentType::Live2D) {
-        m_live2dBoundsOffset = boundsOffset;
-    }
+    resizeWindow(targetSize);
+    moveWindow(newTopLeft);
 
-    if (targetSize != size()) {
-        setFixedSize(targetSize);
-    }
-    if (pos() != newTopLeft) {
-        move(newTopLeft);
-    }
-
-    if (m_live2dWidget) {
-        if (m_config.contentType == StickerContentType::Live2D) {
-            updateLive2DGeometry();
-        } else {
-            m_live2dWidget->setGeometry(rect());
-        }
+    if (m_live2d) {
+        m_live2d->updateGeometry();
     }
 
     bool configDirty = false;
@@ -513,37 +930,73 @@ void StickerWidget::updateClickThrough()
     }
 }
 
-void StickerWidget::paintEvent(QPaintEvent *)
+void StickerWidget::paintEvent(QPaintEvent *event)
 {
     if (!m_initialized) {
         return;
     }
 
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    paintContent(painter, event->rect());
+}
 
-    if (m_config.contentType == StickerContentType::Image && !m_image.isNull()) {
-        // 绘制贴纸图片（支持矩阵变换）
-        m_renderer.paint(painter, m_config, size());
+void StickerWidget::paintContent(QPainter &painter, const QRect &exposedRect)
+{
+    if (!m_initialized) {
+        return;
+    }
+
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+
+    if (m_config.contentType == StickerContentType::Image && m_renderer.isTiled()) {
+        // 分块贴纸只绘制屏幕内且需要重绘的分块（换算到绘制设备坐标）
+        const QRect visible = tiledVisibleRect();
+        const QTransform toDevice = painter.worldTransform();
+        m_renderer.paint(painter, m_config, size(),
+                         toDevice.mapRect(visible), toDevice.mapRect(exposedRect));
+        m_tiledPaintedRect = visible;
+    } else if (m_live2d) {
+        // 降级快照或尚未创建渲染窗口时的海报帧
+        if (m_live2d->showsSnapshot()) {
+            m_renderer.paintSnapshot(painter, m_live2d->snapshot(), rect());
+        }
+    } else if (!m_image.isNull()) {
+        // 绘制贴纸图片/视频帧（支持矩阵变换）；带动作时贴缓存的变换栅格
+        if (hasMotion()) {
+            m_renderer.paintMotion(painter, m_config, size(), motionFrame());
+        } else {
+            m_renderer.paint(painter, m_config, size());
+        }
 
         // 默认贴纸的动画效果
-        if (m_config.imagePath.isEmpty()) {
-            int alpha = int(20 + 15 * qSin(m_animationAngle));
-            painter.fillRect(rect(), QColor(150, 200, 255, alpha));
+        if (m_config.contentType == StickerContentType::Image && m_config.imagePath.isEmpty()) {
+            painter.fillRect(rect(), QColor(150, 200, 255, pulseAlpha()));
         }
     }
 
-    if (m_editController.isEditMode()) {
+    // 边框是轴对齐矩形，不需要抗锯齿
+    if (m_editController.isEditMode() && borderRegion().intersects(exposedRect)) {
         QPen borderPen(QColor(0, 180, 0), 2);
+        painter.setRenderHint(QPainter::Antialiasing, false);
         painter.setPen(borderPen);
         painter.setBrush(Qt::NoBrush);
         QRect borderRect = rect().adjusted(1, 1, -2, -2);
         painter.drawRect(borderRect);
     }
+
+    const qint64 elapsedUs = paintTimer.nsecsElapsed() / 1000;
+    ++m_paintStats.paintCount;
+    m_paintStats.lastPaintUs = elapsedUs;
+    m_paintStats.totalPaintUs += elapsedUs;
 }
 
 void StickerWidget::mousePressEvent(QMouseEvent *event)
 {
+    if (m_live2d) {
+        m_live2d->noteInteraction();
+    }
+
     // 如果启用了点击穿透，不处理鼠标事件
     bool editMode = m_editController.isEditMode();
     if (m_config.clickThrough && !editMode) {
@@ -567,11 +1020,15 @@ void StickerWidget::mousePressEvent(QMouseEvent *event)
         // 右键不再用于拖动，只触发右键事件
     }
 
-    update();
+    requestBorderRepaint();
 }
 
 void StickerWidget::mouseMoveEvent(QMouseEvent *event)
 {
+    if (m_live2d) {
+        m_live2d->noteInteraction();
+    }
+
     // 如果启用了点击穿透，不处理鼠标事件
     bool editMode = m_editController.isEditMode();
     if (m_config.clickThrough && !editMode) {
@@ -619,6 +1076,10 @@ void StickerWidget::mouseDoubleClickEvent(QMouseEvent *event)
 
 void StickerWidget::wheelEvent(QWheelEvent *event)
 {
+    if (m_live2d) {
+        m_live2d->noteInteraction();
+    }
+
     // 如果启用了点击穿透，不处理鼠标事件
     bool editMode = m_editController.isEditMode();
     if (m_config.clickThrough && !editMode) {
@@ -640,6 +1101,10 @@ void StickerWidget::wheelEvent(QWheelEvent *event)
 
 void StickerWidget::enterEvent(QEvent *event)
 {
+    if (m_live2d) {
+        m_live2d->noteInteraction();
+    }
+
     // 如果启用了点击穿透，不处理鼠标事件
     if (m_config.clickThrough && !m_editController.isEditMode()) {
         event->ignore();
@@ -650,11 +1115,7 @@ void StickerWidget::enterEvent(QEvent *event)
     handleMouseTrigger(MouseTrigger::MouseEnter);
 
     // 鼠标进入时增加透明度
-    if (m_opacityAnimation->state() != QAbstractAnimation::Running) {
-        m_opacityAnimation->setStartValue(windowOpacity());
-        m_opacityAnimation->setEndValue(qMin(1.0, m_config.opacity + 0.2));
-        m_opacityAnimation->start();
-    }
+    animateOpacity(qMin(1.0, m_config.opacity + 0.2));
 }
 
 void StickerWidget::leaveEvent(QEvent *event)
@@ -669,11 +1130,7 @@ void StickerWidget::leaveEvent(QEvent *event)
     handleMouseTrigger(MouseTrigger::MouseLeave);
 
     // 恢复原始透明度
-    if (m_opacityAnimation->state() != QAbstractAnimation::Running) {
-        m_opacityAnimation->setStartValue(windowOpacity());
-        m_opacityAnimation->setEndValue(m_config.opacity);
-        m_opacityAnimation->start();
-    }
+    animateOpacity(m_config.opacity);
 }
 
 void StickerWidget::contextMenuEvent(QContextMenuEvent *event)
@@ -684,41 +1141,81 @@ void StickerWidget::contextMenuEvent(QContextMenuEvent *event)
         return;
     }
 
-    m_menuController.exec(event->globalPos());
+    ensureContextMenu();
+    m_menuController->exec(event->globalPos());
 }
 
 void StickerWidget::resizeEvent(QResizeEvent *event)
 {
     QWidget::resizeEvent(event);
-    if (m_live2dWidget) {
-        if (m_config.contentType == StickerContentType::Live2D) {
-            updateLive2DGeometry();
-        } else {
-            m_live2dWidget->setGeometry(rect());
-        }
+    if (m_live2d) {
+        m_live2d->updateGeometry();
     }
 }
 
-void StickerWidget::onLive2DBoundsChanged(const QRectF &bounds, bool valid)
+void StickerWidget::moveEvent(QMoveEvent *event)
 {
-    if (m_config.contentType != StickerContentType::Live2D) {
-        return;
+    QWidget::moveEvent(event);
+    // 批量提交后 Qt 侧几何已追上原生窗口
+    if (m_pendingApplied) {
+        m_hasPendingPos = false;
+        m_pendingApplied = false;
     }
-    m_hasLive2dBounds = valid;
-    m_live2dBoundsPx = valid ? bounds : QRectF();
-    m_live2dBoundsSourceSize = m_live2dWidget ? m_live2dWidget->size() : QSize();
-    updateTransformedWindowSize(ResizeAnchor::KeepTopLeft);
+    // 分块贴纸移入屏幕的新区域此前未解码绘制，需要补画
+    if (m_renderer.isTiled() && !m_tiledPaintedRect.contains(tiledVisibleRect())) {
+        requestRepaint();
+    }
+    m_presenter.geometryChanged();
 }
 
 void StickerWidget::handleMouseTrigger(MouseTrigger trigger)
 {
+    if (m_config.events.isEmpty()) {
+        return;
+    }
+    if (!m_eventController) {
+        m_eventController = new StickerEventController(this);
+        m_eventController->setEvents(&m_config.events);
+        connect(m_eventController, &StickerEventController::eventExecuted, this, [](const QString &message) {
+            qDebug() << "贴纸事件执行成功:" << message;
+        });
+        connect(m_eventController, &StickerEventController::eventFailed, this, [](const QString &error) {
+            qDebug() << "贴纸事件执行失败:" << error;
+        });
+    }
     int pollInterval = m_config.follow.enabled ? m_config.follow.pollIntervalMs : 33;
-    m_eventController.setAnchorContext(this, frameGeometry(), pollInterval);
-    m_eventController.handleTrigger(trigger);
+    m_eventController->setAnchorContext(this, frameGeometry(), pollInterval);
+    m_eventController->handleTrigger(trigger);
 }
 
-void StickerWidget::setupContextMenu()
+void StickerWidget::animateOpacity(double target)
 {
+    if (!m_opacityAnimation) {
+        m_opacityAnimation = new QPropertyAnimation(this, "windowOpacity", this);
+        m_opacityAnimation->setDuration(300);
+        m_opacityAnimation->setEasingCurve(QEasingCurve::OutCubic);
+        // 合成模式下窗口不透明度只影响叠加层绘制，需要主动重绘
+        connect(m_opacityAnimation, &QPropertyAnimation::valueChanged, this, [this]() {
+            if (m_presenter.surface()) {
+                m_presenter.surface()->setOpacity(windowOpacity());
+            } else if (isComposited()) {
+                requestRepaint();
+            }
+        });
+    }
+    if (m_opacityAnimation->state() != QAbstractAnimation::Running) {
+        m_opacityAnimation->setStartValue(windowOpacity());
+        m_opacityAnimation->setEndValue(target);
+        m_opacityAnimation->start();
+    }
+}
+
+void StickerWidget::ensureContextMenu()
+{
+    if (m_menuController) {
+        return;
+    }
+    m_menuController = new StickerContextMenuController(this);
     StickerContextMenuController::Callbacks callbacks;
     callbacks.editSticker = [this]() { onEditSticker(); };
     callbacks.toggleEditMode = [this]() { onToggleEditMode(); };
@@ -726,35 +1223,76 @@ void StickerWidget::setupContextMenu()
     callbacks.toggleDrag = [this]() { onToggleDrag(); };
     callbacks.toggleClickThrough = [this]() { onToggleClickThrough(); };
     callbacks.deleteSticker = [this]() { onDeleteSticker(); };
-    m_menuController.setCallbacks(callbacks);
+    m_menuController->setCallbacks(callbacks);
     updateContextMenuState();
 }
 
 void StickerWidget::updateContextMenuState()
 {
-    m_menuController.updateState(m_config.isDesktopMode,
+    if (!m_menuController) {
+        return;
+    }
+    m_menuController->updateState(m_config.isDesktopMode,
                                 m_config.allowDrag,
                                 m_config.clickThrough,
                                 m_editController.isEditMode());
 }
 
-void StickerWidget::onAnimationTimer()
+// 默认图片贴纸的脉冲，或配置了关键帧动作的图片/视频贴纸
+bool StickerWidget::isAnimating() const
 {
-    if (!m_initialized) {
-        return;
+    const bool defaultPulse = m_config.contentType == StickerContentType::Image
+        && m_config.imagePath.isEmpty()
+        && !m_renderer.isTiled();
+    return defaultPulse || hasMotion();
+}
+
+bool StickerWidget::hasMotion() const
+{
+    return m_config.transform.motion.isActive()
+        && m_config.contentType != StickerContentType::Live2D
+        && !m_renderer.isTiled();
+}
+
+StickerMotionFrame StickerWidget::motionFrame() const
+{
+    const StickerMotion &motion = m_config.transform.motion;
+    return motion.sample(double(m_motionElapsedMs) / qMax(1, motion.periodMs));
+}
+
+void StickerWidget::updateAnimationState()
+{
+    StickerFrameClock *clock = StickerFrameClock::instance();
+    clock->setInterval(this, hasMotion() ? kMotionFrameMs : kPulseFrameMs);
+    clock->setActive(this, m_initialized && isShownOnScreen() && isAnimating());
+}
+
+void StickerWidget::advanceAnimation(qint64 elapsedMs)
+{
+    // 动作帧只推进相位并重绘，窗口大小与遮罩已按整个周期预先确定
+    if (hasMotion()) {
+        m_motionElapsedMs = (m_motionElapsedMs + elapsedMs) % qMax(1, m_config.transform.motion.periodMs);
+        requestRepaint();
     }
 
-    m_animationAngle += 0.05;
+    // 按实际间隔推进，保持原先每 50ms 0.05 弧度的速度
+    m_animationAngle += 0.001 * elapsedMs;
     if (m_animationAngle >= 2 * M_PI) {
-        m_animationAngle = 0;
+        m_animationAngle = std::fmod(m_animationAngle, 2 * M_PI);
     }
-
-    // 只有默认图片贴纸才有动画
-    if (m_config.contentType == StickerContentType::Image && m_config.imagePath.isEmpty()) {
-        update();
+    // 脉冲只改变叠加色的整数透明度，值未变时不重绘
+    const int alpha = pulseAlpha();
+    if (alpha != m_pulseAlpha) {
+        m_pulseAlpha = alpha;
+        requestRepaint();
     }
 }
 
+int StickerWidget::pulseAlpha() const
+{
+    return int(20 + 15 * qSin(m_animationAngle));
+}
+
 void StickerWidget::onEditSticker()
 {
     emit editRequested(m_config.id);
@@ -783,6 +1321,7 @@ void StickerWidget::onToggleMode()
     m_config.isDesktopMode = !m_config.isDesktopMode;
     m_editController.applyWindowFlags(m_config.isDesktopMode, m_config.follow.enabled, m_initialized);
     updateContextMenuState();
+    updateCompositing();
     emit configChanged(m_config);
 
     QString mode = m_config.isDesktopMode ? "桌面模式" : "置顶模式";
@@ -808,6 +1347,7 @@ void StickerWidget::onToggleClickThrough()
     m_config.clickThrough = !m_config.clickThrough;
     updateClickThrough();
     updateContextMenuState();
+    updateCompositing();
     emit configChanged(m_config);
 
     QString status = m_config.clickThrough ? "点击穿透已启用" : "点击穿透已禁用";
@@ -821,9 +1361,18 @@ void StickerWidget::setEditMode(bool enabled)
     }
 
     m_interactionController.reset();
+    // 编辑期间提升为独立窗口，退出后再交回叠加层
+    m_promotedForEdit = enabled;
+    if (enabled) {
+        updateCompositing();
+    }
     m_editController.setEditMode(enabled, m_config.isDesktopMode, m_config.follow.enabled, m_initialized);
     updateContextMenuState();
-    update();
+    if (!enabled) {
+        updateCompositing();
+        emit stackingChanged();
+    }
+    requestRepaint();
 }
 
 void StickerWidget::onToggleEditMode()
@@ -834,10 +1383,11 @@ void StickerWidget::onToggleEditMode()
 StickerConfig StickerWidget::getConfig() const
 {
     StickerConfig config = m_config;
-    config.position = pos();
-    config.size = size();
+    const QRect geometry = windowGeometry();
+    config.position = geometry.topLeft();
+    config.size = geometry.size();
     if (!m_runtimeHidden) {
-        config.visible = isVisible();
+        config.visible = isShownOnScreen();
     }
     return config;
 }
@@ -851,7 +1401,6 @@ void StickerWidget::updateConfig(const StickerConfig &config)
     const StickerConfig oldConfig = m_config;
     QSize oldBaseSize = m_config.size;
     m_config = config;
-    m_eventController.setEvents(&m_config.events);
     bool contentTypeChanged = (oldConfig.contentType != m_config.contentType);
     bool live2dChanged = !live2dEqual(oldConfig.live2d, m_config.live2d);
     bool configAdjusted = false;
@@ -865,34 +1414,52 @@ void StickerWidget::updateConfig(const StickerConfig &config)
             configAdjusted = true;
         }
         if (m_config.live2d.baseSize.isEmpty()) {
-            m_config.live2d.baseSize = m_config.size.isEmpty() ? QSize(200, 200) : m_config.size;
+            m_config.live2d.baseSize = StickerLive2DManifest::defaultBaseSize(
+                m_config.live2d.modelJsonPath, m_config.size.isEmpty() ? QSize(200, 200) : m_config.size);
             configAdjusted = true;
         }
     }
 
     // 更新位置和大小
     if (config.position != oldConfig.position) {
-        move(config.position);
+        moveWindow(config.position);
     }
     if (config.size != oldBaseSize) {
-        setFixedSize(m_config.size);
+        resizeWindow(m_config.size);
     }
 
     if (m_config.contentType == StickerContentType::Live2D) {
-        ensureLive2DWidget();
-        if (contentTypeChanged || live2dChanged) {
-            applyLive2DConfig();
+        releaseVideoSource();
+        // 已被内存预算回收时等到重新显示再创建
+        if (!m_live2d) {
+            ensureLive2DHost();
+            if (!m_resourcesEvicted) {
+                m_live2d->start();
+            }
+        } else {
+            m_live2d->reload(live2dChanged);
         }
-    } else {
-        if (oldConfig.contentType == StickerContentType::Live2D) {
-            releaseLive2DWidget();
+    } else if (m_config.contentType == StickerContentType::Video) {
+        releaseLive2DHost();
+        m_effects.setEffects(StickerEffectConfig());
+        if (contentTypeChanged || oldConfig.video.path != m_config.video.path) {
+            createDefaultSticker();
         }
+        ensureVideoSource();
+    } else {
+        releaseLive2DHost();
+        releaseVideoSource();
+        m_effects.setEffects(m_config.effects);
         // 更新图像
+        const bool imageChanged = contentTypeChanged
+            || oldConfig.imagePath != config.imagePath
+            || oldConfig.tiledImage != config.tiledImage
+            || !m_renderer.isReady();
         if (config.imagePath.isEmpty()) {
-            if (oldConfig.imagePath != config.imagePath || m_image.isNull()) {
+            if (imageChanged) {
                 createDefaultSticker();
             }
-        } else if (oldConfig.imagePath != config.imagePath || m_image.isNull()) {
+        } else if (imageChanged) {
             if (QFileInfo::exists(config.imagePath)) {
                 loadStickerImage(config.imagePath);
             } else {
@@ -901,8 +1468,27 @@ void StickerWidget::updateConfig(const StickerConfig &config)
         }
     }
 
+    // 编辑器数值框连续预览变换/尺寸时先走低保真，停止输入后再精修
+    const bool geometryOnly = !contentTypeChanged
+        && oldConfig.imagePath == m_config.imagePath
+        && oldConfig.effects == m_config.effects
+        && (!transformEqual(oldConfig.transform, m_config.transform) || oldConfig.size != m_config.size);
+    if (geometryOnly && m_config.contentType != StickerContentType::Live2D) {
+        beginLowFidelity();
+    }
     updateTransformedWindowSize(ResizeAnchor::KeepTopLeft);
     applyMask();
+    if (oldConfig.effects != m_config.effects && m_config.contentType == StickerContentType::Image) {
+        requestRepaint();
+    }
+    // 合成贴纸的叠放次序体现在叠加层的绘制顺序上
+    if (oldConfig.zOrder != m_config.zOrder && isComposited()) {
+        requestRepaint();
+    }
+    if (oldConfig.transform.motion != m_config.transform.motion) {
+        m_motionElapsedMs = 0;
+        updateAnimationState();
+    }
 
     // 重新应用窗口设置
     m_editController.applyWindowFlags(m_config.isDesktopMode, m_config.follow.enabled, m_initialized);
@@ -920,6 +1506,7 @@ void StickerWidget::updateConfig(const StickerConfig &config)
     if (configAdjusted && m_initialized) {
         emit configChanged(m_config);
     }
+    updateCompositing();
 
     qDebug() << "更新贴纸配置:" << config.id;
 }
@@ -928,6 +1515,11 @@ void StickerWidget::setOpacity(double opacity)
 {
     m_config.opacity = qBound(0.1, opacity, 1.0);
     setWindowOpacity(m_config.opacity);
+    if (m_presenter.surface()) {
+        m_presenter.surface()->setOpacity(m_config.opacity);
+    } else if (isComposited()) {
+        requestRepaint();
+    }
 }
 
 void StickerWidget::setDesktopMode(bool isDesktop)
@@ -936,6 +1528,7 @@ void StickerWidget::setDesktopMode(bool isDesktop)
         m_config.isDesktopMode = isDesktop;
         m_editController.applyWindowFlags(m_config.isDesktopMode, m_config.follow.enabled, m_initialized);
         updateContextMenuState();
+        updateCompositing();
         emit configChanged(m_config);
     }
 }
@@ -958,6 +1551,7 @@ void StickerWidget::setClickThrough(bool clickThrough)
         m_config.clickThrough = clickThrough;
         updateClickThrough();
         updateContextMenuState();
+        updateCompositing();
         emit configChanged(m_config);
     }
 }
@@ -967,9 +1561,15 @@ void StickerWidget::setVisible(bool visible)
     bool visibilityChanged = (m_config.visible != visible);
     m_config.visible = visible;
     bool targetVisible = m_runtimeHidden ? false : visible;
-    if (QWidget::isVisible() != targetVisible) {
+    if (isComposited()) {
+        // 合成贴纸不显示原生窗口，只刷新叠加层
+        StickerCompositor::instance()->markDirty(this, geometry());
+    } else if (m_presenter.surface()) {
+        m_presenter.surface()->setVisible(targetVisible);
+    } else if (QWidget::isVisible() != targetVisible) {
         QWidget::setVisible(targetVisible);
     }
+    updateVisibilityState();
     if (visibilityChanged) {
         emit configChanged(m_config);
     }
@@ -981,9 +1581,89 @@ void StickerWidget::setRuntimeHidden(bool hidden)
         return;
     }
     m_runtimeHidden = hidden;
-    if (m_runtimeHidden) {
+    if (isComposited()) {
+        StickerCompositor::instance()->markDirty(this, geometry());
+    } else if (m_presenter.surface()) {
+        m_presenter.surface()->setVisible(!m_runtimeHidden && m_config.visible);
+    } else if (m_runtimeHidden) {
         QWidget::setVisible(false);
     } else {
         QWidget::setVisible(m_config.visible);
     }
+    updateVisibilityState();
+}
+
+void StickerWidget::setFollowTargetMinimized(bool minimized)
+{
+    if (m_followTargetMinimized == minimized) {
+        return;
+    }
+    m_followTargetMinimized = minimized;
+    updateVideoPlayback();
+    if (m_live2d) {
+        m_live2d->updateActivity();
+    }
+}
+
+qint64 StickerWidget::residentBytes() const
+{
+    qint64 bytes = m_image.residentBytes() + m_effects.residentBytes() + m_tiledImage.residentBytes();
+    bytes += qint64(m_hitRegion.rectCount()) * qint64(sizeof(QRect));
+    bytes += windowBackingBytes();
+    if (m_live2d) {
+        bytes += m_live2d->residentBytes();
+    }
+    return bytes;
+}
+
+void StickerWidget::updateVisibilityState()
+{
+    if (isShownOnScreen()) {
+        if (m_resourcesEvicted) {
+            restoreResources();
+        }
+        StickerMemoryBudget::instance().markVisible(this);
+    } else {
+        StickerMemoryBudget::instance().markHidden(this);
+    }
+    if (isComposited()) {
+        StickerCompositor::instance()->hitRegionChanged(this);
+    }
+    updateVideoPlayback();
+    if (m_live2d) {
+        m_live2d->updateActivity();
+    }
+    updateAnimationState();
+}
+
+void StickerWidget::evictResources()
+{
+    if (m_resourcesEvicted || isShownOnScreen()) {
+        return;
+    }
+    m_resourcesEvicted = true;
+    m_image.release();
+    m_effects.releaseResults();
+    m_renderer.releaseMotionRaster();
+    m_tiledImage.releaseTiles();
+    m_tiledPaintedRect = QRect();
+    clearMask();
+    m_hitRegion = QRegion();
+    if (m_live2d) {
+        m_live2d->evict();
+    }
+    qDebug() << "贴纸" << m_config.id << "隐藏期间释放渲染资源";
+}
+
+void StickerWidget::restoreResources()
+{
+    m_resourcesEvicted = false;
+    if (m_live2d) {
+        m_live2d->restore();
+    } else {
+        // 栅格在首次绘制时从源图缓存惰性恢复
+        applyMask();
+    }
+    requestRepaint();
+    qDebug() << "贴纸" << m_config.id << "重新显示，恢复渲染资源";
 }
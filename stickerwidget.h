@@ -3,18 +3,28 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QPoint>
 #include <QPropertyAnimation>
 #include <QRectF>
-#include "StickerData.h"
-#include "stickereventcontroller.h"
-#include "stickercontextmenucontroller.h"
+#include <QRegion>
+#include "stickerdata.h"
 #include "stickereditcontroller.h"
+#include "stickereffectstage.h"
 #include "stickerimage.h"
 #include "stickerinteractioncontroller.h"
+#include "stickerpresenter.h"
 #include "stickerrenderer.h"
+#include "stickertiledimage.h"
+#include "windowrecognitionservice.h"
 
-class Live2DWidget;
+class StickerContextMenuController;
+class StickerEventController;
+class StickerGeometryBatch;
+class StickerLive2DHost;
+class StickerVideoSource;
+class QMoveEvent;
+class QPainter;
 class QResizeEvent;
 
 class StickerWidget : public QWidget
@@ -38,6 +48,55 @@ public:
     void setAllowDrag(bool allowDrag);      // 新增
     void setClickThrough(bool clickThrough); // 新增
     void setRuntimeHidden(bool hidden);
+    // 跟随目标最小化但贴纸仍保持显示时，Live2D 不需要继续渲染
+    void setFollowTargetMinimized(bool minimized);
+
+    // 当前常驻的栅格/遮罩/Live2D 估算字节数
+    qint64 residentBytes() const;
+
+    // 显示方式：完整 QWidget 窗口、轻量 QRasterWindow，或由 StickerCompositor 合成到叠加层；
+    // 后两种情况下贴纸自身的 QWidget 不创建原生窗口
+    using Presentation = StickerPresenter::Presentation;
+
+    bool isCompositeEligible() const;
+    bool isRasterSurfaceEligible() const;
+    bool isComposited() const;
+    Presentation presentation() const;
+    void setPresentation(Presentation presentation);
+    bool isShownOnScreen() const;
+    QRegion hitRegion() const;
+    void paintContent(QPainter &painter, const QRect &exposedRect);
+    bool dispatchForwardedEvent(QEvent *event);
+
+    // 当前承载贴纸的原生窗口句柄（窗口吸附用）
+    WindowHandle nativeHandle();
+
+    // 层叠：同一层带（桌面置底/普通置顶）内按 zOrder 排列；
+    // 编辑、跟随和合成中的贴纸不参与（分别由置顶、吸附、叠加层绘制次序决定）
+    int stackOrder() const;
+    bool isStackedOnDesktop() const;
+    bool isRestackable() const;
+    void raiseWindow();
+    void lowerWindow();
+
+    // 批量打开期间原生窗口的移动只记入批次，提交后再同步 Qt 侧几何；
+    // nativeApplied 为 false 时（记录后端、非 Windows）由 Qt 下发移动
+    void setGeometryBatch(StickerGeometryBatch *batch);
+    void commitBatchedGeometry(bool nativeApplied);
+    // 含尚未提交的批量移动
+    QRect windowGeometry() const;
+
+    // 绘制统计：实际绘制次数、因离屏/被遮挡跳过的重绘请求、绘制耗时
+    struct PaintStats {
+        quint64 paintCount = 0;
+        quint64 skippedCount = 0;
+        qint64 totalPaintUs = 0;
+        qint64 lastPaintUs = 0;
+        quint64 boundsUpdates = 0;     // Live2D 包围盒信号次数
+        quint64 boundsFits = 0;        // 实际按包围盒调整窗口的次数
+        quint64 resizesAvoided = 0;    // 落在包络内或被限频合并而省掉的调整
+    };
+    PaintStats paintStats() const;
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -50,21 +109,23 @@ protected:
     void leaveEvent(QEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void moveEvent(QMoveEvent *event) override;
 
 signals:
     void configChanged(const StickerConfig &config);
     void deleteRequested(const QString &stickerId);
     void editRequested(const QString &stickerId);
+    // 承载窗口或所在层带变化（切换显示方式、退出编辑），需要重新排列层叠
+    void stackingChanged();
 
 private slots:
-    void onAnimationTimer();
     void onEditSticker();
     void onDeleteSticker();
     void onToggleMode();
     void onToggleDrag();        // 新增
     void onToggleClickThrough(); // 新增
     void onToggleEditMode();
-    void onLive2DBoundsChanged(const QRectF &bounds, bool valid);
+    void onVideoFrameReady();
 
 private:
     enum class ResizeAnchor {
@@ -75,38 +136,74 @@ private:
     void initializeWidget();
     void loadStickerImage(const QString &imagePath);
     void createDefaultSticker();
-    void ensureLive2DWidget();
-    void releaseLive2DWidget();
-    void rebuildLive2DWidget();
-    void applyLive2DConfig();
-    void updateLive2DGeometry();
+    void ensureLive2DHost();
+    void releaseLive2DHost();
+    void ensureVideoSource();
+    void releaseVideoSource();
+    void updateVideoPlayback();
     void applyMask();
+    void moveWindow(const QPoint &pos);
+    void resizeWindow(const QSize &size);
+    bool deferMove(const QPoint &pos);
+    WindowHandle batchHandle() const;
+    void requestRepaint(const QRect &rect = QRect());
+    void requestRepaint(const QRegion &region);
+    void requestBorderRepaint();
+    QRegion borderRegion() const;
+    bool isPaintSuppressed();
+    void beginLowFidelity();
+    void onInteractionSettled();
+    int pulseAlpha() const;
+    void updateCompositing();
+    qint64 windowBackingBytes() const;
+    QRect tiledVisibleRect() const;
     void updateTransformedWindowSize(ResizeAnchor anchor = ResizeAnchor::KeepCenter);
-    void setupContextMenu();
+    void ensureContextMenu();
     void updateContextMenuState();
     void handleMouseTrigger(MouseTrigger trigger);
+    void animateOpacity(double target);
     void updateClickThrough(); // 新增
     void setEditMode(bool enabled);
+    void updateVisibilityState();
+    bool isAnimating() const;
+    bool hasMotion() const;
+    StickerMotionFrame motionFrame() const;
+    void updateAnimationState();
+    void advanceAnimation(qint64 elapsedMs);
+    void evictResources();
+    void restoreResources();
 
     StickerConfig m_config;
     StickerImage m_image;
+    StickerEffectStage m_effects;
+    StickerTiledImage m_tiledImage;
     StickerRenderer m_renderer;
     StickerInteractionController m_interactionController;
     StickerEditController m_editController;
-    StickerContextMenuController m_menuController;
-    StickerEventController m_eventController;
-    Live2DWidget *m_live2dWidget;
-    QSize m_live2dRenderSize;
-    QSize m_live2dBoundsSourceSize;
-    QRectF m_live2dBoundsPx;
-    QPoint m_live2dBoundsOffset;
-    bool m_hasLive2dBounds;
-    bool m_autoFitLive2d;
+    // 菜单、事件执行、悬停动画与手势定时器在首次用到时才创建，点击穿透等从不交互的贴纸不持有
+    StickerContextMenuController *m_menuController;
+    StickerEventController *m_eventController;
+    StickerLive2DHost *m_live2d;            // 只有 Live2D 贴纸持有
+    StickerVideoSource *m_videoSource;
+    QRect m_tiledPaintedRect;
+    bool m_followTargetMinimized;
     bool m_initialized;
     bool m_runtimeHidden;
+    bool m_resourcesEvicted;
+    StickerPresenter m_presenter;
+    StickerGeometryBatch *m_geometryBatch;
+    bool m_hasPendingPos;
+    bool m_pendingApplied;          // 原生窗口已移到 m_pendingPos，等 Qt 的移动事件追上
+    QPoint m_pendingPos;
+    bool m_promotedForEdit;
+    QRegion m_hitRegion;
     double m_animationAngle;
+    int m_pulseAlpha;
+    qint64 m_motionElapsedMs;
+    PaintStats m_paintStats;
+    bool m_lowFidelity;
+    QTimer *m_settleTimer;
 
-    QTimer *m_animationTimer;
     QPropertyAnimation *m_opacityAnimation;
 };
 
@@ -1,4 +1,4 @@
-#include "TrayIcon.h"
+#include "trayicon.h"
 #include <QApplication>
 #include <QStyle>
 
@@ -1,74 +1,116 @@
 #include "windowattachmentservice.h"
 #include <QWidget>
+#include "stickergeometrybatch.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
 WindowAttachmentService::WindowAttachmentService()
+    : m_batch(nullptr)
 {
 }
 
+void WindowAttachmentService::setGeometryBatch(StickerGeometryBatch *batch)
+{
+    m_batch = batch;
+}
+
 void WindowAttachmentService::attach(QWidget *widget, WindowHandle target) const
+{
+    if (!widget) {
+        return;
+    }
+    attach(WindowHandle(widget->winId()), target);
+}
+
+void WindowAttachmentService::detach(QWidget *widget) const
+{
+    if (!widget) {
+        return;
+    }
+    detach(WindowHandle(widget->winId()));
+}
+
+void WindowAttachmentService::ensureZOrder(QWidget *widget, WindowHandle target) const
+{
+    if (!widget) {
+        return;
+    }
+    ensureZOrder(WindowHandle(widget->winId()), target);
+}
+
+void WindowAttachmentService::attach(WindowHandle self, WindowHandle target) const
 {
 #ifdef Q_OS_WIN
-    if (!widget || target == 0) {
+    if (self == 0 || target == 0) {
         return;
     }
 
-    HWND self = reinterpret_cast<HWND>(widget->winId());
+    HWND hwndSelf = reinterpret_cast<HWND>(self);
     HWND hwndTarget = reinterpret_cast<HWND>(target);
-    if (!IsWindow(self) || !IsWindow(hwndTarget)) {
+    if (!IsWindow(hwndSelf) || !IsWindow(hwndTarget)) {
         return;
     }
 
-    SetWindowLongPtrW(self, GWLP_HWNDPARENT, reinterpret_cast<LONG_PTR>(hwndTarget));
-    ensureZOrder(widget, target);
+    SetWindowLongPtrW(hwndSelf, GWLP_HWNDPARENT, reinterpret_cast<LONG_PTR>(hwndTarget));
+    ensureZOrder(self, target);
 #else
-    Q_UNUSED(widget)
+    Q_UNUSED(self)
     Q_UNUSED(target)
 #endif
 }
 
-void WindowAttachmentService::detach(QWidget *widget) const
+void WindowAttachmentService::detach(WindowHandle self) const
 {
 #ifdef Q_OS_WIN
-    if (!widget) {
-        return;
-    }
-    HWND self = reinterpret_cast<HWND>(widget->winId());
-    if (!IsWindow(self)) {
+    HWND hwndSelf = reinterpret_cast<HWND>(self);
+    if (!IsWindow(hwndSelf)) {
         return;
     }
-    SetWindowLongPtrW(self, GWLP_HWNDPARENT, 0);
+    SetWindowLongPtrW(hwndSelf, GWLP_HWNDPARENT, 0);
 #else
-    Q_UNUSED(widget)
+    Q_UNUSED(self)
 #endif
 }
 
-void WindowAttachmentService::ensureZOrder(QWidget *widget, WindowHandle target) const
+void WindowAttachmentService::ensureZOrder(WindowHandle self, WindowHandle target) const
 {
 #ifdef Q_OS_WIN
-    if (!widget || target == 0) {
+    if (self == 0 || target == 0) {
         return;
     }
 
-    HWND self = reinterpret_cast<HWND>(widget->winId());
+    HWND hwndSelf = reinterpret_cast<HWND>(self);
     HWND hwndTarget = reinterpret_cast<HWND>(target);
-    if (!IsWindow(self) || !IsWindow(hwndTarget)) {
+    if (!IsWindow(hwndSelf) || !IsWindow(hwndTarget)) {
         return;
     }
 
     bool targetTop = isTopMost(hwndTarget);
-    SetWindowPos(self, targetTop ? HWND_TOPMOST : HWND_NOTOPMOST,
+    if (m_batch && m_batch->isOpen()) {
+        // 置顶层带不同时先单独切换，同一层带内紧贴目标窗口的位置随批次提交
+        if (isTopMost(hwndSelf) != targetTop) {
+            SetWindowPos(hwndSelf, targetTop ? HWND_TOPMOST : HWND_NOTOPMOST,
+                         0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+        }
+        HWND prev = reinterpret_cast<HWND>(previousInSameGroup(hwndTarget));
+        if (prev == hwndSelf) {
+            return;
+        }
+        HWND insertAfter = prev ? prev : (targetTop ? HWND_TOPMOST : HWND_TOP);
+        m_batch->setZOrder(self, WindowHandle(insertAfter));
+        return;
+    }
+    SetWindowPos(hwndSelf, targetTop ? HWND_TOPMOST : HWND_NOTOPMOST,
                  0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
     HWND prev = reinterpret_cast<HWND>(previousInSameGroup(hwndTarget));
-    if (prev && prev != self) {
-        SetWindowPos(self, prev, 0, 0, 0, 0,
+    if (prev && prev != hwndSelf) {
+        SetWindowPos(hwndSelf, prev, 0, 0, 0, 0,
                      SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
     }
 #else
-    Q_UNUSED(widget)
+    Q_UNUSED(self)
     Q_UNUSED(target)
 #endif
 }
@@ -4,6 +4,7 @@
 #include "windowrecognitionservice.h"
 
 class QWidget;
+class StickerGeometryBatch;
 
 class WindowAttachmentService
 {
@@ -14,7 +15,17 @@ public:
     void detach(QWidget *widget) const;
     void ensureZOrder(QWidget *widget, WindowHandle target) const;
 
+    // 直接按原生句柄操作，供不以 QWidget 承载的贴纸窗口使用
+    void attach(WindowHandle self, WindowHandle target) const;
+    void detach(WindowHandle self) const;
+    void ensureZOrder(WindowHandle self, WindowHandle target) const;
+
+    // 批次打开时层级调整记入批次，与位置变化一起提交
+    void setGeometryBatch(StickerGeometryBatch *batch);
+
 private:
+    StickerGeometryBatch *m_batch;
+
 #ifdef Q_OS_WIN
     static bool isTopMost(void *handle);
     static bool isTargetForeground(void *handle);
@@ -0,0 +1,286 @@
+#include "windoweventsource.h"
+#include <QDebug>
+#include <QHash>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+#ifdef Q_OS_WIN
+class Win32EventSource;
+
+QHash<HWINEVENTHOOK, Win32EventSource*> &hookOwners()
+{
+    static QHash<HWINEVENTHOOK, Win32EventSource*> owners;
+    return owners;
+}
+
+// SetWinEventHook 进程外挂接：回调经由本线程消息循环投递，不注入目标进程。
+// 显隐/销毁/最小化/前台挂全局，移动只挂在被跟随窗口所属的进程上
+class Win32EventSource : public WindowEventSource
+{
+public:
+    explicit Win32EventSource(QObject *parent)
+        : WindowEventSource(parent)
+    {
+    }
+
+    ~Win32EventSource() override
+    {
+        unhookAll();
+    }
+
+protected:
+    void updateWatch() override
+    {
+        if (hasFailed()) {
+            return;
+        }
+        if (!isWatching()) {
+            unhookAll();
+            return;
+        }
+        if (m_globalHooks.isEmpty()) {
+            const DWORD ranges[][2] = {
+                { EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND },
+                { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND },
+                { EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE }
+            };
+            for (const auto &range : ranges) {
+                HWINEVENTHOOK handle = hook(range[0], range[1], 0);
+                if (!handle) {
+                    fail();
+                    return;
+                }
+                m_globalHooks << handle;
+            }
+        }
+
+        QSet<DWORD> processes;
+        for (WindowHandle handle : watchedWindows()) {
+            DWORD pid = 0;
+            GetWindowThreadProcessId(reinterpret_cast<HWND>(handle), &pid);
+            if (pid != 0) {
+                processes.insert(pid);
+            }
+        }
+        for (auto it = m_locationHooks.begin(); it != m_locationHooks.end(); ) {
+            if (processes.contains(it.key())) {
+                ++it;
+                continue;
+            }
+            unhook(it.value());
+            it = m_locationHooks.erase(it);
+        }
+        for (DWORD pid : processes) {
+            if (m_locationHooks.contains(pid)) {
+                continue;
+            }
+            HWINEVENTHOOK handle = hook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, pid);
+            if (!handle) {
+                fail();
+                return;
+            }
+            m_locationHooks.insert(pid, handle);
+        }
+    }
+
+private:
+    HWINEVENTHOOK hook(DWORD eventMin, DWORD eventMax, DWORD pid)
+    {
+        HWINEVENTHOOK handle = SetWinEventHook(eventMin, eventMax, nullptr, &Win32EventSource::onWinEvent,
+                                               pid, 0, WINEVENT_OUTOFCONTEXT);
+        if (handle) {
+            hookOwners().insert(handle, this);
+        } else {
+            qDebug() << "窗口事件挂接失败" << eventMin << GetLastError();
+        }
+        return handle;
+    }
+
+    // 只挂上一部分会漏掉事件，整体放弃，由调用方改为轮询
+    void fail()
+    {
+        unhookAll();
+        markFailed();
+    }
+
+    void unhook(HWINEVENTHOOK handle)
+    {
+        if (handle) {
+            hookOwners().remove(handle);
+            UnhookWinEvent(handle);
+        }
+    }
+
+    void unhookAll()
+    {
+        for (HWINEVENTHOOK handle : m_globalHooks) {
+            unhook(handle);
+        }
+        m_globalHooks.clear();
+        for (HWINEVENTHOOK handle : m_locationHooks) {
+            unhook(handle);
+        }
+        m_locationHooks.clear();
+    }
+
+    static void CALLBACK onWinEvent(HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+                                    LONG idObject, LONG idChild, DWORD, DWORD)
+    {
+        // 只关心顶层窗口本身，光标、插入符和子控件的事件直接丢弃
+        if (!hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+            return;
+        }
+        Win32EventSource *source = hookOwners().value(hook);
+        if (!source) {
+            return;
+        }
+        // 销毁时句柄已失效无法判断层级，交给 dispatch 只报告关注的窗口（都是顶层窗口）
+        if (event != EVENT_OBJECT_DESTROY && GetAncestor(hwnd, GA_ROOT) != hwnd) {
+            return;
+        }
+
+        Event type;
+        switch (event) {
+        case EVENT_OBJECT_LOCATIONCHANGE:
+            type = Event::Moved;
+            break;
+        case EVENT_OBJECT_SHOW:
+            type = Event::Shown;
+            break;
+        case EVENT_OBJECT_HIDE:
+            type = Event::Hidden;
+            break;
+        case EVENT_OBJECT_DESTROY:
+            type = Event::Destroyed;
+            break;
+        case EVENT_SYSTEM_MINIMIZESTART:
+            type = Event::Minimized;
+            break;
+        case EVENT_SYSTEM_MINIMIZEEND:
+            type = Event::Restored;
+            break;
+        case EVENT_SYSTEM_FOREGROUND:
+            type = Event::Foreground;
+            break;
+        default:
+            return;
+        }
+        source->dispatch(reinterpret_cast<WindowHandle>(hwnd), type);
+    }
+
+    QList<HWINEVENTHOOK> m_globalHooks;
+    QHash<DWORD, HWINEVENTHOOK> m_locationHooks;
+};
+#endif
+}
+
+WindowEventSource::WindowEventSource(QObject *parent)
+    : QObject(parent)
+    , m_anyWindow(false)
+    , m_failed(false)
+{
+}
+
+WindowEventSource *WindowEventSource::createNative(QObject *parent)
+{
+#ifdef Q_OS_WIN
+    return new Win32EventSource(parent);
+#else
+    // 窗口识别目前只有 Win32 实现，其他平台没有可跟随的窗口句柄
+    Q_UNUSED(parent)
+    return nullptr;
+#endif
+}
+
+void WindowEventSource::setWatchedWindows(const QSet<WindowHandle> &handles, bool anyWindow)
+{
+    if (handles == m_watched && anyWindow == m_anyWindow) {
+        return;
+    }
+    m_watched = handles;
+    m_anyWindow = anyWindow;
+    updateWatch();
+}
+
+QSet<WindowHandle> WindowEventSource::watchedWindows() const
+{
+    return m_watched;
+}
+
+bool WindowEventSource::watchesAnyWindow() const
+{
+    return m_anyWindow;
+}
+
+bool WindowEventSource::isWatching() const
+{
+    return m_anyWindow || !m_watched.isEmpty();
+}
+
+bool WindowEventSource::hasFailed() const
+{
+    return m_failed;
+}
+
+void WindowEventSource::markFailed()
+{
+    m_failed = true;
+}
+
+bool WindowEventSource::dispatch(WindowHandle handle, Event event)
+{
+    if (!isWatching()) {
+        return false;
+    }
+    bool wanted = m_watched.contains(handle);
+    // 可见的顶层窗口销毁前会先隐藏，anyWindow 的关注方从隐藏事件得知消失；
+    // 销毁事件本身不分顶层与子窗口，只报告关注的窗口
+    if (event == Event::Foreground) {
+        wanted = true;
+    } else if (event != Event::Moved && event != Event::Destroyed) {
+        wanted = wanted || m_anyWindow;
+    }
+    if (wanted) {
+        emit windowChanged(handle, event);
+    }
+    return wanted;
+}
+
+WindowEventSource::ScriptedSource::ScriptedSource(QObject *parent)
+    : WindowEventSource(parent)
+    , m_watchUpdates(0)
+{
+}
+
+bool WindowEventSource::ScriptedSource::post(WindowHandle handle, Event event)
+{
+    if (!dispatch(handle, event)) {
+        return false;
+    }
+    m_delivered.append(qMakePair(handle, event));
+    return true;
+}
+
+QList<QPair<WindowHandle, WindowEventSource::Event>> WindowEventSource::ScriptedSource::delivered() const
+{
+    return m_delivered;
+}
+
+int WindowEventSource::ScriptedSource::watchUpdates() const
+{
+    return m_watchUpdates;
+}
+
+void WindowEventSource::ScriptedSource::reset()
+{
+    m_delivered.clear();
+    m_watchUpdates = 0;
+}
+
+void WindowEventSource::ScriptedSource::updateWatch()
+{
+    ++m_watchUpdates;
+}
@@ -0,0 +1,79 @@
+#ifndef WINDOWEVENTSOURCE_H
+#define WINDOWEVENTSOURCE_H
+
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include "windowrecognitionservice.h"
+
+// 窗口事件源：被跟随的窗口移动、显隐、最小化、销毁或前台切换时发出通知，
+// 跟随控制器据此刷新，目标不动时不再定时查询
+class WindowEventSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Event {
+        Moved,
+        Shown,
+        Hidden,
+        Minimized,
+        Restored,
+        Destroyed,
+        Foreground
+    };
+
+    // 脚本化事件源：不挂接系统，由调用方投递事件，用于基准与回归检查
+    class ScriptedSource;
+
+    explicit WindowEventSource(QObject *parent = nullptr);
+
+    // 当前平台的原生事件源，不支持时返回 nullptr，调用方退回定时轮询
+    static WindowEventSource *createNative(QObject *parent = nullptr);
+
+    // 移动与销毁事件只报告关注的窗口；anyWindow 时任意顶层窗口的显隐、最小化也会报告，
+    // 供批量跟随发现新窗口。前台切换总会报告。两者都为空时不挂接任何系统事件
+    void setWatchedWindows(const QSet<WindowHandle> &handles, bool anyWindow);
+    QSet<WindowHandle> watchedWindows() const;
+    bool watchesAnyWindow() const;
+    bool isWatching() const;
+    // 任一系统挂接失败后事件源不再报告事件，调用方应退回定时轮询
+    bool hasFailed() const;
+
+signals:
+    void windowChanged(WindowHandle handle, WindowEventSource::Event event);
+
+protected:
+    // 关注范围变化后由具体实现调整系统挂接
+    virtual void updateWatch() = 0;
+    // 按关注范围过滤后发出，返回是否发出
+    bool dispatch(WindowHandle handle, Event event);
+    void markFailed();
+
+private:
+    QSet<WindowHandle> m_watched;
+    bool m_anyWindow;
+    bool m_failed;
+};
+
+class WindowEventSource::ScriptedSource : public WindowEventSource
+{
+public:
+    explicit ScriptedSource(QObject *parent = nullptr);
+
+    // 与原生事件源同样按关注范围过滤，返回事件是否被发出
+    bool post(WindowHandle handle, Event event);
+    QList<QPair<WindowHandle, Event>> delivered() const;
+    int watchUpdates() const;
+    void reset();
+
+protected:
+    void updateWatch() override;
+
+private:
+    QList<QPair<WindowHandle, Event>> m_delivered;
+    int m_watchUpdates;
+};
+
+#endif // WINDOWEVENTSOURCE_H
@@ -2,12 +2,22 @@
 #include <QGuiApplication>
 #include <QScreen>
 #include <QCursor>
+#include <QHash>
+#include <QPair>
+#include <QRegion>
+#include <QSet>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
 namespace {
+WindowRecognitionService::MetadataStats &metadataStatsRef()
+{
+    static WindowRecognitionService::MetadataStats stats;
+    return stats;
+}
+
 #ifdef Q_OS_WIN
 QString windowClassName(HWND hwnd)
 {
@@ -28,10 +38,21 @@ QString windowTitle(HWND hwnd)
     return QString();
 }
 
-QString processName(HWND hwnd)
+typedef BOOL (WINAPI *QueryFullProcessImageNameWFunc)(HANDLE, DWORD, LPWSTR, PDWORD);
+
+QueryFullProcessImageNameWFunc queryFullProcessImageName()
+{
+    static QueryFullProcessImageNameWFunc func = []() -> QueryFullProcessImageNameWFunc {
+        HMODULE hKernel = GetModuleHandleW(L"kernel32.dll");
+        return hKernel ? reinterpret_cast<QueryFullProcessImageNameWFunc>(
+                             GetProcAddress(hKernel, "QueryFullProcessImageNameW"))
+                       : nullptr;
+    }();
+    return func;
+}
+
+QString processName(DWORD pid)
 {
-    DWORD pid = 0;
-    GetWindowThreadProcessId(hwnd, &pid);
     if (pid == 0) {
         return QString();
     }
@@ -45,17 +66,12 @@ QString processName(HWND hwnd)
     DWORD len = MAX_PATH;
     QString result;
 
-    typedef BOOL (WINAPI *QueryFullProcessImageNameWFunc)(HANDLE, DWORD, LPWSTR, PDWORD);
-    HMODULE hKernel = GetModuleHandleW(L"kernel32.dll");
-    if (hKernel) {
-        auto queryFunc = reinterpret_cast<QueryFullProcessImageNameWFunc>(
-            GetProcAddress(hKernel, "QueryFullProcessImageNameW"));
-        if (queryFunc && queryFunc(hProc, 0, path, &len)) {
-            result = QString::fromWCharArray(path);
-            int lastSlash = result.lastIndexOf('\\');
-            if (lastSlash >= 0) {
-                result = result.mid(lastSlash + 1);
-            }
+    QueryFullProcessImageNameWFunc queryFunc = queryFullProcessImageName();
+    if (queryFunc && queryFunc(hProc, 0, path, &len)) {
+        result = QString::fromWCharArray(path);
+        int lastSlash = result.lastIndexOf('\\');
+        if (lastSlash >= 0) {
+            result = result.mid(lastSlash + 1);
         }
     }
 
@@ -63,6 +79,127 @@ QString processName(HWND hwnd)
     return result;
 }
 
+// 进程创建时间（FILETIME 的 100ns 计数），与 PID 一起唯一标识进程；取不到时返回 0
+quint64 processCreationTime(DWORD pid)
+{
+    if (pid == 0) {
+        return 0;
+    }
+    HANDLE hProc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!hProc) {
+        return 0;
+    }
+    FILETIME created, exited, kernel, user;
+    quint64 result = 0;
+    if (GetProcessTimes(hProc, &created, &exited, &kernel, &user)) {
+        result = (quint64(created.dwHighDateTime) << 32) | created.dwLowDateTime;
+    }
+    CloseHandle(hProc);
+    return result;
+}
+
+// 句柄元数据缓存：类名在窗口生命周期内不变，进程名按 PID 加进程创建时间缓存，
+// PID 被新进程复用时不会取到旧进程的名字。
+// 句柄可能在窗口销毁后被复用，所属线程/进程变了就视为新窗口
+struct HandleMetadata {
+    DWORD pid = 0;
+    DWORD threadId = 0;
+    bool hasClassName = false;
+    QString className;
+    bool hasProcessCreated = false;
+    quint64 processCreated = 0;
+};
+
+using ProcessKey = QPair<DWORD, quint64>;
+
+struct MetadataCache {
+    QHash<WindowHandle, HandleMetadata> handles;
+    QHash<ProcessKey, QString> processNames;
+};
+
+MetadataCache &metadataCache()
+{
+    static MetadataCache cache;
+    return cache;
+}
+
+HandleMetadata &handleMetadata(HWND hwnd)
+{
+    DWORD pid = 0;
+    const DWORD threadId = GetWindowThreadProcessId(hwnd, &pid);
+    HandleMetadata &meta = metadataCache().handles[reinterpret_cast<WindowHandle>(hwnd)];
+    if (meta.pid != pid || meta.threadId != threadId) {
+        meta = HandleMetadata();
+        meta.pid = pid;
+        meta.threadId = threadId;
+    }
+    return meta;
+}
+
+QString cachedClassName(HWND hwnd)
+{
+    HandleMetadata &meta = handleMetadata(hwnd);
+    WindowRecognitionService::MetadataStats &stats = metadataStatsRef();
+    if (meta.hasClassName) {
+        ++stats.classHits;
+        return meta.className;
+    }
+    ++stats.classMisses;
+    meta.className = windowClassName(hwnd);
+    meta.hasClassName = true;
+    return meta.className;
+}
+
+// 取不到进程名（权限不足等）也记下，避免反复查询；创建时间每个窗口只取一次
+QString cachedProcessName(HWND hwnd)
+{
+    HandleMetadata &meta = handleMetadata(hwnd);
+    if (!meta.hasProcessCreated) {
+        meta.processCreated = processCreationTime(meta.pid);
+        meta.hasProcessCreated = true;
+    }
+    const ProcessKey key(meta.pid, meta.processCreated);
+    QHash<ProcessKey, QString> &names = metadataCache().processNames;
+    WindowRecognitionService::MetadataStats &stats = metadataStatsRef();
+    auto it = names.constFind(key);
+    if (it != names.constEnd()) {
+        ++stats.processHits;
+        return it.value();
+    }
+    ++stats.processMisses;
+    const QString name = processName(meta.pid);
+    names.insert(key, name);
+    return name;
+}
+
+// 完整枚举后丢掉已不存在的窗口及不再被引用的进程
+void pruneMetadata(const QList<HWND> &alive)
+{
+    MetadataCache &cache = metadataCache();
+    QSet<WindowHandle> aliveHandles;
+    for (HWND hwnd : alive) {
+        aliveHandles.insert(reinterpret_cast<WindowHandle>(hwnd));
+    }
+    QSet<ProcessKey> aliveProcesses;
+    for (auto it = cache.handles.begin(); it != cache.handles.end(); ) {
+        if (!aliveHandles.contains(it.key())) {
+            it = cache.handles.erase(it);
+            continue;
+        }
+        if (it.value().hasProcessCreated) {
+            aliveProcesses.insert(ProcessKey(it.value().pid, it.value().processCreated));
+        }
+        ++it;
+    }
+    for (auto it = cache.processNames.begin(); it != cache.processNames.end(); ) {
+        if (aliveProcesses.contains(it.key())) {
+            ++it;
+        } else {
+            it = cache.processNames.erase(it);
+        }
+    }
+}
+
 bool isTopMost(HWND hwnd)
 {
     LONG ex = GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
@@ -74,6 +211,62 @@ QRect rectFromWinRect(const RECT &r)
     return QRect(r.left, r.top, r.right - r.left, r.bottom - r.top);
 }
 
+typedef HRESULT (WINAPI *DwmGetWindowAttributeFunc)(HWND, DWORD, PVOID, DWORD);
+
+DwmGetWindowAttributeFunc dwmGetWindowAttribute()
+{
+    static DwmGetWindowAttributeFunc func = []() -> DwmGetWindowAttributeFunc {
+        HMODULE hDwm = LoadLibraryW(L"dwmapi.dll");
+        return hDwm ? reinterpret_cast<DwmGetWindowAttributeFunc>(GetProcAddress(hDwm, "DwmGetWindowAttribute"))
+                    : nullptr;
+    }();
+    return func;
+}
+
+// 被 DWM 隐藏（其他虚拟桌面、挂起的 UWP 等）的窗口虽然 IsWindowVisible，但并不显示
+bool isCloaked(HWND hwnd)
+{
+    const DWORD kDwmwaCloaked = 14;
+    DwmGetWindowAttributeFunc func = dwmGetWindowAttribute();
+    DWORD cloaked = 0;
+    return func && SUCCEEDED(func(hwnd, kDwmwaCloaked, &cloaked, sizeof(cloaked))) && cloaked != 0;
+}
+
+// 可见边框范围，不含 Win10 起的隐形缩放边框
+bool visibleFrameRect(HWND hwnd, RECT *rect)
+{
+    const DWORD kDwmwaExtendedFrameBounds = 9;
+    DwmGetWindowAttributeFunc func = dwmGetWindowAttribute();
+    if (func && SUCCEEDED(func(hwnd, kDwmwaExtendedFrameBounds, rect, sizeof(RECT)))) {
+        return true;
+    }
+    return GetWindowRect(hwnd, rect) != FALSE;
+}
+
+void fillWindowInfo(HWND hwnd, WindowInfo &info, WindowRecognitionService::WindowFields fields)
+{
+    if (fields & WindowRecognitionService::StateField) {
+        info.visible = IsWindowVisible(hwnd);
+        info.minimized = IsIconic(hwnd);
+        info.topMost = isTopMost(hwnd);
+    }
+    if (fields & WindowRecognitionService::TitleField) {
+        info.title = windowTitle(hwnd);
+    }
+    if (fields & WindowRecognitionService::ClassField) {
+        info.className = cachedClassName(hwnd);
+    }
+    if (fields & WindowRecognitionService::ProcessField) {
+        info.processName = cachedProcessName(hwnd);
+    }
+    if (fields & WindowRecognitionService::RectField) {
+        RECT rr;
+        if (GetWindowRect(hwnd, &rr)) {
+            info.rect = WindowRecognitionService::rectPhysicalToLogical(rectFromWinRect(rr), info.handle);
+        }
+    }
+}
+
 BOOL CALLBACK enumWindowsProc(HWND hwnd, LPARAM lParam)
 {
     auto *list = reinterpret_cast<QList<HWND>*>(lParam);
@@ -90,13 +283,14 @@ WindowRecognitionService::WindowRecognitionService(QObject *parent)
 {
 }
 
-QList<WindowInfo> WindowRecognitionService::listWindows(bool visibleOnly) const
+QList<WindowInfo> WindowRecognitionService::listWindows(bool visibleOnly, WindowFields fields) const
 {
     QList<WindowInfo> result;
 
 #ifdef Q_OS_WIN
     QList<HWND> handles;
     EnumWindows(enumWindowsProc, reinterpret_cast<LPARAM>(&handles));
+    pruneMetadata(handles);
 
     for (HWND hwnd : handles) {
         if (visibleOnly && !IsWindowVisible(hwnd)) {
@@ -104,27 +298,18 @@ QList<WindowInfo> WindowRecognitionService::listWindows(bool visibleOnly) const
         }
         WindowInfo info;
         info.handle = reinterpret_cast<WindowHandle>(hwnd);
-        info.visible = IsWindowVisible(hwnd);
-        info.minimized = IsIconic(hwnd);
-        info.topMost = isTopMost(hwnd);
-        info.title = windowTitle(hwnd);
-        info.className = windowClassName(hwnd);
-        info.processName = processName(hwnd);
-
-        RECT rr;
-        if (GetWindowRect(hwnd, &rr)) {
-            info.rect = rectPhysicalToLogical(rectFromWinRect(rr), info.handle);
-        }
+        fillWindowInfo(hwnd, info, fields);
         result.append(info);
     }
 #else
     Q_UNUSED(visibleOnly)
+    Q_UNUSED(fields)
 #endif
 
     return result;
 }
 
-WindowInfo WindowRecognitionService::queryWindow(WindowHandle handle) const
+WindowInfo WindowRecognitionService::queryWindow(WindowHandle handle, WindowFields fields) const
 {
     WindowInfo info;
     info.handle = handle;
@@ -132,19 +317,12 @@ WindowInfo WindowRecognitionService::queryWindow(WindowHandle handle) const
 #ifdef Q_OS_WIN
     HWND hwnd = reinterpret_cast<HWND>(handle);
     if (!IsWindow(hwnd)) {
+        metadataCache().handles.remove(handle);
         return info;
     }
-    info.visible = IsWindowVisible(hwnd);
-    info.minimized = IsIconic(hwnd);
-    info.topMost = isTopMost(hwnd);
-    info.title = windowTitle(hwnd);
-    info.className = windowClassName(hwnd);
-    info.processName = processName(hwnd);
-
-    RECT rr;
-    if (GetWindowRect(hwnd, &rr)) {
-        info.rect = rectPhysicalToLogical(rectFromWinRect(rr), handle);
-    }
+    fillWindowInfo(hwnd, info, fields);
+#else
+    Q_UNUSED(fields)
 #endif
 
     return info;
@@ -161,6 +339,65 @@ bool WindowRecognitionService::isWindowValid(WindowHandle handle) const
 #endif
 }
 
+WindowRecognitionService::MetadataStats WindowRecognitionService::metadataStats()
+{
+    return metadataStatsRef();
+}
+
+void WindowRecognitionService::resetMetadataStats()
+{
+    metadataStatsRef() = MetadataStats();
+}
+
+QSet<WindowHandle> WindowRecognitionService::occludedWindows(const QList<WindowHandle> &handles)
+{
+    QSet<WindowHandle> occluded;
+#ifdef Q_OS_WIN
+    QHash<HWND, QRect> pending;
+    QRegion targets;
+    for (WindowHandle handle : handles) {
+        HWND hwnd = reinterpret_cast<HWND>(handle);
+        RECT own;
+        if (!IsWindow(hwnd) || !IsWindowVisible(hwnd) || IsIconic(hwnd) || !GetWindowRect(hwnd, &own)) {
+            continue;
+        }
+        const QRect rect = rectFromWinRect(own);
+        pending.insert(hwnd, rect);
+        targets += rect;
+    }
+
+    // 自顶向下遍历，到达待判定窗口时其上方的不透明窗口都已并入 covered；
+    // 只有与待判定窗口相交的窗口才继续查询 DWM
+    QRegion covered;
+    for (HWND hwnd = GetTopWindow(nullptr); hwnd && !pending.isEmpty(); hwnd = GetWindow(hwnd, GW_HWNDNEXT)) {
+        auto it = pending.find(hwnd);
+        if (it != pending.end()) {
+            if ((QRegion(it.value()) - covered).isEmpty()) {
+                occluded.insert(WindowHandle(hwnd));
+            }
+            pending.erase(it);
+        }
+        if (!IsWindowVisible(hwnd) || IsIconic(hwnd)) {
+            continue;
+        }
+        const LONG_PTR ex = GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
+        if (ex & (WS_EX_LAYERED | WS_EX_TRANSPARENT)) {
+            continue;
+        }
+        RECT rr;
+        if (!GetWindowRect(hwnd, &rr) || !targets.intersects(rectFromWinRect(rr)) || isCloaked(hwnd)) {
+            continue;
+        }
+        if (visibleFrameRect(hwnd, &rr)) {
+            covered += QRegion(rectFromWinRect(rr)) & targets;
+        }
+    }
+#else
+    Q_UNUSED(handles)
+#endif
+    return occluded;
+}
+
 qreal WindowRecognitionService::dpiScaleForWindow(WindowHandle handle)
 {
 #ifdef Q_OS_WIN
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QList>
 #include <QRectF>
+#include <QSet>
 #include <QString>
 #include <QtGlobal>
 
@@ -25,14 +26,42 @@ class WindowRecognitionService : public QObject
     Q_OBJECT
 
 public:
+    // 按需读取的字段：标题每次现读；类名与进程名在句柄生命周期内不变，走元数据缓存
+    enum WindowField {
+        TitleField = 0x01,
+        ClassField = 0x02,
+        ProcessField = 0x04,
+        RectField = 0x08,
+        StateField = 0x10,     // visible / minimized / topMost
+        AllFields = 0x1f
+    };
+    Q_DECLARE_FLAGS(WindowFields, WindowField)
+
+    struct MetadataStats {
+        quint64 classHits = 0;
+        quint64 classMisses = 0;
+        quint64 processHits = 0;
+        quint64 processMisses = 0;
+    };
+
     explicit WindowRecognitionService(QObject *parent = nullptr);
 
-    QList<WindowInfo> listWindows(bool visibleOnly = true) const;
-    WindowInfo queryWindow(WindowHandle handle) const;
+    QList<WindowInfo> listWindows(bool visibleOnly = true, WindowFields fields = AllFields) const;
+    WindowInfo queryWindow(WindowHandle handle, WindowFields fields = AllFields) const;
     bool isWindowValid(WindowHandle handle) const;
 
+    // 缓存由所有实例共享
+    static MetadataStats metadataStats();
+    static void resetMetadataStats();
+
+    // 给定窗口中被其上方的不透明窗口完全遮住的那些（分层/穿透窗口不计入）；
+    // 自顶向下只走一遍 Z 序，所有贴纸共用一次遍历
+    static QSet<WindowHandle> occludedWindows(const QList<WindowHandle> &handles);
+
     static qreal dpiScaleForWindow(WindowHandle handle);
     static QRectF rectPhysicalToLogical(const QRect &rect, WindowHandle handle);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(WindowRecognitionService::WindowFields)
+
 #endif // WINDOWRECOGNITIONSERVICE_H